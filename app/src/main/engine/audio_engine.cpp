@@ -14,202 +14,838 @@
  * limitations under the License.
  */
 
+#define LOG_TAG "EuphoriaeAudio"
+
 #include "audio_engine.h"
-#include <android/log.h>
+#include "dsp_kernels.h"
+#include "engine_log.h"
+#include "simd.h"
 #include <algorithm>
 #include <chrono>
-
-#define LOG_TAG "EuphoriaeAudio"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#include <climits>
+#include <cmath>
 
 namespace euphoriae {
 
+namespace {
+
+// NaN from the caller is ignored (std::clamp would pass it through to the DSP state)
+void storeClamped(std::atomic<float>& target, float value, float lo, float hi) {
+    if (!std::isnan(value)) target.store(std::clamp(value, lo, hi));
+}
+
+// Channel count inside a kernel instantiated for kChannels (0 = any, known only at runtime)
+template <int kChannels>
+inline int32_t fixedChannels(int32_t channelCount) {
+    return kChannels > 0 ? kChannels : channelCount;
+}
+
+// Sum of squares over a block; NaN and infinity propagate
+float blockEnergy(const float* buffer, int32_t numSamples) {
+    simd::float4 acc = simd::set1(0.0f);
+    int32_t i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        simd::float4 x = simd::load(buffer + i);
+        acc = simd::mulAdd(acc, x, x);
+    }
+    float energy = simd::sum(acc);
+    for (; i < numSamples; i++) {
+        energy += buffer[i] * buffer[i];
+    }
+    return energy;
+}
+
+// Ramp time of every gain setting, short enough to feel immediate on a slider
+constexpr float kGainSmoothingSeconds = 0.02f;
+
+// Fade-in after a reset, long enough to hide the discontinuity at a seek
+constexpr float kFadeInSeconds = 0.005f;
+
+// Reverb block length; no preset delay is shorter (the smallest is 113 frames)
+constexpr int32_t kReverbBlockFrames = 64;
+
+// Comb: sum += delayed, feedback = input + decay * delayed
+void combBlock(const float* input, const float* delayed, float decay, float* sum, float* feedback,
+               int32_t count) {
+    const simd::float4 decay4 = simd::set1(decay);
+    int32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        simd::float4 d = simd::load(delayed + i);
+        simd::store(sum + i, simd::add(simd::load(sum + i), d));
+        simd::store(feedback + i, simd::mulAdd(simd::load(input + i), decay4, d));
+    }
+    for (; i < count; i++) {
+        sum[i] += delayed[i];
+        feedback[i] = input[i] + decay * delayed[i];
+    }
+}
+
+// Allpass: output = delayed - gain * input, feedback = input + gain * output
+void allpassBlock(const float* input, const float* delayed, float gain, float* output, float* feedback,
+                  int32_t count) {
+    const simd::float4 gain4 = simd::set1(gain);
+    int32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        simd::float4 x = simd::load(input + i);
+        simd::float4 y = simd::mulSub(simd::load(delayed + i), gain4, x);
+        simd::store(output + i, y);
+        simd::store(feedback + i, simd::mulAdd(x, gain4, y));
+    }
+    for (; i < count; i++) {
+        output[i] = delayed[i] - gain * input[i];
+        feedback[i] = input[i] + gain * output[i];
+    }
+}
+
+} // namespace
+
 AudioEngine::AudioEngine() {
+    dspKernels();  // Probes the CPU here, never on the audio thread
+    for (int32_t i = 0; i < kNumChainStages; i++) mStageOrder[i] = i;
+    rebuildChain();
     LOGI("AudioEngine created with full DSP pipeline");
-    // Initialize delay buffers
-    std::fill(std::begin(mDelayBufferL), std::end(mDelayBufferL), 0.0f);
-    std::fill(std::begin(mDelayBufferR), std::end(mDelayBufferR), 0.0f);
-    
-    // Initialize reverb comb and allpass buffers (CRITICAL to prevent crackling)
-    std::fill(std::begin(mCombBuffer1), std::end(mCombBuffer1), 0.0f);
-    std::fill(std::begin(mCombBuffer2), std::end(mCombBuffer2), 0.0f);
-    std::fill(std::begin(mCombBuffer3), std::end(mCombBuffer3), 0.0f);
-    std::fill(std::begin(mCombBuffer4), std::end(mCombBuffer4), 0.0f);
-    std::fill(std::begin(mAllpassBuffer1), std::end(mAllpassBuffer1), 0.0f);
-    std::fill(std::begin(mAllpassBuffer2), std::end(mAllpassBuffer2), 0.0f);
+}
+
+AudioEngine::~AudioEngine() = default;
+
+const char* AudioEngine::simdVariant() {
+    return dspKernels().name;
+}
+
+void AudioEngine::configure(int32_t sampleRate, int32_t channelCount) {
+    if (sampleRate <= 0) return;
+    if (sampleRate != mSampleRate.load()) {
+        mSampleRate.store(sampleRate);
+        mLoudnessMeter.setSampleRate(sampleRate);
+        mSpectrumAnalyzer.setSampleRate(sampleRate);
+        mToneStack.setSampleRate(sampleRate);
+        mChannelMixer.setSampleRate(sampleRate);
+        
+        // The renderer holds HRIRs resampled to the old rate. Mapping, resampling
+        // and transforming a set is no work for the stream's thread, so the worker
+        // builds the new one; binaural rendering pauses until it is picked up.
+        mWorker.submit([this] { rebuildBinauralRenderer(); });
+    } else {
+        mLoudnessMeter.reset();
+    }
+    mLevelerGain = 1.0f;
+    mChannelMixer.reset();
+    mSnapGains = true;
+    if (channelCount >= 1 && channelCount <= kMaxChannels) {
+        mLayout = ChannelLayout::forChannelCount(channelCount);
+    }
+    LOGI("Configured: %d Hz, %d channels", sampleRate, channelCount);
 }
 
 void AudioEngine::processAudio(float* buffer, int32_t numFrames, int32_t channelCount) {
     if (buffer == nullptr || numFrames <= 0) return;
+    if (channelCount < 1 || channelCount > kMaxChannels) return;
+    if (static_cast<int64_t>(numFrames) * channelCount > INT32_MAX) return;
     
     auto startTime = std::chrono::high_resolution_clock::now();
     
-    // ================== DSP Processing Chain ==================
+    drainAutomation();
+    const int64_t position = mFramePosition.load(std::memory_order_relaxed);
     
-    // 1. Input gain / Volume Leveler
-    float volumeLeveler = mVolumeLeveler.load();
-    if (volumeLeveler > 0.01f) {
-        applyVolumeLeveler(buffer, numFrames, channelCount);
+    // Run the whole chain over short blocks so the samples stay in L1 between
+    // stages, and every setting is picked up at the same granularity
+    const int32_t blockFrames = mBlockFrames > 0 ? mBlockFrames : numFrames;
+    for (int32_t frame = 0; frame < numFrames; frame += blockFrames) {
+        int32_t count = std::min(blockFrames, numFrames - frame);
+        mBlockPosition = position + frame;
+        processBlock(buffer + static_cast<int64_t>(frame) * channelCount, count, channelCount);
     }
     
-    // 2. Bass Boost
-    float bassBoost = mBassBoost.load();
-    if (bassBoost > 0.01f) {
-        applyBassBoost(buffer, numFrames, channelCount);
+    // Analyzer tap (a single copy into the analyzer ring)
+    mSpectrumAnalyzer.push(buffer, numFrames, channelCount);
+    mFramePosition.store(position + numFrames, std::memory_order_release);
+    
+    // Performance logging
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+    
+    if (++mBufferCount % 500 == 0) {
+        float latencyMs = duration.count() / 1000.0f;
+        LOGI("DSP latency: %.3f ms | Frames: %d", latencyMs, numFrames);
+    }
+}
+
+int32_t AudioEngine::outputChannelCount(int32_t inputChannels) const {
+    if (inputChannels < 1 || inputChannels > kMaxChannels) return inputChannels;
+    switch (mSurroundMode.load()) {
+        case 0:
+            return inputChannels;
+        case 2:
+            // Movie: fill the speakers, or fold them down again for headphones
+            if (mHeadphoneSurround.load()) return inputChannels > 2 ? 2 : inputChannels;
+            return inputChannels == 2 ? ChannelMixer::kUpmixChannels : inputChannels;
+        default:
+            // The stereo surround effects then see the whole mix, not only the front pair
+            return inputChannels > 2 ? 2 : inputChannels;
     }
+}
+
+void AudioEngine::processAudio(const float* input, int32_t inputChannels, float* output,
+                               int32_t outputChannels, int32_t numFrames) {
+    if (input == nullptr || output == nullptr || numFrames <= 0) return;
+    if (outputChannels < 1 || outputChannels > kMaxChannels) return;
+    if (static_cast<int64_t>(numFrames) * std::max(inputChannels, outputChannels) > INT32_MAX) return;
     
-    // 3. Treble Boost
-    float trebleBoost = mTrebleBoost.load();
-    if (trebleBoost > 0.01f) {
-        applyTrebleBoost(buffer, numFrames, channelCount);
+    // Stage 0: channel conversion
+    if (inputChannels == outputChannels) {
+        if (input != output) std::copy(input, input + numFrames * inputChannels, output);
+    } else if (inputChannels == 2 && outputChannels == ChannelMixer::kUpmixChannels) {
+        mChannelMixer.upmix(input, numFrames, output);
+    } else if (inputChannels >= 1 && inputChannels <= kMaxChannels && outputChannels == 2) {
+        ChannelMixer::downmix(input, numFrames, inputChannels, output);
+    } else {
+        std::fill(output, output + numFrames * outputChannels, 0.0f);
+        return;
     }
     
-    // 4. Equalizer
-    applyEqualizer(buffer, numFrames, channelCount);
+    processAudio(output, numFrames, outputChannels);
+}
+
+void AudioEngine::processBlock(float* buffer, int32_t numFrames, int32_t channelCount) {
+    // Streams whose count changed without a configure call still get their layout
+    if (channelCount != mLayout.channels) {
+        mLayout = ChannelLayout::forChannelCount(channelCount);
+    }
     
-    // 5. Clarity
-    float clarity = mClarity.load();
-    if (clarity > 0.01f) {
-        applyClarity(buffer, numFrames, channelCount);
+    // Mono and stereo get kernels with the channel count fixed at compile time
+    switch (channelCount) {
+        case 1: processChain<1>(buffer, numFrames, channelCount); break;
+        case 2: processChain<2>(buffer, numFrames, channelCount); break;
+        default: processChain<0>(buffer, numFrames, channelCount); break;
     }
+}
+
+template <int kChannels>
+void AudioEngine::processChain(float* buffer, int32_t numFrames, int32_t channelCount) {
+    channelCount = fixedChannels<kChannels>(channelCount);
+    const int32_t numSamples = numFrames * channelCount;
+    const float sampleRate = static_cast<float>(mSampleRate.load());
+    mSmoothingFrames = mSnapGains ? 0 : static_cast<int32_t>(kGainSmoothingSeconds * sampleRate);
+    mSnapGains = false;
+    
+    // ================== DSP Processing Chain ==================
     
-    // 6. Tube Amp Warmth
-    float tubeWarmth = mTubeWarmth.load();
-    if (tubeWarmth > 0.01f) {
-        applyTubeWarmth(buffer, numFrames * channelCount);
+    // Fade-in after a seek
+    if (mFadeInRemaining > 0) {
+        applyFadeIn<kChannels>(buffer, numFrames, channelCount);
     }
     
-    // 7. Spectrum Extension
-    float spectrumExt = mSpectrumExtension.load();
-    if (spectrumExt > 0.01f) {
-        applySpectrumExtension(buffer, numFrames, channelCount);
+    // Silent input (paused rendering, gaps) skips the gain and shaping stages;
+    // stages with memory run until their tail has rung out
+    Block block{buffer, numFrames, channelCount, numSamples, sampleRate,
+                TailTracker::isSilent(blockEnergy(buffer, numSamples))};
+    
+    // The compiled chain (picking up a rebuilt one first): only enabled stages,
+    // in the user's order, ending with the output stage
+    const ChainPlan* plan = mChain.acquire();
+    constexpr int kVariant = kChannels == 1 ? 0 : (kChannels == 2 ? 1 : 2);
+    for (int32_t i = 0; i < plan->numStages; i++) {
+        const StageFn stage = plan->stages[kVariant][i];
+        (this->*stage)(block);
+    }
+}
+
+// ================== Chain Stages ==================
+
+// Track gain (precomputed loudness normalization); the ramp jumps to its
+// target over silence
+template <int kChannels>
+void AudioEngine::stageTrackGain(Block& block) {
+    if (block.silent) {
+        mTrackGainRamp.set(mTrackGain.load());
+    } else {
+        applyTrackGain<kChannels>(block.buffer, block.numFrames, block.channelCount);
+    }
+}
+
+// Input loudness, for the leveler and the app's meters
+template <int kChannels>
+void AudioEngine::stageLoudnessMeter(Block& block) {
+    const int64_t meterTail = static_cast<int64_t>(0.1f * block.sampleRate);  // K-weighting filters
+    mMeterTail.setTail(meterTail, meterTail);
+    if (mMeterTail.shouldProcess(block.silent, block.numFrames)) {
+        mLoudnessMeter.process(block.buffer, block.numFrames, block.channelCount);
+    } else {
+        mLoudnessMeter.processSilence(block.numFrames);
+    }
+}
+
+// Volume leveler, which holds its gain over silence
+template <int kChannels>
+void AudioEngine::stageVolumeLeveler(Block& block) {
+    if (!block.silent) {
+        applyVolumeLeveler<kChannels>(block.buffer, block.numFrames, block.channelCount);
+    }
+}
+
+// In place of the leveler while it is off, so it starts over from unity
+template <int kChannels>
+void AudioEngine::stageLevelerOff(Block&) {
+    mLevelerGain = 1.0f;
+}
+
+// Bass, treble, clarity and spectrum extension in one pass (coefficients are
+// only recompiled when a setting changed)
+template <int kChannels>
+void AudioEngine::stageToneStack(Block& block) {
+    ToneStack::Settings tone;
+    tone.bass = mBassBoost.load();
+    tone.bassFrequency = mBassFrequency.load();
+    tone.virtualBass = mBassMode.load() == 1;
+    tone.treble = mTrebleBoost.load();
+    tone.clarity = mClarity.load();
+    tone.spectrumExtension = mSpectrumExtension.load();
+    mToneStack.setSettings(tone);
+    mToneTail.setTail(static_cast<int64_t>(0.1f * block.sampleRate), 64);
+    if (mToneStack.isActive() && mToneTail.shouldProcess(block.silent, block.numFrames)) {
+        mToneStack.process(block.buffer, block.numFrames, block.channelCount);
+        if (block.silent) {
+            block.silent = mToneTail.reportTail(blockEnergy(block.buffer, block.numSamples), block.numFrames);
+        }
+    }
+}
+
+template <int kChannels>
+void AudioEngine::stageEqualizer(Block& block) {
+    if (!block.silent) {
+        applyEqualizer<kChannels>(block.buffer, block.numFrames, block.channelCount);
+    }
+}
+
+template <int kChannels>
+void AudioEngine::stageTubeWarmth(Block& block) {
+    if (!block.silent) {
+        applyTubeWarmth(block.buffer, block.numSamples);
+    }
+}
+
+// Over silence the envelope only releases
+template <int kChannels>
+void AudioEngine::stageCompressor(Block& block) {
+    if (block.silent) {
+        mCompressorEnvelope *= std::exp(-block.numFrames / (mCompressorRelease.load() * block.sampleRate));
+    } else {
+        applyCompressor<kChannels>(block.buffer, block.numFrames, block.channelCount);
+    }
+}
+
+template <int kChannels>
+void AudioEngine::stageLoudnessGain(Block& block) {
+    const float gainFactor = loudnessGainFactor();
+    if (block.silent) {
+        mLoudnessGainRamp.set(gainFactor);
+    } else {
+        mLoudnessGainRamp.follow(gainFactor, mSmoothingFrames);
+        mLoudnessGainRamp.apply<kChannels>(block.buffer, block.numFrames, block.channelCount);
+    }
+}
+
+// The slowest comb (Large Hall) takes ~7.6 s to fall by 120 dB; the longest
+// comb plus both allpasses can delay an echo by 5120 frames
+template <int kChannels>
+void AudioEngine::stageReverb(Block& block) {
+    mReverbTail.setTail(static_cast<int64_t>(8.0f * block.sampleRate), 5120);
+    if (mReverbTail.shouldProcess(block.silent, block.numFrames)) {
+        applyReverb<kChannels>(block.buffer, block.numFrames, block.channelCount);
+        if (block.silent) {
+            block.silent = mReverbTail.reportTail(blockEnergy(block.buffer, block.numSamples), block.numFrames);
+        }
+    }
+}
+
+// Picks up a newly loaded impulse response first; an IR may contain gaps, so
+// its tail always runs to the end. Only the front pair is convolved.
+template <int kChannels>
+void AudioEngine::stageConvolution(Block& block) {
+    Convolver* convolver = mConvolver.acquire();
+    if (convolver == nullptr || convolver->isEmpty()) return;
+    const int64_t tail = convolver->irFrames() + 2 * Convolver::kMaxPartitionSize;
+    mConvolverTail.setTail(tail, tail);
+    if (mConvolverTail.shouldProcess(block.silent, block.numFrames)) {
+        convolver->process(block.buffer, block.numFrames, block.channelCount, mConvolutionMix.load());
+        if (block.silent) {
+            block.silent = mConvolverTail.reportTail(blockEnergy(block.buffer, block.numSamples), block.numFrames);
+        }
+    }
+}
+
+// 3D Surround on the front pair: the Haas delays, or the binaural renderer's
+// filters (well under 100 ms)
+template <int kChannels>
+void AudioEngine::stageSurround3D(Block& block) {
+    if (kChannels == 1) return;
+    const int64_t surroundTail = decltype(mSurroundDelayL)::kMaxDelay + static_cast<int64_t>(0.1f * block.sampleRate);
+    mSurroundTail.setTail(surroundTail, surroundTail);
+    if (mSurroundTail.shouldProcess(block.silent, block.numFrames)) {
+        applySurround3D<kChannels>(block.buffer, block.numFrames, block.channelCount);
+        if (block.silent) {
+            block.silent = mSurroundTail.reportTail(blockEnergy(block.buffer, block.numSamples), block.numFrames);
+        }
+    }
+}
+
+// Virtualizer, channel separation and balance as one 2x2 matrix, on every
+// left/right pair (centre and LFE are left alone)
+template <int kChannels>
+void AudioEngine::stageStereoMatrix(Block& block) {
+    if (kChannels == 1) return;
+    mStereoMatrix.setParameters(mVirtualizer.load(), mChannelSeparation.load(), mStereoBalance.load(),
+                                mSmoothingFrames);
+    if (block.silent) return;
+    if (kChannels == 2) {
+        mStereoMatrix.process(block.buffer, block.numFrames);
+    } else {
+        mStereoMatrix.processPairs(block.buffer, block.numFrames, block.channelCount, mLayout.pairs,
+                                   mLayout.numPairs);
+    }
+}
+
+// Limiter, volume and the final clip. Silence stays below the limiter, and
+// needs no volume or clip (ramps still move on with the stream).
+template <int kChannels>
+void AudioEngine::stageOutput(Block& block) {
+    if (block.silent) {
+        applyVolume<kChannels>(nullptr, block.numFrames, block.channelCount);
+        return;
     }
     
-    // 8. Compressor
-    float compressor = mCompressorStrength.load();
-    if (compressor > 0.01f) {
-        applyCompressor(buffer, numFrames, channelCount);
+    applyLimiter(block.buffer, block.numSamples);
+    applyVolume<kChannels>(block.buffer, block.numFrames, block.channelCount);
+    
+    // Final hard clip - prevent any remaining samples > 1.0
+    // NaN fails both comparisons and becomes 0; any non-finite sample flags the block
+    bool nonFinite = false;
+    for (int32_t i = 0; i < block.numSamples; i++) {
+        float sample = block.buffer[i];
+        nonFinite |= !std::isfinite(sample);
+        block.buffer[i] = sample > 1.0f ? 1.0f : (sample < -1.0f ? -1.0f : (sample == sample ? sample : 0.0f));
+    }
+    if (nonFinite) dropBlock(block);
+}
+
+// A NaN or infinity has already reached the recursive filters and would stick
+// there: drop the block and start the effect state over
+void AudioEngine::dropBlock(Block& block) {
+    std::fill(block.buffer, block.buffer + block.numSamples, 0.0f);
+    resetState();
+    if (!mNonFiniteLogged) {
+        LOGE("Non-finite samples in DSP chain, effect state reset");
+        mNonFiniteLogged = true;
+    }
+}
+
+// ================== Fused Stages ==================
+// The common configurations as single loops, each replacing a run of generic
+// stages. They fall back to those stages for a block whose gains are still
+// ramping (or that is silent), so the output only differs by rounding.
+
+// EQ + bass boost + limiter: tone stack (optional), then EQ gain, limiter,
+// volume and clip in one pass. Compiled when nothing else is switched on and
+// loudness gain and the stereo matrix are neutral.
+template <int kChannels, bool kTone>
+void AudioEngine::stageToneEqualizerOutput(Block& block) {
+    // What the generic stages would pick up this block; any ramp, a neutral gain
+    // switched on, or a queued ramp starting takes those stages
+    mEqGainRamp.follow(equalizerGain(), mSmoothingFrames, RampCurve::kExponential);
+    mLoudnessGainRamp.follow(loudnessGainFactor(), mSmoothingFrames);
+    mStereoMatrix.setParameters(mVirtualizer.load(), mChannelSeparation.load(), mStereoBalance.load(),
+                                mSmoothingFrames);
+    if (!mVolumeAutomated) mVolumeRamp.follow(mVolume.load(), mSmoothingFrames);
+    const bool rampStarts = mNumPendingRamps > 0 && mPendingRamps[0].startFrame < mBlockPosition + block.numFrames;
+    const bool settled = mEqGainRamp.isSettled() && mLoudnessGainRamp.isSettled() &&
+                         mLoudnessGainRamp.value() == 1.0f && (kChannels == 1 || mStereoMatrix.isIdentity()) &&
+                         mVolumeRamp.isSettled() && mFadeRamp.isSettled() && !rampStarts;
+    if (block.silent || !settled) {
+        if (kTone) stageToneStack<kChannels>(block);
+        stageEqualizer<kChannels>(block);
+        stageLoudnessGain<kChannels>(block);
+        stageStereoMatrix<kChannels>(block);
+        stageOutput<kChannels>(block);
+        return;
     }
     
-    // 8.25 Loudness Gain (makeup gain after compression)
-    float loudnessGain = mLoudnessGain.load();
-    if (loudnessGain > 0.01f) {
-        float gainFactor = 1.0f + (loudnessGain * 1.5f);  // Up to +6dB gain
-        int numSamples = numFrames * channelCount;
-        for (int32_t i = 0; i < numSamples; i++) {
-            buffer[i] *= gainFactor;
+    if (kTone) stageToneStack<kChannels>(block);
+    float* buffer = block.buffer;
+    const int32_t numSamples = block.numSamples;
+    const float eqGain = mEqGainRamp.value();
+    const float ceiling = mLimiterCeiling.load();
+    const float volume = mVolumeRamp.value();
+    const float fade = mFadeRamp.value();
+    
+    // Peak after the EQ gain; a non-finite sample turns 'poison' into NaN
+    const simd::float4 eq4 = simd::set1(eqGain);
+    const simd::float4 zero = simd::set1(0.0f);
+    simd::float4 peak4 = zero;
+    simd::float4 poison = zero;
+    int32_t i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        const simd::float4 x = simd::mul(simd::load(buffer + i), eq4);
+        peak4 = simd::max(peak4, simd::abs(x));
+        poison = simd::mulAdd(poison, x, zero);
+    }
+    alignas(16) float lanes[4];
+    simd::store(lanes, peak4);
+    float peak = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+    bool finite = simd::sum(poison) == 0.0f;
+    for (; i < numSamples; i++) {
+        const float x = buffer[i] * eqGain;
+        peak = std::max(peak, std::abs(x));
+        finite &= std::isfinite(x);
+    }
+    
+    // Under the ceiling the limiter does nothing: gains and clip as vectors, in
+    // the generic stages' order so the rounding matches
+    if (finite && peak <= ceiling) {
+        const simd::float4 volume4 = simd::set1(volume);
+        const simd::float4 fade4 = simd::set1(fade);
+        const simd::float4 one = simd::set1(1.0f);
+        const simd::float4 minusOne = simd::set1(-1.0f);
+        for (i = 0; i + 4 <= numSamples; i += 4) {
+            simd::float4 x = simd::mul(simd::mul(simd::mul(simd::load(buffer + i), eq4), volume4), fade4);
+            simd::store(buffer + i, simd::min(simd::max(x, minusOne), one));
+        }
+        for (; i < numSamples; i++) {
+            buffer[i] = std::clamp(buffer[i] * eqGain * volume * fade, -1.0f, 1.0f);
         }
+        return;
     }
     
-    // 8.5 Reverb
-    int reverbPreset = mReverbPreset.load();
-    if (reverbPreset > 0) {
-        applyReverb(buffer, numFrames, channelCount);
+    bool nonFinite = false;
+    for (i = 0; i < numSamples; i++) {
+        float sample = buffer[i] * eqGain;
+        if (std::abs(sample) > ceiling) sample = ceiling * std::tanh(sample / ceiling);
+        sample = sample * volume * fade;
+        nonFinite |= !std::isfinite(sample);
+        buffer[i] = sample > 1.0f ? 1.0f : (sample < -1.0f ? -1.0f : (sample == sample ? sample : 0.0f));
     }
+    if (nonFinite) dropBlock(block);
+}
+
+void AudioEngine::rebuildChain() {
+    // Each stage's instantiations, by processChain variant
+    struct Stage {
+        StageFn fn[3];
+    };
+#define EUPHORIAE_STAGE(name) Stage{{&AudioEngine::name<1>, &AudioEngine::name<2>, &AudioEngine::name<0>}}
+    static const Stage kTrackGain = EUPHORIAE_STAGE(stageTrackGain);
+    static const Stage kLoudnessMeter = EUPHORIAE_STAGE(stageLoudnessMeter);
+    static const Stage kVolumeLeveler = EUPHORIAE_STAGE(stageVolumeLeveler);
+    static const Stage kLevelerOff = EUPHORIAE_STAGE(stageLevelerOff);
+    static const Stage kOrdered[kNumChainStages] = {
+        EUPHORIAE_STAGE(stageToneStack),    EUPHORIAE_STAGE(stageEqualizer),
+        EUPHORIAE_STAGE(stageTubeWarmth),   EUPHORIAE_STAGE(stageCompressor),
+        EUPHORIAE_STAGE(stageLoudnessGain), EUPHORIAE_STAGE(stageReverb),
+        EUPHORIAE_STAGE(stageConvolution),  EUPHORIAE_STAGE(stageSurround3D),
+        EUPHORIAE_STAGE(stageStereoMatrix),
+    };
+    static const Stage kOutput = EUPHORIAE_STAGE(stageOutput);
+#undef EUPHORIAE_STAGE
+    static const Stage kEqualizerOutput = Stage{{&AudioEngine::stageToneEqualizerOutput<1, false>,
+                                                 &AudioEngine::stageToneEqualizerOutput<2, false>,
+                                                 &AudioEngine::stageToneEqualizerOutput<0, false>}};
+    static const Stage kToneEqualizerOutput = Stage{{&AudioEngine::stageToneEqualizerOutput<1, true>,
+                                                     &AudioEngine::stageToneEqualizerOutput<2, true>,
+                                                     &AudioEngine::stageToneEqualizerOutput<0, true>}};
     
-    // 9. Stereo processing
-    if (channelCount == 2) {
-        // Virtualizer
-        float virtualizer = mVirtualizer.load();
-        if (virtualizer > 0.01f) {
-            applyVirtualizer(buffer, numFrames, channelCount);
-        }
-        
-        // 3D Surround
-        float surround3D = mSurround3D.load();
-        if (surround3D > 0.01f) {
-            applySurround3D(buffer, numFrames);
+    std::lock_guard<std::mutex> lock(mChainMutex);
+    
+    // Whether each orderable stage does anything at the current settings. Gain
+    // stages always run: they ramp back to unity when switched off, and cost
+    // nothing once there.
+    bool hasImpulseResponse;
+    {
+        std::lock_guard<std::mutex> sourceLock(mSourceMutex);
+        hasImpulseResponse = mImpulseChannels > 0;
+    }
+    bool enabled[kNumChainStages];
+    enabled[kStageToneStack] = mBassBoost.load() > 0.0f || mBassMode.load() == 1 || mTrebleBoost.load() > 0.0f ||
+                               mClarity.load() > 0.0f || mSpectrumExtension.load() > 0.0f;
+    enabled[kStageEqualizer] = true;
+    enabled[kStageTubeWarmth] = mTubeWarmth.load() > 0.01f;
+    enabled[kStageCompressor] = mCompressorStrength.load() > 0.01f;
+    enabled[kStageLoudnessGain] = true;
+    enabled[kStageReverb] = mReverbPreset.load() > 0;
+    enabled[kStageConvolution] = hasImpulseResponse;
+    enabled[kStageSurround3D] = mSurround3D.load() > 0.01f;
+    enabled[kStageStereoMatrix] = true;
+    
+    // Fused stages, for the configurations most people listen with. Loudness
+    // gain and the stereo matrix count as off: the fused stage checks that
+    // they are neutral every block.
+    const Stage* fusedTail = nullptr;
+    bool fused[kNumChainStages] = {};
+    if (mFastPaths) {
+        // Tone stack (ahead of the EQ), EQ and the output stage
+        bool onlyTone = true;
+        bool toneFirst = true;
+        bool seenEqualizer = false;
+        for (int32_t stage : mStageOrder) {
+            seenEqualizer |= stage == kStageEqualizer;
+            if (stage == kStageToneStack) toneFirst = !seenEqualizer;
+            onlyTone &= !enabled[stage] || stage == kStageToneStack || stage == kStageEqualizer ||
+                        stage == kStageLoudnessGain || stage == kStageStereoMatrix;
         }
-        
-        // Channel Separation
-        float separation = mChannelSeparation.load();
-        if (std::abs(separation - 0.5f) > 0.01f) {
-            applyChannelSeparation(buffer, numFrames);
+        if (onlyTone && (!enabled[kStageToneStack] || toneFirst)) {
+            fusedTail = enabled[kStageToneStack] ? &kToneEqualizerOutput : &kEqualizerOutput;
+            std::fill(std::begin(fused), std::end(fused), true);
         }
-        
-        // Stereo Balance
-        float balance = mStereoBalance.load();
-        if (std::abs(balance) > 0.01f) {
-            applyStereoBalance(buffer, numFrames);
+    }
+    
+    std::array<const Stage*, ChainPlan::kMaxStages> stages{};
+    int32_t numStages = 0;
+    stages[numStages++] = &kTrackGain;
+    stages[numStages++] = &kLoudnessMeter;
+    stages[numStages++] = mVolumeLeveler.load() > 0.01f ? &kVolumeLeveler : &kLevelerOff;
+    for (int32_t stage : mStageOrder) {
+        if (enabled[stage] && !fused[stage]) stages[numStages++] = &kOrdered[stage];
+    }
+    stages[numStages++] = fusedTail != nullptr ? fusedTail : &kOutput;
+    
+    // Slider moves rarely switch a stage: nothing to publish then
+    bool unchanged = numStages == mNumPublishedStages;
+    for (int32_t i = 0; unchanged && i < numStages; i++) {
+        unchanged = stages[i]->fn[0] == mPublishedStages[i];
+    }
+    if (unchanged) return;
+    
+    auto* plan = new ChainPlan();
+    for (int32_t i = 0; i < numStages; i++) {
+        for (int32_t variant = 0; variant < 3; variant++) {
+            plan->stages[variant][i] = stages[i]->fn[variant];
         }
+        mPublishedStages[i] = stages[i]->fn[0];
+    }
+    plan->numStages = numStages;
+    mNumPublishedStages = numStages;
+    mChain.publish(plan);
+}
+
+bool AudioEngine::setStageOrder(const int32_t* order, int32_t count) {
+    if (order == nullptr || count != kNumChainStages) return false;
+    bool seen[kNumChainStages] = {};
+    for (int32_t i = 0; i < count; i++) {
+        if (order[i] < 0 || order[i] >= kNumChainStages || seen[order[i]]) return false;
+        seen[order[i]] = true;
     }
+    {
+        std::lock_guard<std::mutex> lock(mChainMutex);
+        std::copy(order, order + count, mStageOrder.begin());
+    }
+    rebuildChain();
+    return true;
+}
+
+void AudioEngine::setFastPathsEnabled(bool enabled) {
+    {
+        std::lock_guard<std::mutex> lock(mChainMutex);
+        mFastPaths = enabled;
+    }
+    rebuildChain();
+}
+
+void AudioEngine::resetState() {
+    mToneStack.reset();
+    mChannelMixer.reset();
+    mMeterTail.reset();
+    mToneTail.reset();
+    mReverbTail.reset();
+    mConvolverTail.reset();
+    mSurroundTail.reset();
+    mCompressorEnvelope = 0.0f;
+    mLevelerGain = 1.0f;
+    mTrackGainRamp.set(mTrackGain.load());
+    mLoudnessMeter.reset();
     
-    // 10. Limiter
-    applyLimiter(buffer, numFrames * channelCount);
+    mSurroundDelayL.clear();
+    mSurroundDelayR.clear();
+    for (auto& comb : mReverbCombs) comb.clear();
+    for (auto& allpass : mReverbAllpasses) allpass.clear();
     
-    // 11. Master Volume
-    float volume = mVolume.load();
-    if (std::abs(volume - 1.0f) > 0.001f) {
-        applyVolume(buffer, numFrames * channelCount);
+    // Convolver and renderer histories
+    Convolver* convolver = mConvolver.acquire();
+    if (convolver != nullptr) convolver->reset();
+    mBinauralActive = false;
+}
+
+void AudioEngine::reset() {
+    const float levelerGain = mLevelerGain;
+    resetState();
+    mLevelerGain = levelerGain;
+    mFadeInFrames = std::max(1, static_cast<int32_t>(kFadeInSeconds * mSampleRate.load()));
+    mFadeInRemaining = mFadeInFrames;
+    mSnapGains = true;
+}
+
+template <int kChannels>
+void AudioEngine::applyFadeIn(float* buffer, int32_t numFrames, int32_t channelCount) {
+    channelCount = fixedChannels<kChannels>(channelCount);
+    const float step = 1.0f / mFadeInFrames;
+    float gain = static_cast<float>(mFadeInFrames - mFadeInRemaining) * step;
+    const int32_t count = std::min(numFrames, mFadeInRemaining);
+    for (int32_t i = 0; i < count; i++) {
+        for (int32_t ch = 0; ch < channelCount; ch++) {
+            buffer[i * channelCount + ch] *= gain;
+        }
+        gain += step;
+    }
+    mFadeInRemaining -= count;
+}
+
+// ================== Offline Rendering ==================
+
+void AudioEngine::copySettingsFrom(const AudioEngine& other) {
+    // Raw values: the setters derive some parameters from others (surround modes, dynamic range)
+    mVolume.store(other.mVolume.load());
+    mBassBoost.store(other.mBassBoost.load());
+    mBassFrequency.store(other.mBassFrequency.load());
+    mBassMode.store(other.mBassMode.load());
+    mVirtualizer.store(other.mVirtualizer.load());
+    mCompressorStrength.store(other.mCompressorStrength.load());
+    mCompressorThreshold.store(other.mCompressorThreshold.load());
+    mCompressorRatio.store(other.mCompressorRatio.load());
+    mCompressorAttack.store(other.mCompressorAttack.load());
+    mCompressorRelease.store(other.mCompressorRelease.load());
+    mLimiterCeiling.store(other.mLimiterCeiling.load());
+    mSurround3D.store(other.mSurround3D.load());
+    mRoomSize.store(other.mRoomSize.load());
+    mSurroundLevel.store(other.mSurroundLevel.load());
+    mSurroundMode.store(other.mSurroundMode.load());
+    mHeadphoneSurround.store(other.mHeadphoneSurround.load());
+    mHeadphoneType.store(other.mHeadphoneType.load());
+    mClarity.store(other.mClarity.load());
+    mTubeWarmth.store(other.mTubeWarmth.load());
+    mSpectrumExtension.store(other.mSpectrumExtension.load());
+    mTrebleBoost.store(other.mTrebleBoost.load());
+    mVolumeLeveler.store(other.mVolumeLeveler.load());
+    mVolumeLevelerTarget.store(other.mVolumeLevelerTarget.load());
+    mStereoBalance.store(other.mStereoBalance.load());
+    mChannelSeparation.store(other.mChannelSeparation.load());
+    mDynamicRange.store(other.mDynamicRange.load());
+    mLoudnessGain.store(other.mLoudnessGain.load());
+    mReverbPreset.store(other.mReverbPreset.load());
+    mReverbWet.store(other.mReverbWet.load());
+    mConvolutionMix.store(other.mConvolutionMix.load());
+    mTempo.store(other.mTempo.load());
+    mPitchSemitones.store(other.mPitchSemitones.load());
+    for (int i = 0; i < kNumEqualizerBands; i++) {
+        mEqualizerBands[i].store(other.mEqualizerBands[i].load());
     }
+    mSnapGains = true;
     
-    // 12. Final Hard Clip - prevent any remaining samples > 1.0
-    int numSamples = numFrames * channelCount;
-    for (int32_t i = 0; i < numSamples; i++) {
-        buffer[i] = std::clamp(buffer[i], -1.0f, 1.0f);
+    std::array<int32_t, kNumChainStages> order;
+    {
+        std::lock_guard<std::mutex> lock(other.mChainMutex);
+        order = other.mStageOrder;
     }
+    setStageOrder(order.data(), kNumChainStages);
     
-    // Performance logging
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+    std::vector<float> ir;
+    int32_t irChannels;
+    std::string hrirPath;
+    {
+        std::lock_guard<std::mutex> lock(other.mSourceMutex);
+        ir = other.mImpulseResponse;
+        irChannels = other.mImpulseChannels;
+        hrirPath = other.mHrirPath;
+    }
+    if (irChannels > 0) {
+        loadImpulseResponse(ir.data(), static_cast<int32_t>(ir.size()) / irChannels, irChannels);
+    } else {
+        clearImpulseResponse();
+    }
+    if (!hrirPath.empty()) loadHrirSet(hrirPath.c_str());
+}
+
+int64_t AudioEngine::settleFrames() const {
+    // Shelves, EQ, surround delays, the binaural renderer and the track gain
+    // ramp forget within a few tens of milliseconds
+    double seconds = 0.1;
+    if (mCompressorStrength.load() > 0.01f) {
+        // Envelope within 1e-5 of where a continuous run would be
+        seconds = std::max(seconds, 12.0 * std::max(mCompressorAttack.load(), mCompressorRelease.load()));
+    }
+    if (mReverbPreset.load() > 0) {
+        seconds += 8.0;  // Slowest comb (Large Hall) takes ~7.6 s to decay by 120 dB
+    }
+    if (mVolumeLeveler.load() > 0.01f) {
+        seconds += 3.0 + 10.0;  // Short-term window, then five rise time constants
+    }
     
-    static int bufferCount = 0;
-    bufferCount++;
-    if (bufferCount % 500 == 0) {
-        float latencyMs = duration.count() / 1000.0f;
-        LOGI("DSP latency: %.3f ms | Frames: %d", latencyMs, numFrames);
+    int64_t frames = static_cast<int64_t>(seconds * mSampleRate.load());
+    std::lock_guard<std::mutex> lock(mSourceMutex);
+    if (mImpulseChannels > 0) {
+        frames += static_cast<int64_t>(mImpulseResponse.size()) / mImpulseChannels;
     }
+    return frames;
 }
 
 // ================== Setter Implementations ==================
 
 void AudioEngine::setVolume(float volume) {
-    mVolume.store(std::clamp(volume, 0.0f, 2.0f));
+    storeClamped(mVolume, volume, 0.0f, 2.0f);
 }
 
 void AudioEngine::setBassBoost(float strength) {
-    mBassBoost.store(std::clamp(strength, 0.0f, 1.0f));
+    storeClamped(mBassBoost, strength, 0.0f, 1.0f);
+    rebuildChain();
+}
+
+void AudioEngine::setBassFrequency(float hz) {
+    storeClamped(mBassFrequency, hz, ToneStack::kMinBassFrequency, ToneStack::kMaxBassFrequency);
+}
+
+void AudioEngine::setBassMode(int mode) {
+    mBassMode.store(std::clamp(mode, 0, 1));
+    rebuildChain();
 }
 
 void AudioEngine::setVirtualizer(float strength) {
-    mVirtualizer.store(std::clamp(strength, 0.0f, 1.0f));
+    storeClamped(mVirtualizer, strength, 0.0f, 1.0f);
 }
 
 void AudioEngine::setEqualizerBand(int band, float gainDb) {
     if (band >= 0 && band < kNumEqualizerBands) {
-        mEqualizerBands[band].store(std::clamp(gainDb, -12.0f, 12.0f));
+        storeClamped(mEqualizerBands[band], gainDb, -12.0f, 12.0f);
     }
 }
 
 void AudioEngine::setCompressor(float threshold, float ratio, float attack, float release) {
-    mCompressorThreshold.store(threshold);
-    mCompressorRatio.store(ratio);
-    mCompressorAttack.store(attack);
-    mCompressorRelease.store(release);
+    storeClamped(mCompressorThreshold, threshold, -60.0f, 0.0f);
+    storeClamped(mCompressorRatio, ratio, 1.0f, 20.0f);
+    storeClamped(mCompressorAttack, attack, 0.0001f, 1.0f);
+    storeClamped(mCompressorRelease, release, 0.001f, 5.0f);
 }
 
 void AudioEngine::setCompressorStrength(float strength) {
-    mCompressorStrength.store(std::clamp(strength, 0.0f, 1.0f));
+    if (std::isnan(strength)) return;
+    strength = std::clamp(strength, 0.0f, 1.0f);
+    mCompressorStrength.store(strength);
     // Auto-configure compressor based on strength
     mCompressorThreshold.store(-20.0f + (strength * 10.0f));  // -20 to -10 dB
     mCompressorRatio.store(1.0f + (strength * 7.0f));  // 1:1 to 8:1
+    rebuildChain();
 }
 
 void AudioEngine::setLimiter(float ceiling) {
-    mLimiterCeiling.store(std::clamp(ceiling, 0.5f, 1.0f));
+    storeClamped(mLimiterCeiling, ceiling, 0.5f, 1.0f);
 }
 
 void AudioEngine::setSurround3D(float depth) {
-    mSurround3D.store(std::clamp(depth, 0.0f, 1.0f));
+    storeClamped(mSurround3D, depth, 0.0f, 1.0f);
+    rebuildChain();
 }
 
 void AudioEngine::setRoomSize(float size) {
-    mRoomSize.store(std::clamp(size, 0.0f, 1.0f));
+    storeClamped(mRoomSize, size, 0.0f, 1.0f);
 }
 
 void AudioEngine::setSurroundLevel(float level) {
-    mSurroundLevel.store(std::clamp(level, 0.0f, 1.0f));
+    storeClamped(mSurroundLevel, level, 0.0f, 1.0f);
 }
 
 void AudioEngine::setSurroundMode(int mode) {
@@ -246,6 +882,7 @@ void AudioEngine::setSurroundMode(int mode) {
             mSurroundLevel.store(0.3f);
             break;
     }
+    rebuildChain();
 }
 
 void AudioEngine::setHeadphoneSurround(bool enabled) {
@@ -257,45 +894,63 @@ void AudioEngine::setHeadphoneType(int type) {
 }
 
 void AudioEngine::setClarity(float level) {
-    mClarity.store(std::clamp(level, 0.0f, 1.0f));
+    storeClamped(mClarity, level, 0.0f, 1.0f);
+    rebuildChain();
 }
 
 void AudioEngine::setTubeWarmth(float warmth) {
-    mTubeWarmth.store(std::clamp(warmth, 0.0f, 1.0f));
+    storeClamped(mTubeWarmth, warmth, 0.0f, 1.0f);
+    rebuildChain();
 }
 
 void AudioEngine::setSpectrumExtension(float level) {
-    mSpectrumExtension.store(std::clamp(level, 0.0f, 1.0f));
+    storeClamped(mSpectrumExtension, level, 0.0f, 1.0f);
+    rebuildChain();
 }
 
 void AudioEngine::setStereoBalance(float balance) {
-    mStereoBalance.store(std::clamp(balance, -1.0f, 1.0f));
+    storeClamped(mStereoBalance, balance, -1.0f, 1.0f);
 }
 
 void AudioEngine::setChannelSeparation(float separation) {
-    mChannelSeparation.store(std::clamp(separation, 0.0f, 1.0f));
+    storeClamped(mChannelSeparation, separation, 0.0f, 1.0f);
 }
 
 void AudioEngine::setTrebleBoost(float level) {
-    mTrebleBoost.store(std::clamp(level, 0.0f, 1.0f));
+    storeClamped(mTrebleBoost, level, 0.0f, 1.0f);
+    rebuildChain();
 }
 
 void AudioEngine::setVolumeLeveler(float level) {
-    mVolumeLeveler.store(std::clamp(level, 0.0f, 1.0f));
+    storeClamped(mVolumeLeveler, level, 0.0f, 1.0f);
+    rebuildChain();
+}
+
+void AudioEngine::setVolumeLevelerTarget(float lufs) {
+    storeClamped(mVolumeLevelerTarget, lufs, -30.0f, -8.0f);
+}
+
+void AudioEngine::setTrackGain(float gainDb) {
+    if (std::isnan(gainDb)) return;
+    mTrackGain.store(std::pow(10.0f, std::clamp(gainDb, -24.0f, 24.0f) / 20.0f));
 }
 
 void AudioEngine::setTempo(float tempo) {
-    mTempo.store(std::clamp(tempo, 0.5f, 2.0f));
+    storeClamped(mTempo, tempo, 0.5f, 2.0f);
 }
 
 void AudioEngine::setPitch(float semitones) {
-    mPitchSemitones.store(std::clamp(semitones, -12.0f, 12.0f));
+    if (std::isnan(semitones)) return;
+    semitones = std::clamp(semitones, -12.0f, 12.0f);
+    mPitchSemitones.store(semitones);
     // Convert semitones to pitch ratio: 2^(semitones/12)
     mPitchRatio = std::pow(2.0f, semitones / 12.0f);
 }
 
 void AudioEngine::setDynamicRange(float range) {
-    mDynamicRange.store(std::clamp(range, 0.0f, 1.0f));
+    if (std::isnan(range)) return;
+    range = std::clamp(range, 0.0f, 1.0f);
+    mDynamicRange.store(range);
     // Lower dynamic range = more compression
     // Adjust compressor settings based on dynamic range
     float compressionAmount = 1.0f - range;
@@ -304,81 +959,17 @@ void AudioEngine::setDynamicRange(float range) {
         mCompressorThreshold.store(-20.0f + (range * 10.0f));  // -20 to -10 dB
         mCompressorRatio.store(1.0f + ((1.0f - range) * 7.0f));  // 1:1 to 8:1
     }
+    rebuildChain();
 }
 
 void AudioEngine::setLoudnessGain(float gain) {
-    mLoudnessGain.store(std::clamp(gain, 0.0f, 1.0f));
+    storeClamped(mLoudnessGain, gain, 0.0f, 1.0f);
 }
 
 // ================== DSP Algorithm Implementations ==================
 
-void AudioEngine::applyBassBoost(float* buffer, int32_t numFrames, int32_t channelCount) {
-    float strength = mBassBoost.load();
-    
-    // Low-pass filter for bass extraction
-    const float alpha = 0.15f + (strength * 0.15f);
-    const float boost = 1.0f + (strength * 2.0f);
-    
-    for (int32_t i = 0; i < numFrames; i++) {
-        for (int32_t ch = 0; ch < std::min(channelCount, 2); ch++) {
-            int idx = i * channelCount + ch;
-            float sample = buffer[idx];
-            
-            // Low-pass to extract bass
-            mBassState[ch] = mBassState[ch] + alpha * (sample - mBassState[ch]);
-            
-            // Add boosted bass
-            buffer[idx] = sample + (mBassState[ch] * (boost - 1.0f));
-        }
-    }
-}
-
-void AudioEngine::applyTrebleBoost(float* buffer, int32_t numFrames, int32_t channelCount) {
-    float strength = mTrebleBoost.load();
-    
-    // High-pass filter for treble extraction
-    const float alpha = 0.9f - (strength * 0.2f);
-    const float boost = strength * 1.5f;
-    
-    for (int32_t i = 0; i < numFrames; i++) {
-        for (int32_t ch = 0; ch < std::min(channelCount, 2); ch++) {
-            int idx = i * channelCount + ch;
-            float sample = buffer[idx];
-            
-            float prevState = mTrebleState[ch];
-            mTrebleState[ch] = sample;
-            
-            // High-pass to extract treble
-            float treble = sample - alpha * prevState - (1.0f - alpha) * mTrebleState[ch];
-            
-            // Add boosted treble
-            buffer[idx] = sample + (treble * boost);
-        }
-    }
-}
-
-void AudioEngine::applyVirtualizer(float* buffer, int32_t numFrames, int32_t channelCount) {
-    if (channelCount != 2) return;
-    
-    float strength = mVirtualizer.load();
-    
-    // Cross-channel mixing for stereo widening
-    const float crossMix = strength * 0.5f;
-    const float directGain = 1.0f + (strength * 0.2f);
-    
-    for (int32_t i = 0; i < numFrames; i++) {
-        int idx = i * 2;
-        float left = buffer[idx];
-        float right = buffer[idx + 1];
-        
-        // Stereo widening
-        buffer[idx] = (left * directGain) - (right * crossMix);
-        buffer[idx + 1] = (right * directGain) - (left * crossMix);
-    }
-}
-
-void AudioEngine::applyEqualizer(float* buffer, int32_t numFrames, int32_t channelCount) {
-    // Check if any band has gain
+// Average gain across the bands that have any, linear
+float AudioEngine::equalizerGain() const {
     bool hasGain = false;
     float totalGain = 0.0f;
     
@@ -389,18 +980,27 @@ void AudioEngine::applyEqualizer(float* buffer, int32_t numFrames, int32_t chann
             totalGain += bandGain;
         }
     }
-    if (!hasGain) return;
-    
-    // Average gain across bands
+    if (!hasGain) return 1.0f;
     totalGain = totalGain / kNumEqualizerBands;
-    float linearGain = std::pow(10.0f, totalGain / 20.0f);
-    
-    for (int32_t i = 0; i < numFrames * channelCount; i++) {
-        buffer[i] *= linearGain;
-    }
+    return std::pow(10.0f, totalGain / 20.0f);
+}
+
+// Makeup gain after compression, up to +8 dB
+float AudioEngine::loudnessGainFactor() const {
+    float loudnessGain = mLoudnessGain.load();
+    return loudnessGain > 0.01f ? 1.0f + (loudnessGain * 1.5f) : 1.0f;
 }
 
+// Ramped to when the gain changes (unity costs nothing)
+template <int kChannels>
+void AudioEngine::applyEqualizer(float* buffer, int32_t numFrames, int32_t channelCount) {
+    mEqGainRamp.follow(equalizerGain(), mSmoothingFrames, RampCurve::kExponential);
+    mEqGainRamp.apply<kChannels>(buffer, numFrames, channelCount);
+}
+
+template <int kChannels>
 void AudioEngine::applyCompressor(float* buffer, int32_t numFrames, int32_t channelCount) {
+    channelCount = fixedChannels<kChannels>(channelCount);
     float threshold = mCompressorThreshold.load();
     float ratio = mCompressorRatio.load();
     float attack = mCompressorAttack.load();
@@ -410,8 +1010,9 @@ void AudioEngine::applyCompressor(float* buffer, int32_t numFrames, int32_t chan
     float thresholdLin = std::pow(10.0f, threshold / 20.0f);
     
     // Attack/release coefficients
-    float attackCoef = std::exp(-1.0f / (attack * 48000.0f));
-    float releaseCoef = std::exp(-1.0f / (release * 48000.0f));
+    float sampleRate = static_cast<float>(mSampleRate.load());
+    float attackCoef = std::exp(-1.0f / (attack * sampleRate));
+    float releaseCoef = std::exp(-1.0f / (release * sampleRate));
     
     for (int32_t i = 0; i < numFrames; i++) {
         // Compute input level
@@ -454,7 +1055,9 @@ void AudioEngine::applyLimiter(float* buffer, int32_t numSamples) {
     }
 }
 
-void AudioEngine::applySurround3D(float* buffer, int32_t numFrames) {
+template <int kChannels>
+void AudioEngine::applySurround3D(float* buffer, int32_t numFrames, int32_t channelCount) {
+    channelCount = fixedChannels<kChannels>(channelCount);
     float depth = mSurround3D.load();
     float roomSize = mRoomSize.load();
     float surroundLevel = mSurroundLevel.load();
@@ -464,13 +1067,32 @@ void AudioEngine::applySurround3D(float* buffer, int32_t numFrames) {
     // Combined effect strength from depth and surround level
     float effectStrength = depth * (0.5f + surroundLevel * 0.5f);
     
+    // Binaural rendering when an HRIR set is loaded; the layout follows the headphone type
+    BinauralRenderer* renderer = mBinauralRenderer.acquire();
+    if (headphoneSurround && renderer != nullptr && renderer->sampleRate() == mSampleRate.load()) {
+        if (!mBinauralActive) {
+            renderer->reset();
+            mBinauralActive = true;
+        }
+        if (kChannels == 2) {
+            renderer->process(buffer, numFrames, headphoneType, effectStrength);
+        } else {
+            applyBinauralDownmix(*renderer, buffer, numFrames, channelCount, headphoneType, effectStrength);
+        }
+        return;
+    }
+    mBinauralActive = false;
+    
     // Headphone-specific adjustments
     float crossfeedAmount = 0.3f;  // Base crossfeed
     float delayMultiplier = 1.0f;
     float bassEnhance = 0.0f;
     float highFreqBoost = 0.0f;
+    float itdAmount = 0.0f;
     
     if (headphoneSurround) {
+        itdAmount = 0.15f;
+        
         // Adjust based on headphone type
         switch (headphoneType) {
             case 0:  // Generic
@@ -499,87 +1121,62 @@ void AudioEngine::applySurround3D(float* buffer, int32_t numFrames) {
         }
     }
     
-    // Delay time based on room size (0.5ms to 30ms), adjusted by headphone type
-    int delayFrames = static_cast<int>((0.5f + roomSize * 29.5f) * 48.0f * delayMultiplier);
-    delayFrames = std::min(delayFrames, kMaxDelayFrames - 1);
+    // Delay time based on room size (0.5ms to 30ms), adjusted by headphone type;
+    // fractional so the room size slider moves smoothly
+    constexpr float kMaxDelay = static_cast<float>(decltype(mSurroundDelayL)::kMaxDelay - 1);
+    float framesPerMs = mSampleRate.load() / 1000.0f;
+    float delayFrames = (0.5f + roomSize * 29.5f) * framesPerMs * delayMultiplier;
+    delayFrames = std::clamp(delayFrames, 1.0f, kMaxDelay);
     
     // Secondary delay for HRTF-like effect (interaural time difference)
     int itdDelay = static_cast<int>(15.0f * delayMultiplier);  // ~0.3ms ITD simulation
-    itdDelay = std::min(itdDelay, kMaxDelayFrames - 1);
+    
+    // Per-block gains; the headphone terms are zero when headphone surround is off
+    const float crossGain = effectStrength * crossfeedAmount;
+    const float itdGain = effectStrength * itdAmount;
+    const float bassGain = 0.5f * bassEnhance * effectStrength;
+    const float diffGain = highFreqBoost * effectStrength;
     
     for (int32_t i = 0; i < numFrames; i++) {
-        int idx = i * 2;
+        int idx = i * channelCount;
         float left = buffer[idx];
         float right = buffer[idx + 1];
         
         // Get delayed samples for room simulation
-        int readPos = (mDelayWritePos - delayFrames + kMaxDelayFrames) % kMaxDelayFrames;
-        float delayedL = mDelayBufferL[readPos];
-        float delayedR = mDelayBufferR[readPos];
+        float delayedL = mSurroundDelayL.readFractional(delayFrames);
+        float delayedR = mSurroundDelayR.readFractional(delayFrames);
         
         // Get ITD delayed samples for spatial cue
-        int itdReadPos = (mDelayWritePos - itdDelay + kMaxDelayFrames) % kMaxDelayFrames;
-        float itdDelayedL = mDelayBufferL[itdReadPos];
-        float itdDelayedR = mDelayBufferR[itdReadPos];
+        float itdDelayedL = mSurroundDelayL.read(itdDelay);
+        float itdDelayedR = mSurroundDelayR.read(itdDelay);
         
         // Write to delay buffer
-        mDelayBufferL[mDelayWritePos] = left;
-        mDelayBufferR[mDelayWritePos] = right;
-        mDelayWritePos = (mDelayWritePos + 1) % kMaxDelayFrames;
-        
-        // Cross-mix with delayed signal for 3D effect
-        float crossGain = effectStrength * crossfeedAmount;
-        
-        // Apply surround processing
-        float newLeft = left + delayedR * crossGain;
-        float newRight = right + delayedL * crossGain;
-        
-        // Add ITD crossfeed for more natural spatialization (if headphone surround enabled)
-        if (headphoneSurround) {
-            float itdGain = effectStrength * 0.15f;
-            newLeft += itdDelayedR * itdGain;
-            newRight += itdDelayedL * itdGain;
-            
-            // Apply headphone-specific enhancements
-            if (bassEnhance > 0.0f) {
-                // Simple bass emphasis for in-ear headphones
-                float mid = (left + right) * 0.5f;
-                float bass = mid * bassEnhance * effectStrength;
-                newLeft += bass;
-                newRight += bass;
-            }
-            
-            if (highFreqBoost > 0.0f) {
-                // Simple high frequency emphasis
-                float diff = (left - right) * highFreqBoost * effectStrength;
-                newLeft += diff;
-                newRight -= diff;
-            }
-        }
+        mSurroundDelayL.write(left);
+        mSurroundDelayR.write(right);
         
-        buffer[idx] = newLeft;
-        buffer[idx + 1] = newRight;
+        // Cross-mix with delayed signal for 3D effect, plus ITD crossfeed
+        // and the headphone-specific bass (mid) and high-frequency (side) emphasis
+        float bass = (left + right) * bassGain;
+        float diff = (left - right) * diffGain;
+        buffer[idx] = left + delayedR * crossGain + itdDelayedR * itdGain + bass + diff;
+        buffer[idx + 1] = right + delayedL * crossGain + itdDelayedL * itdGain + bass - diff;
     }
 }
 
-void AudioEngine::applyClarity(float* buffer, int32_t numFrames, int32_t channelCount) {
-    float level = mClarity.load();
-    
-    // High-shelf boost around 3-8kHz
-    const float alpha = 0.85f;
-    const float boost = level * 2.0f;
-    
-    for (int32_t i = 0; i < numFrames; i++) {
-        for (int32_t ch = 0; ch < std::min(channelCount, 2); ch++) {
-            int idx = i * channelCount + ch;
-            float sample = buffer[idx];
-            
-            // High-pass to extract high frequencies
-            float highFreq = sample - mClarityState[ch] * alpha;
-            mClarityState[ch] = sample;
-            
-            // Add presence
-            buffer[idx] = sample + (highFreq * boost);
+void AudioEngine::applyBinauralDownmix(BinauralRenderer& renderer, float* buffer, int32_t numFrames,
+                                       int32_t channelCount, int32_t layout, float mix) {
+    for (int32_t frame = 0; frame < numFrames; frame += kBlockFrames) {
+        const int32_t count = std::min(numFrames - frame, kBlockFrames);
+        float* block = buffer + frame * channelCount;
+        ChannelMixer::downmix(block, count, channelCount, mDownmix);
+        renderer.process(mDownmix, count, layout, mix);
+        
+        // Headphones play the front pair; anything left elsewhere would be folded
+        // in again, unrendered, by the system downmix
+        std::fill(block, block + count * channelCount, 0.0f);
+        for (int32_t i = 0; i < count; i++) {
+            block[i * channelCount] = mDownmix[i * 2];
+            block[i * channelCount + 1] = mDownmix[i * 2 + 1];
         }
     }
 }
@@ -607,110 +1204,133 @@ void AudioEngine::applyTubeWarmth(float* buffer, int32_t numSamples) {
     }
 }
 
-void AudioEngine::applySpectrumExtension(float* buffer, int32_t numFrames, int32_t channelCount) {
-    float level = mSpectrumExtension.load();
+template <int kChannels>
+void AudioEngine::applyVolumeLeveler(float* buffer, int32_t numFrames, int32_t channelCount) {
+    channelCount = fixedChannels<kChannels>(channelCount);
+    float strength = mVolumeLeveler.load();
+    float target = mVolumeLevelerTarget.load();
+    float loudness = mLoudnessMeter.shortTerm();
     
-    // Generate harmonics to extend high frequencies
-    for (int32_t i = 0; i < numFrames; i++) {
-        for (int32_t ch = 0; ch < std::min(channelCount, 2); ch++) {
-            int idx = i * channelCount + ch;
-            float sample = buffer[idx];
-            
-            // Full-wave rectification generates harmonics
-            float harmonic = std::abs(sample) - 0.5f;
-            harmonic = std::max(0.0f, harmonic) * 2.0f;
-            
-            // High-pass the harmonics
-            float filteredHarmonic = harmonic - mHarmonicState[ch] * 0.95f;
-            mHarmonicState[ch] = harmonic;
-            
-            // Mix in
-            buffer[idx] = sample + filteredHarmonic * level * 0.3f;
-        }
+    // Below the absolute gate (silence, fade-outs) hold the gain instead of boosting noise
+    float targetGain = mLevelerGain;
+    if (loudness > LoudnessMeter::kAbsoluteGate) {
+        float gainDb = std::clamp(target - loudness, -12.0f, 12.0f) * strength;
+        targetGain = std::pow(10.0f, gainDb / 20.0f);
     }
-}
-
-void AudioEngine::applyStereoBalance(float* buffer, int32_t numFrames) {
-    float balance = mStereoBalance.load();
-    
-    // Equal-power panning
-    float leftGain = std::cos(balance * 0.5f * 3.14159f);
-    float rightGain = std::sin((balance + 1.0f) * 0.25f * 3.14159f);
     
-    if (balance < 0) {
-        rightGain = 1.0f + balance;  // Reduce right
-        leftGain = 1.0f;
-    } else {
-        leftGain = 1.0f - balance;  // Reduce left
-        rightGain = 1.0f;
-    }
+    // Per-sample one-pole toward the target: 300 ms when turning down, 2 s when turning up
+    float sampleRate = static_cast<float>(mSampleRate.load());
+    float coef = (targetGain < mLevelerGain) ? 1.0f - std::exp(-1.0f / (0.3f * sampleRate))
+                                             : 1.0f - std::exp(-1.0f / (2.0f * sampleRate));
     
+    float gain = mLevelerGain;
     for (int32_t i = 0; i < numFrames; i++) {
-        buffer[i * 2] *= leftGain;
-        buffer[i * 2 + 1] *= rightGain;
+        gain += (targetGain - gain) * coef;
+        for (int32_t ch = 0; ch < channelCount; ch++) {
+            buffer[i * channelCount + ch] *= gain;
+        }
     }
+    mLevelerGain = gain;
 }
 
-void AudioEngine::applyChannelSeparation(float* buffer, int32_t numFrames) {
-    float separation = mChannelSeparation.load();
+template <int kChannels>
+void AudioEngine::applyTrackGain(float* buffer, int32_t numFrames, int32_t channelCount) {
+    channelCount = fixedChannels<kChannels>(channelCount);
     
-    // 0 = mono, 0.5 = normal, 1 = extra wide
-    float crossMix = (1.0f - separation) * 0.5f;  // More mix = less separation
-    float directGain = 0.5f + separation * 0.5f;
-    
-    for (int32_t i = 0; i < numFrames; i++) {
-        int idx = i * 2;
-        float left = buffer[idx];
-        float right = buffer[idx + 1];
-        
-        buffer[idx] = left * directGain + right * crossMix;
-        buffer[idx + 1] = right * directGain + left * crossMix;
-    }
+    // Constant dB per frame over ~10 ms, so a new track's gain never clicks
+    mTrackGainRamp.follow(mTrackGain.load(), mSmoothingFrames / 2, RampCurve::kExponential);
+    mTrackGainRamp.apply<kChannels>(buffer, numFrames, channelCount);
 }
 
-void AudioEngine::applyVolumeLeveler(float* buffer, int32_t numFrames, int32_t channelCount) {
-    float strength = mVolumeLeveler.load();
+template <int kChannels>
+void AudioEngine::applyVolume(float* buffer, int32_t numFrames, int32_t channelCount) {
+    channelCount = fixedChannels<kChannels>(channelCount);
     
-    // Calculate RMS of this buffer
-    float sumSquares = 0.0f;
-    int numSamples = numFrames * channelCount;
-    
-    for (int32_t i = 0; i < numSamples; i++) {
-        sumSquares += buffer[i] * buffer[i];
+    // Outside a scheduled ramp the volume follows setVolume, smoothed
+    if (!mVolumeAutomated) {
+        mVolumeRamp.follow(mVolume.load(), mSmoothingFrames);
     }
     
-    float rms = std::sqrt(sumSquares / numSamples);
-    
-    // Smooth RMS tracking
-    mRmsLevel = mRmsLevel * 0.99f + rms * 0.01f;
-    
-    // Calculate gain to reach target RMS
-    if (mRmsLevel > 0.001f) {
-        float targetGain = mTargetRms / mRmsLevel;
-        targetGain = std::clamp(targetGain, 0.1f, 4.0f);  // Limit gain range
-        
-        // Blend based on strength
-        float gain = 1.0f + (targetGain - 1.0f) * strength;
+    // Split the block at every ramp start inside it
+    int32_t frame = 0;
+    while (frame < numFrames) {
+        int32_t count = numFrames - frame;
+        if (mNumPendingRamps > 0) {
+            const AutomationEvent& event = mPendingRamps[0];
+            const int64_t offset = event.startFrame - (mBlockPosition + frame);
+            if (offset <= 0) {
+                GainRamp& ramp = event.parameter == kAutomateVolume ? mVolumeRamp : mFadeRamp;
+                ramp.start(event.target, event.durationFrames, event.curve);
+                if (&ramp == &mVolumeRamp) {
+                    mVolumeAutomated = !ramp.isSettled();
+                    if (!mVolumeAutomated) mVolume.store(ramp.value());  // A jump
+                }
+                std::copy(mPendingRamps.begin() + 1, mPendingRamps.begin() + mNumPendingRamps, mPendingRamps.begin());
+                mNumPendingRamps--;
+                continue;
+            }
+            count = static_cast<int32_t>(std::min<int64_t>(count, offset));
+        }
         
-        for (int32_t i = 0; i < numSamples; i++) {
-            buffer[i] *= gain;
+        bool volumeEnded;
+        if (buffer != nullptr) {
+            float* span = buffer + static_cast<int64_t>(frame) * channelCount;
+            volumeEnded = mVolumeRamp.apply<kChannels>(span, count, channelCount);
+            mFadeRamp.apply<kChannels>(span, count, channelCount);
+        } else {
+            volumeEnded = mVolumeRamp.advance(count);
+            mFadeRamp.advance(count);
+        }
+        if (volumeEnded && mVolumeAutomated) {
+            mVolume.store(mVolumeRamp.value());
+            mVolumeAutomated = false;
         }
+        frame += count;
     }
 }
 
-void AudioEngine::applyVolume(float* buffer, int32_t numSamples) {
-    float volume = mVolume.load();
-    for (int32_t i = 0; i < numSamples; i++) {
-        buffer[i] *= volume;
+void AudioEngine::drainAutomation() {
+    AutomationEvent event;
+    while (mAutomationQueue.read(&event, 1) == 1) {
+        if (mNumPendingRamps == kMaxPendingRamps) continue;  // Dropped; the queue holds twice as many
+        // Stable insert: ramps at the same frame start in posting order
+        int32_t i = mNumPendingRamps;
+        while (i > 0 && mPendingRamps[i - 1].startFrame > event.startFrame) {
+            mPendingRamps[i] = mPendingRamps[i - 1];
+            i--;
+        }
+        mPendingRamps[i] = event;
+        mNumPendingRamps++;
+    }
+}
+
+bool AudioEngine::scheduleRamp(int32_t parameter, float target, int64_t startFrame, int64_t durationFrames,
+                               RampCurve curve) {
+    if (std::isnan(target)) return false;
+    AutomationEvent event{};
+    switch (parameter) {
+        case kAutomateVolume: event.target = std::clamp(target, 0.0f, 2.0f); break;
+        case kAutomateFade: event.target = std::clamp(target, 0.0f, 1.0f); break;
+        default: return false;
     }
+    event.parameter = parameter;
+    event.startFrame = startFrame;
+    event.durationFrames = std::max<int64_t>(durationFrames, 0);
+    event.curve = curve == RampCurve::kExponential ? RampCurve::kExponential : RampCurve::kLinear;
+    
+    std::lock_guard<std::mutex> lock(mAutomationMutex);
+    return mAutomationQueue.write(&event, 1) == 1;
 }
 
 void AudioEngine::setReverb(int preset, float wetMix) {
     mReverbPreset.store(std::clamp(preset, 0, 6));
-    mReverbWet.store(std::clamp(wetMix, 0.0f, 1.0f));
+    storeClamped(mReverbWet, wetMix, 0.0f, 1.0f);
+    rebuildChain();
 }
 
+template <int kChannels>
 void AudioEngine::applyReverb(float* buffer, int32_t numFrames, int32_t channelCount) {
+    channelCount = fixedChannels<kChannels>(channelCount);
     int preset = mReverbPreset.load();
     float wetMix = mReverbWet.load();
     
@@ -759,71 +1379,142 @@ void AudioEngine::applyReverb(float* buffer, int32_t numFrames, int32_t channelC
     float dryMix = 1.0f - wetMix * 0.5f;  // Keep some dry signal
     const float allpassGain = 0.5f;
     
-    for (int32_t i = 0; i < numFrames; i++) {
-        // Get mono input for reverb
-        float input = 0.0f;
-        for (int32_t ch = 0; ch < channelCount; ch++) {
-            input += buffer[i * channelCount + ch];
+    // The LFE neither feeds the reverb nor gets its tail
+    const int32_t lfe = kChannels == 0 ? mLayout.lfe : -1;
+    const float inputScale = 1.0f / (lfe >= 0 ? channelCount - 1 : channelCount);
+    
+    // Blocks no longer than the shortest delay only read samples written before
+    // the block, so every delay line is read and written as whole spans
+    float input[kReverbBlockFrames];
+    float combOut[kReverbBlockFrames];
+    float feedback[kReverbBlockFrames];
+    float allpassOut[kReverbBlockFrames];
+    
+    for (int32_t frame = 0; frame < numFrames; frame += kReverbBlockFrames) {
+        const int32_t count = std::min(numFrames - frame, kReverbBlockFrames);
+        float* block = buffer + frame * channelCount;
+        
+        // Mono input for reverb
+        for (int32_t i = 0; i < count; i++) {
+            float sum = 0.0f;
+            for (int32_t ch = 0; ch < channelCount; ch++) {
+                sum += ch == lfe ? 0.0f : block[i * channelCount + ch];
+            }
+            input[i] = sum * inputScale;
         }
-        input /= channelCount;
         
         // 4 Parallel Comb Filters
-        float combOut = 0.0f;
-        
-        // Comb 1
-        int readPos1 = (mCombPos1 - combDelays[0] + kReverbBufferSize) % kReverbBufferSize;
-        float comb1 = mCombBuffer1[readPos1];
-        mCombBuffer1[mCombPos1] = input + comb1 * combDecays[0];
-        mCombPos1 = (mCombPos1 + 1) % kReverbBufferSize;
-        combOut += comb1;
-        
-        // Comb 2
-        int readPos2 = (mCombPos2 - combDelays[1] + kReverbBufferSize) % kReverbBufferSize;
-        float comb2 = mCombBuffer2[readPos2];
-        mCombBuffer2[mCombPos2] = input + comb2 * combDecays[1];
-        mCombPos2 = (mCombPos2 + 1) % kReverbBufferSize;
-        combOut += comb2;
-        
-        // Comb 3
-        int readPos3 = (mCombPos3 - combDelays[2] + kReverbBufferSize) % kReverbBufferSize;
-        float comb3 = mCombBuffer3[readPos3];
-        mCombBuffer3[mCombPos3] = input + comb3 * combDecays[2];
-        mCombPos3 = (mCombPos3 + 1) % kReverbBufferSize;
-        combOut += comb3;
-        
-        // Comb 4
-        int readPos4 = (mCombPos4 - combDelays[3] + kReverbBufferSize) % kReverbBufferSize;
-        float comb4 = mCombBuffer4[readPos4];
-        mCombBuffer4[mCombPos4] = input + comb4 * combDecays[3];
-        mCombPos4 = (mCombPos4 + 1) % kReverbBufferSize;
-        combOut += comb4;
-        
-        combOut *= 0.25f;  // Average comb outputs
+        std::fill(combOut, combOut + count, 0.0f);
+        for (int c = 0; c < 4; c++) {
+            combBlock(input, mReverbCombs[c].span(combDelays[c]), combDecays[c], combOut, feedback, count);
+            mReverbCombs[c].write(feedback, count);
+        }
+        for (int32_t i = 0; i < count; i++) {
+            combOut[i] *= 0.25f;  // Average comb outputs
+        }
         
         // 2 Series Allpass Filters
-        // Allpass 1
-        int ap1ReadPos = (mAllpassPos1 - allpassDelays[0] + kReverbBufferSize) % kReverbBufferSize;
-        float ap1Delayed = mAllpassBuffer1[ap1ReadPos];
-        float ap1Out = ap1Delayed - allpassGain * combOut;
-        mAllpassBuffer1[mAllpassPos1] = combOut + allpassGain * ap1Out;
-        mAllpassPos1 = (mAllpassPos1 + 1) % kReverbBufferSize;
-        
-        // Allpass 2
-        int ap2ReadPos = (mAllpassPos2 - allpassDelays[1] + kReverbBufferSize) % kReverbBufferSize;
-        float ap2Delayed = mAllpassBuffer2[ap2ReadPos];
-        float ap2Out = ap2Delayed - allpassGain * ap1Out;
-        mAllpassBuffer2[mAllpassPos2] = ap1Out + allpassGain * ap2Out;
-        mAllpassPos2 = (mAllpassPos2 + 1) % kReverbBufferSize;
-        
-        float reverbOut = ap2Out;
+        allpassBlock(combOut, mReverbAllpasses[0].span(allpassDelays[0]), allpassGain, allpassOut, feedback, count);
+        mReverbAllpasses[0].write(feedback, count);
+        allpassBlock(allpassOut, mReverbAllpasses[1].span(allpassDelays[1]), allpassGain, combOut, feedback, count);
+        mReverbAllpasses[1].write(feedback, count);
+        const float* reverbOut = combOut;
         
         // Mix wet and dry signals
-        for (int32_t ch = 0; ch < channelCount; ch++) {
-            int idx = i * channelCount + ch;
-            buffer[idx] = buffer[idx] * dryMix + reverbOut * wetMix;
+        for (int32_t i = 0; i < count; i++) {
+            for (int32_t ch = 0; ch < channelCount; ch++) {
+                if (ch == lfe) continue;
+                int idx = i * channelCount + ch;
+                block[idx] = block[idx] * dryMix + reverbOut[i] * wetMix;
+            }
         }
     }
 }
 
+bool AudioEngine::loadImpulseResponse(const float* ir, int32_t numFrames, int32_t channelCount) {
+    if (ir == nullptr || numFrames <= 0 || numFrames > Convolver::kMaxIrFrames) return false;
+    if (channelCount < 1 || channelCount > Convolver::kMaxChannels) return false;
+    const size_t numTaps = static_cast<size_t>(numFrames) * channelCount;
+    // Finite and below +60 dB: anything louder is a broken file and would overflow the mix
+    if (!std::all_of(ir, ir + numTaps, [](float tap) { return std::abs(tap) <= 1000.0f; })) {
+        LOGE("Impulse response rejected: non-finite or out-of-range taps");
+        return false;
+    }
+    
+    // FFT planning and IR transforms happen here, off the audio thread
+    mConvolver.publish(new Convolver(ir, numFrames, channelCount));
+    {
+        std::lock_guard<std::mutex> lock(mSourceMutex);
+        mImpulseResponse.assign(ir, ir + numTaps);
+        mImpulseChannels = channelCount;
+    }
+    rebuildChain();
+    LOGI("Impulse response loaded: %d frames, %d channels", numFrames, channelCount);
+    return true;
+}
+
+void AudioEngine::clearImpulseResponse() {
+    mConvolver.publish(new Convolver(nullptr, 0, 0));
+    {
+        std::lock_guard<std::mutex> lock(mSourceMutex);
+        mImpulseResponse.clear();
+        mImpulseChannels = 0;
+    }
+    rebuildChain();
+}
+
+void AudioEngine::setConvolutionMix(float wetMix) {
+    storeClamped(mConvolutionMix, wetMix, 0.0f, 1.0f);
+}
+
+void AudioEngine::setSpectrumAnalyzerEnabled(bool enabled) {
+    mSpectrumAnalyzer.setEnabled(enabled);
+}
+
+bool AudioEngine::getSpectrum(float* bands, int32_t numBands) const {
+    return mSpectrumAnalyzer.getBands(bands, numBands);
+}
+
+bool AudioEngine::loadHrirSet(const char* path) {
+    std::lock_guard<std::mutex> lock(mHrirMutex);
+    return buildBinauralRenderer(path);
+}
+
+bool AudioEngine::buildBinauralRenderer(const char* path) {
+    std::unique_ptr<HrirSet> hrirs = HrirSet::open(path);
+    if (!hrirs) {
+        LOGE("Failed to load HRIR set: %s", path ? path : "(null)");
+        return false;
+    }
+    
+    // Filter folding and FFTs happen here; the mapping is released once the renderer is built.
+    // The set's rate range bounds the stretch only if the stream's rate is in it too.
+    const int32_t sampleRate = mSampleRate.load();
+    if (sampleRate >= HrirSet::kMinSampleRate && sampleRate <= HrirSet::kMaxSampleRate) {
+        mBinauralRenderer.publish(new BinauralRenderer(*hrirs, sampleRate));
+    } else {
+        LOGE("No binaural rendering at %d Hz", sampleRate);
+    }
+    mHrirRate = sampleRate;
+    {
+        std::lock_guard<std::mutex> lock(mSourceMutex);
+        mHrirPath = path;
+    }
+    LOGI("HRIR set loaded: %d directions, %d taps at %d Hz",
+         hrirs->numDirections(), hrirs->irLength(), hrirs->sampleRate());
+    return true;
+}
+
+void AudioEngine::rebuildBinauralRenderer() {
+    std::lock_guard<std::mutex> lock(mHrirMutex);
+    std::string path;
+    {
+        std::lock_guard<std::mutex> sourceLock(mSourceMutex);
+        path = mHrirPath;
+    }
+    // A load since the rate change already built for the new rate
+    if (path.empty() || mHrirRate == mSampleRate.load()) return;
+    buildBinauralRenderer(path.c_str());
+}
 
 } // namespace euphoriae
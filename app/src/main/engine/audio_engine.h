@@ -17,9 +17,27 @@
 #ifndef EUPHORIAE_AUDIO_ENGINE_H
 #define EUPHORIAE_AUDIO_ENGINE_H
 
+#include "binaural_renderer.h"
+#include "channel_layout.h"
+#include "channel_mixer.h"
+#include "delay_line.h"
+#include "convolver.h"
+#include "gain_ramp.h"
+#include "handoff.h"
+#include "loudness_meter.h"
+#include "spectrum_analyzer.h"
+#include "spsc_ring.h"
+#include "stereo_matrix.h"
+#include "tail_tracker.h"
+#include "thread_pool.h"
+#include "tone_stack.h"
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cmath>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace euphoriae {
 
@@ -28,17 +46,101 @@ namespace euphoriae {
  */
 class AudioEngine {
 public:
+    // Widest stream processAudio accepts (7.1); other buffers pass through untouched
+    static constexpr int32_t kMaxChannels = LoudnessMeter::kMaxChannels;
+    
+    // Frames the whole chain runs over at a time; larger buffers are split into these
+    static constexpr int32_t kBlockFrames = 128;
+
     AudioEngine();
-    ~AudioEngine() = default;
+    ~AudioEngine();
 
+    // Stream format; call from the processing thread before the first buffer of a new format
+    void configure(int32_t sampleRate, int32_t channelCount);
+    
     // Process audio buffer in-place
     void processAudio(float* buffer, int32_t numFrames, int32_t channelCount);
     
+    // Channels the converting processAudio produces from a stream, for the current
+    // surround mode: Movie upmixes stereo to 5.1 (not with headphone surround), the
+    // other modes downmix multichannel to stereo, Off keeps the layout. Query when
+    // configuring; the output format is fixed until the next configure.
+    int32_t outputChannelCount(int32_t inputChannels) const;
+    
+    // Upmix or downmix input into output (which must not overlap unless the counts
+    // match), then run the chain over output. Unsupported pairs produce silence.
+    void processAudio(const float* input, int32_t inputChannels, float* output, int32_t outputChannels,
+                      int32_t numFrames);
+    
+    // Sub-block length, kBlockFrames by default; 0 runs each stage over the whole
+    // buffer (benchmarks only)
+    void setBlockFrames(int32_t frames) { mBlockFrames = std::max<int32_t>(frames, 0); }
+    
+    // Fused stages for common configurations, on by default; off compiles every
+    // stage on its own (benchmarks and tests only)
+    void setFastPathsEnabled(bool enabled);
+    
+    // Offline rendering: take over every setting of another engine (not its
+    // filter state or the per-track gain). Call before processing, after configure.
+    void copySettingsFrom(const AudioEngine& other);
+    
+    // Processing thread, after a seek or flush: drops every tail, delay line and
+    // envelope (only what was written since the last reset is cleared) and fades
+    // the next few milliseconds in. The leveler keeps its gain: same stream.
+    void reset();
+    
+    // Frames after which the output no longer depends on what was processed
+    // before, for the current settings (longest filter, reverb and leveler memory)
+    int64_t settleFrames() const;
+    
+    // ================== Automation ==================
+    
+    // Parameters scheduleRamp moves sample-accurately. The fade is a gain of its
+    // own after the volume (0 to 1), so a fade-out leaves the volume setting alone.
+    enum AutomatedParameter : int32_t {
+        kAutomateVolume = 0,
+        kAutomateFade = 1,
+    };
+    
+    // Any thread: ramp a parameter from its value at startFrame to target over
+    // durationFrames (0 jumps), in the frame time of getFramePosition(). A start
+    // already passed begins with the next block, a new ramp takes over from the
+    // one in progress, and a volume ramp owns the volume until it ends. False
+    // for an unknown parameter or when the queue is full.
+    bool scheduleRamp(int32_t parameter, float target, int64_t startFrame, int64_t durationFrames,
+                      RampCurve curve);
+    
+    // Frames processAudio has run through since the engine was created
+    int64_t getFramePosition() const { return mFramePosition.load(std::memory_order_acquire); }
+    
+    // ================== Chain Order ==================
+    
+    // Stages setStageOrder arranges. Track gain and the input meter and leveler
+    // always run first; limiter, volume and the final clip always run last.
+    enum ChainStage : int32_t {
+        kStageToneStack = 0,
+        kStageEqualizer,
+        kStageTubeWarmth,
+        kStageCompressor,
+        kStageLoudnessGain,
+        kStageReverb,
+        kStageConvolution,
+        kStageSurround3D,
+        kStageStereoMatrix,  // Virtualizer, separation and balance
+        kNumChainStages
+    };
+    
+    // Any thread: order is a permutation of every ChainStage (reverb ahead of
+    // the compressor, say). False, changing nothing, for anything else.
+    bool setStageOrder(const int32_t* order, int32_t count);
+    
     // ================== Effect Controls ==================
     
     // Basic effects
     void setVolume(float volume);
     void setBassBoost(float strength);
+    void setBassFrequency(float hz);  // Shelf / virtual bass corner, 40 to 200 Hz
+    void setBassMode(int mode);       // 0=Shelf, 1=Virtual bass (harmonics for small speakers)
     void setVirtualizer(float strength);
     void setEqualizerBand(int band, float gainDb);
     
@@ -52,6 +154,7 @@ public:
     void setSurroundMode(int mode);      // 0=Off, 1=Music, 2=Movie, 3=Game, 4=Podcast
     void setHeadphoneSurround(bool enabled);  // Toggle headphone surround
     void setHeadphoneType(int type);  // 0=Generic, 1=InEar, 2=OverEar, 3=OpenBack, 4=Studio
+    bool loadHrirSet(const char* path);  // EHIR file, enables binaural headphone surround
     void setClarity(float level);
     void setTubeWarmth(float warmth);
     void setSpectrumExtension(float level);
@@ -59,10 +162,22 @@ public:
     void setChannelSeparation(float separation);
     void setTrebleBoost(float level);
     void setVolumeLeveler(float level);
+    void setVolumeLevelerTarget(float lufs);  // -30 to -8 LUFS
+    void setTrackGain(float gainDb);  // Precomputed per-track gain, -24 to +24 dB (0 = off)
     void setDynamicRange(float range);       // 0 to 1 (1 = full range)
     void setLoudnessGain(float gain);        // 0 to 1
     void setReverb(int preset, float wetMix);  // preset 0-6, wetMix 0-1
     
+    // Convolution (headphone correction, room impulse responses), on the front
+    // left/right pair only: centre, LFE and surrounds of 5.1/7.1 pass through dry
+    bool loadImpulseResponse(const float* ir, int32_t numFrames, int32_t channelCount);  // Interleaved, mono or stereo
+    void clearImpulseResponse();
+    void setConvolutionMix(float wetMix);  // 0 to 1
+    
+    // Spectrum analyzer (visualizers)
+    void setSpectrumAnalyzerEnabled(bool enabled);
+    bool getSpectrum(float* bands, int32_t numBands) const;  // Levels 0-1, false until available
+    
     // Time stretching / Pitch shifting
     void setTempo(float tempo);      // 0.5 to 2.0 (1.0 = normal)
     void setPitch(float semitones);  // -12 to +12 semitones
@@ -73,6 +188,8 @@ public:
     
     float getVolume() const { return mVolume.load(); }
     float getBassBoost() const { return mBassBoost.load(); }
+    float getBassFrequency() const { return mBassFrequency.load(); }
+    int getBassMode() const { return mBassMode.load(); }
     float getVirtualizer() const { return mVirtualizer.load(); }
     float getCompressor() const { return mCompressorStrength.load(); }
     float getLimiter() const { return mLimiterCeiling.load(); }
@@ -81,33 +198,144 @@ public:
     float getTubeWarmth() const { return mTubeWarmth.load(); }
     int getReverbPreset() const { return mReverbPreset.load(); }
     float getReverbWet() const { return mReverbWet.load(); }
+    float getConvolutionMix() const { return mConvolutionMix.load(); }
+    
+    // Input loudness (BS.1770), LUFS
+    float getMomentaryLoudness() const { return mLoudnessMeter.momentary(); }
+    float getShortTermLoudness() const { return mLoudnessMeter.shortTerm(); }
+    float getIntegratedLoudness() const { return mLoudnessMeter.integrated(); }
+    
+    // DspKernels set picked for this CPU ("sse2", "avx2+fma", "neon"), for diagnostics.
+    // It covers the convolution FIR and spectrum products only; see dsp_kernels.h.
+    static const char* simdVariant();
 
 private:
     // ================== Effect Processors ==================
     
-    void applyBassBoost(float* buffer, int32_t numFrames, int32_t channelCount);
-    void applyVirtualizer(float* buffer, int32_t numFrames, int32_t channelCount);
-    void applyEqualizer(float* buffer, int32_t numFrames, int32_t channelCount);
-    void applyCompressor(float* buffer, int32_t numFrames, int32_t channelCount);
     void applyLimiter(float* buffer, int32_t numSamples);
-    void applySurround3D(float* buffer, int32_t numFrames);
-    void applyClarity(float* buffer, int32_t numFrames, int32_t channelCount);
     void applyTubeWarmth(float* buffer, int32_t numSamples);
-    void applySpectrumExtension(float* buffer, int32_t numFrames, int32_t channelCount);
-    void applyStereoBalance(float* buffer, int32_t numFrames);
-    void applyChannelSeparation(float* buffer, int32_t numFrames);
-    void applyTrebleBoost(float* buffer, int32_t numFrames, int32_t channelCount);
+    
+    // Per-frame stages, instantiated per channel count: 1 and 2 are fixed at
+    // compile time, 0 takes channelCount
+    template <int kChannels>
+    void applyEqualizer(float* buffer, int32_t numFrames, int32_t channelCount);
+    template <int kChannels>
+    void applyCompressor(float* buffer, int32_t numFrames, int32_t channelCount);
+    template <int kChannels>
     void applyVolumeLeveler(float* buffer, int32_t numFrames, int32_t channelCount);
+    template <int kChannels>
+    void applyTrackGain(float* buffer, int32_t numFrames, int32_t channelCount);
+    template <int kChannels>
     void applyReverb(float* buffer, int32_t numFrames, int32_t channelCount);
-    void applyVolume(float* buffer, int32_t numSamples);
+    template <int kChannels>
+    void applySurround3D(float* buffer, int32_t numFrames, int32_t channelCount);
+    
+    // Current gains of the EQ and loudness stages, shared by the generic and fused stages
+    float equalizerGain() const;
+    float loudnessGainFactor() const;
+    
+    // Volume and fade, starting queued ramps at their frame; a null buffer (silent
+    // block) only moves the ramps on
+    template <int kChannels>
+    void applyVolume(float* buffer, int32_t numFrames, int32_t channelCount);
+    
+    // Moves ramps posted since the last buffer into mPendingRamps, by start frame
+    void drainAutomation();
+    
+    // Headphone surround on a multichannel stream: the layout downmixed to stereo,
+    // rendered binaurally into the front pair, the other channels muted
+    void applyBinauralDownmix(BinauralRenderer& renderer, float* buffer, int32_t numFrames,
+                              int32_t channelCount, int32_t layout, float mix);
+    
+    // The effect chain over one sub-block, ending with the final clip; processBlock picks
+    // the processChain instantiation for the channel count
+    void processBlock(float* buffer, int32_t numFrames, int32_t channelCount);
+    template <int kChannels>
+    void processChain(float* buffer, int32_t numFrames, int32_t channelCount);
+    
+    // ================== Chain Stages ==================
+    
+    // One sub-block on its way down the chain; 'silent' follows the signal
+    struct Block {
+        float* buffer;
+        int32_t numFrames;
+        int32_t channelCount;
+        int32_t numSamples;
+        float sampleRate;
+        bool silent;
+    };
+    using StageFn = void (AudioEngine::*)(Block& block);
+    
+    // The chain as the audio thread runs it: only the stages that are switched
+    // on, in order, as member function pointers for each processChain
+    // instantiation (mono, stereo, any). Compiled by rebuildChain on whichever
+    // thread changed a setting, swapped in through mChain at the next block;
+    // the plan it replaces is freed by the next rebuild, never by the audio thread.
+    struct ChainPlan {
+        static constexpr int32_t kMaxStages = 16;
+        StageFn stages[3][kMaxStages];
+        int32_t numStages = 0;
+    };
+    
+    // Any thread, after a setting that switches a stage on or off, or the order
+    void rebuildChain();
+    
+    template <int kChannels> void stageTrackGain(Block& block);
+    template <int kChannels> void stageLoudnessMeter(Block& block);
+    template <int kChannels> void stageVolumeLeveler(Block& block);
+    template <int kChannels> void stageLevelerOff(Block& block);
+    template <int kChannels> void stageToneStack(Block& block);
+    template <int kChannels> void stageEqualizer(Block& block);
+    template <int kChannels> void stageTubeWarmth(Block& block);
+    template <int kChannels> void stageCompressor(Block& block);
+    template <int kChannels> void stageLoudnessGain(Block& block);
+    template <int kChannels> void stageReverb(Block& block);
+    template <int kChannels> void stageConvolution(Block& block);
+    template <int kChannels> void stageSurround3D(Block& block);
+    template <int kChannels> void stageStereoMatrix(Block& block);
+    template <int kChannels> void stageOutput(Block& block);
+    
+    // Fused run of stages (see rebuildChain for when it is compiled in)
+    template <int kChannels, bool kTone> void stageToneEqualizerOutput(Block& block);
+    
+    // Zeroes a block with non-finite samples and resets the effect state
+    void dropBlock(Block& block);
+    
+    // Clears every filter, delay line and envelope (after non-finite samples)
+    void resetState();
+    
+    // Builds and publishes the renderer for the current rate; the caller holds mHrirMutex
+    bool buildBinauralRenderer(const char* path);
+    
+    // Worker: rebuilds the renderer after a sample rate change, if a set is loaded
+    void rebuildBinauralRenderer();
+    
+    // Fade-in after reset(), applied to the chain input
+    template <int kChannels>
+    void applyFadeIn(float* buffer, int32_t numFrames, int32_t channelCount);
 
+    // The members fall into three groups, each starting on its own cache line:
+    // parameters the UI thread writes, state the audio thread writes every
+    // block, and large buffers. A slider drag then never invalidates a line
+    // the audio thread is writing, and vice versa.
+    
     // ================== Effect Parameters ==================
+    // Written by any thread, only read by the audio thread
+    
+    static constexpr int32_t kDefaultSampleRate = 48000;
+    alignas(64) std::atomic<int32_t> mSampleRate{kDefaultSampleRate};
     
     // Basic
     std::atomic<float> mVolume{1.0f};
     std::atomic<float> mBassBoost{0.0f};
+    std::atomic<float> mBassFrequency{80.0f};  // Hz
+    std::atomic<int> mBassMode{0};             // 0=Shelf, 1=Virtual
     std::atomic<float> mVirtualizer{0.0f};
     
+    // Equalizer
+    static constexpr int kNumEqualizerBands = 10;
+    std::array<std::atomic<float>, kNumEqualizerBands> mEqualizerBands{};
+    
     // Compressor
     std::atomic<float> mCompressorStrength{0.0f};
     std::atomic<float> mCompressorThreshold{-10.0f};  // dB
@@ -132,6 +360,8 @@ private:
     std::atomic<float> mSpectrumExtension{0.0f};
     std::atomic<float> mTrebleBoost{0.0f};
     std::atomic<float> mVolumeLeveler{0.0f};
+    std::atomic<float> mVolumeLevelerTarget{-16.0f};  // LUFS
+    std::atomic<float> mTrackGain{1.0f};  // Linear
     
     std::atomic<float> mStereoBalance{0.0f};
     std::atomic<float> mChannelSeparation{0.5f};
@@ -142,11 +372,100 @@ private:
     std::atomic<int> mReverbPreset{0};  // 0=None, 1=SmallRoom, 2=MediumRoom, 3=LargeRoom, 4=MediumHall, 5=LargeHall, 6=Plate
     std::atomic<float> mReverbWet{0.0f};  // Wet/dry mix 0-1
     
+    // Convolution
+    std::atomic<float> mConvolutionMix{1.0f};  // Wet/dry mix 0-1
+    
     // Tempo/Pitch (WSOLA time stretching)
     std::atomic<float> mTempo{1.0f};          // 0.5 to 2.0
     std::atomic<float> mPitchSemitones{0.0f}; // -12 to +12
     float mPitchRatio{1.0f};                  // Calculated from semitones
     
+    // ================== Filter States ==================
+    // Audio thread only (the loudness meter publishes its readings)
+    
+    // Bass, treble, clarity and spectrum extension
+    alignas(64) ToneStack mToneStack{kDefaultSampleRate};
+    
+    // Virtualizer, channel separation and balance
+    StereoMatrix mStereoMatrix;
+    
+    // Speaker roles of the stream, from configure or the first buffer of a new count
+    ChannelLayout mLayout = ChannelLayout::forChannelCount(2);
+    
+    // Upmix / downmix ahead of the chain
+    ChannelMixer mChannelMixer{kDefaultSampleRate};
+    
+    // Compressor envelope follower
+    float mCompressorEnvelope = 0.0f;
+    
+    // Stages with memory keep running on silent input until these say their tail is gone
+    TailTracker mMeterTail;
+    TailTracker mToneTail;
+    TailTracker mReverbTail;
+    TailTracker mConvolverTail;
+    TailTracker mSurroundTail;
+    
+    // Volume leveler: input loudness and the per-sample smoothed gain it drives
+    LoudnessMeter mLoudnessMeter{kDefaultSampleRate};
+    float mLevelerGain = 1.0f;
+    
+    // Gains smoothed toward their settings over mSmoothingFrames, which is 0
+    // for the first block after creation, configure, reset or a settings copy:
+    // a fresh stream starts at its settings instead of ramping to them
+    int32_t mSmoothingFrames = 0;
+    bool mSnapGains = true;
+    GainRamp mTrackGainRamp{1.0f};
+    GainRamp mEqGainRamp{1.0f};
+    GainRamp mLoudnessGainRamp{1.0f};
+    
+    // Convolver and binaural renderer: built on the caller's thread (the worker
+    // for a rate change), picked up by the audio thread at the next block
+    Handoff<Convolver> mConvolver;
+    Handoff<BinauralRenderer> mBinauralRenderer;
+    std::mutex mHrirMutex;  // Serializes renderer builds, so the last set and rate win
+    int32_t mHrirRate = 0;  // Rate of the last renderer built; guarded by mHrirMutex
+    bool mBinauralActive = false;  // Audio thread only: renderer state is stale when re-entered
+    
+    int32_t mFadeInFrames = 0;
+    int32_t mFadeInRemaining = 0;
+    
+    // Automation: ramps in start order, the running volume and fade, and the
+    // stream position of the block being processed
+    struct AutomationEvent {
+        int64_t startFrame;
+        int64_t durationFrames;
+        float target;
+        int32_t parameter;
+        RampCurve curve;
+    };
+    static constexpr int32_t kMaxPendingRamps = 16;
+    std::array<AutomationEvent, kMaxPendingRamps> mPendingRamps{};
+    int32_t mNumPendingRamps = 0;
+    GainRamp mVolumeRamp{1.0f};
+    GainRamp mFadeRamp{1.0f};
+    bool mVolumeAutomated = false;  // The volume ramp is a scheduled one, not smoothing
+    int64_t mBlockPosition = 0;
+    std::atomic<int64_t> mFramePosition{0};  // Published after every buffer
+    
+    int32_t mBlockFrames = kBlockFrames;
+    int32_t mBufferCount = 0;  // Performance logging
+    bool mNonFiniteLogged = false;
+    
+    // ================== Buffers ==================
+    // Large, and only a few lines of each are touched per block
+    
+    // 3D Surround delay lines (Haas effect), up to 85 ms at 48kHz
+    alignas(64) DelayLine<4096> mSurroundDelayL;
+    DelayLine<4096> mSurroundDelayR;
+    
+    // Reverb delay lines (Schroeder reverb with 4 comb + 2 allpass filters); the
+    // longest preset delays are 4091 and 797 frames
+    std::array<DelayLine<4096>, 4> mReverbCombs;
+    std::array<DelayLine<1024>, 2> mReverbAllpasses;
+    
+    // Stereo downmix fed to the binaural renderer for multichannel streams
+    alignas(16) float mDownmix[kBlockFrames * 2] = {};
+    
     // WSOLA buffer for time stretching
     static constexpr int kWsolaBufferSize = 8192;
     static constexpr int kWsolaWindowSize = 1024;
@@ -156,54 +475,31 @@ private:
     int mWsolaReadPos = 0;
     float mWsolaPhase = 0.0f;
     
-    // ================== Filter States ==================
-    
-    // Equalizer
-    static constexpr int kNumEqualizerBands = 10;
-    std::array<std::atomic<float>, kNumEqualizerBands> mEqualizerBands{};
+    // What the convolver and renderer were built from, so settings can be copied
+    mutable std::mutex mSourceMutex;
+    std::vector<float> mImpulseResponse;
+    int32_t mImpulseChannels = 0;
+    std::string mHrirPath;
     
-    // Bass boost filter state (per channel)
-    float mBassState[2] = {0.0f, 0.0f};
+    // Compiled chain, and what it was compiled from (the order and the stage
+    // list last published, so unchanged rebuilds publish nothing)
+    Handoff<ChainPlan> mChain;
+    mutable std::mutex mChainMutex;
+    std::array<int32_t, kNumChainStages> mStageOrder{};
+    bool mFastPaths = true;
+    std::array<StageFn, ChainPlan::kMaxStages> mPublishedStages{};
+    int32_t mNumPublishedStages = -1;
     
-    // Biquad filter structure
-    struct BiquadState {
-        float z1 = 0.0f;
-        float z2 = 0.0f;
-    };
-    std::array<BiquadState, kNumEqualizerBands * 2> mEqStates{}; // stereo
-    
-    // Clarity high-shelf filter state
-    float mClarityState[2] = {0.0f, 0.0f};
-    
-    // Treble boost filter state
-    float mTrebleState[2] = {0.0f, 0.0f};
+    // Ramps posted by any thread; the mutex keeps them a single producer
+    std::mutex mAutomationMutex;
+    SpscRing<AutomationEvent> mAutomationQueue{kMaxPendingRamps * 2};
     
-    // Compressor envelope follower
-    float mCompressorEnvelope = 0.0f;
+    // Post-chain analysis tap (its ring keeps producer and consumer apart itself)
+    SpectrumAnalyzer mSpectrumAnalyzer{kDefaultSampleRate};
     
-    // Volume leveler RMS tracking
-    float mRmsLevel = 0.0f;
-    float mTargetRms = 0.3f;  // Target RMS level
-    
-    // 3D Surround delay buffer (for Haas effect)
-    static constexpr int kMaxDelayFrames = 2048;
-    float mDelayBufferL[kMaxDelayFrames] = {0};
-    float mDelayBufferR[kMaxDelayFrames] = {0};
-    int mDelayWritePos = 0;
-    
-    // Spectrum extension harmonic state
-    float mHarmonicState[2] = {0.0f, 0.0f};
-    
-    // Reverb delay buffers (Schroeder reverb with 4 comb + 2 allpass filters)
-    static constexpr int kReverbBufferSize = 8192;
-    float mCombBuffer1[kReverbBufferSize] = {0};
-    float mCombBuffer2[kReverbBufferSize] = {0};
-    float mCombBuffer3[kReverbBufferSize] = {0};
-    float mCombBuffer4[kReverbBufferSize] = {0};
-    float mAllpassBuffer1[kReverbBufferSize] = {0};
-    float mAllpassBuffer2[kReverbBufferSize] = {0};
-    int mCombPos1 = 0, mCombPos2 = 0, mCombPos3 = 0, mCombPos4 = 0;
-    int mAllpassPos1 = 0, mAllpassPos2 = 0;
+    // Rebuilds configure() must not run on the stream's thread. Declared last so
+    // it stops before anything its tasks touch is destroyed.
+    ThreadPool mWorker{1};
 };
 
 } // namespace euphoriae
@@ -0,0 +1,230 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "binaural_renderer.h"
+#include "dsp_kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace euphoriae {
+
+namespace {
+
+/** Speaker - Virtual speaker fed by feedLeft * L + feedRight * R */
+struct Speaker {
+    float azimuth;
+    float feedLeft;
+    float feedRight;
+};
+
+struct Layout {
+    Speaker speakers[4];
+    int32_t numSpeakers;
+};
+
+// Rear speakers carry the side signal (L - R) / 2 for envelopment without
+// smearing the phantom centre.
+constexpr Layout kLayouts[BinauralRenderer::kNumLayouts] = {
+    // Generic: stereo triangle with a little rear ambience
+    {{{-30.0f, 1.0f, 0.0f}, {30.0f, 0.0f, 1.0f},
+      {-110.0f, 0.075f, -0.075f}, {110.0f, -0.075f, 0.075f}}, 4},
+    // In-Ear: sound sits inside the head, so push more side signal behind
+    {{{-30.0f, 1.0f, 0.0f}, {30.0f, 0.0f, 1.0f},
+      {-110.0f, 0.175f, -0.175f}, {110.0f, -0.175f, 0.175f}}, 4},
+    // Over-Ear: wider front pair plus moderate rear
+    {{{-40.0f, 1.0f, 0.0f}, {40.0f, 0.0f, 1.0f},
+      {-110.0f, 0.125f, -0.125f}, {110.0f, -0.125f, 0.125f}}, 4},
+    // Open-Back: already spacious, narrow front pair only
+    {{{-25.0f, 1.0f, 0.0f}, {25.0f, 0.0f, 1.0f}}, 2},
+    // Studio: plain +-30 degree monitor pair
+    {{{-30.0f, 1.0f, 0.0f}, {30.0f, 0.0f, 1.0f}}, 2},
+};
+
+// Linear resampling of one HRIR to the engine rate
+void resample(const float* in, int32_t inLength, float* out, int32_t outLength, double ratio) {
+    for (int32_t i = 0; i < outLength; i++) {
+        double pos = i / ratio;
+        int32_t i0 = static_cast<int32_t>(pos);
+        float frac = static_cast<float>(pos - i0);
+        float a = i0 < inLength ? in[i0] : 0.0f;
+        float b = i0 + 1 < inLength ? in[i0 + 1] : 0.0f;
+        out[i] = a + (b - a) * frac;
+    }
+}
+
+} // namespace
+
+BinauralRenderer::BinauralRenderer(const HrirSet& hrirs, int32_t sampleRate) : mSampleRate(sampleRate) {
+    const double ratio = static_cast<double>(sampleRate) / hrirs.sampleRate();
+    const int32_t irLength = static_cast<int32_t>(std::ceil(hrirs.irLength() * ratio));
+
+    mPlan = FftPlan::get(kBlockSize * 2);
+    mNumBins = mPlan->numBins();
+    mNumPartitions = (irLength + kBlockSize - 1) / kBlockSize;
+
+    mAccRe.assign(mNumBins, 0.0f);
+    mAccIm.assign(mNumBins, 0.0f);
+    mTime.assign(kBlockSize * 2, 0.0f);
+    mWork.assign(mPlan->workSize(), 0.0f);
+
+    const size_t pathSize = static_cast<size_t>(mNumPartitions) * mNumBins;
+    mFilterRe.assign(pathSize * kNumPaths * kNumLayouts, 0.0f);
+    mFilterIm.assign(pathSize * kNumPaths * kNumLayouts, 0.0f);
+
+    // Fold every layout's speakers into the four input-to-ear filters
+    std::vector<float> path[kNumPaths];
+    std::vector<float> hrirLeft(irLength);
+    std::vector<float> hrirRight(irLength);
+    for (int32_t l = 0; l < kNumLayouts; l++) {
+        const Layout& layout = kLayouts[l];
+        for (auto& p : path) p.assign(irLength, 0.0f);
+
+        for (int32_t s = 0; s < layout.numSpeakers; s++) {
+            const Speaker& speaker = layout.speakers[s];
+            int32_t direction = hrirs.nearest(speaker.azimuth, 0.0f);
+            resample(hrirs.left(direction), hrirs.irLength(), hrirLeft.data(), irLength, ratio);
+            resample(hrirs.right(direction), hrirs.irLength(), hrirRight.data(), irLength, ratio);
+            for (int32_t i = 0; i < irLength; i++) {
+                path[kLeftToLeft][i] += speaker.feedLeft * hrirLeft[i];
+                path[kLeftToRight][i] += speaker.feedLeft * hrirRight[i];
+                path[kRightToLeft][i] += speaker.feedRight * hrirLeft[i];
+                path[kRightToRight][i] += speaker.feedRight * hrirRight[i];
+            }
+        }
+
+        // Unit energy on the near-ear path keeps layouts level-matched with the dry signal
+        double energy = 0.0;
+        for (float tap : path[kLeftToLeft]) energy += static_cast<double>(tap) * tap;
+        float norm = energy > 1e-12 ? static_cast<float>(1.0 / std::sqrt(energy)) : 0.0f;
+
+        for (int32_t p = 0; p < kNumPaths; p++) {
+            size_t base = (static_cast<size_t>(l) * kNumPaths + p) * pathSize;
+            for (int32_t part = 0; part < mNumPartitions; part++) {
+                std::fill(mTime.begin(), mTime.end(), 0.0f);
+                int32_t start = part * kBlockSize;
+                int32_t count = std::min(kBlockSize, irLength - start);
+                for (int32_t i = 0; i < count; i++) {
+                    mTime[i] = path[p][start + i] * norm;
+                }
+                mPlan->forward(mTime.data(),
+                               mFilterRe.data() + base + part * mNumBins,
+                               mFilterIm.data() + base + part * mNumBins,
+                               mWork.data());
+            }
+        }
+    }
+
+    for (int32_t ch = 0; ch < 2; ch++) {
+        mInput[ch].assign(kBlockSize * 2, 0.0f);
+        mFdlRe[ch].assign(pathSize, 0.0f);
+        mFdlIm[ch].assign(pathSize, 0.0f);
+        mOutput[ch].assign(kBlockSize, 0.0f);
+    }
+}
+
+void BinauralRenderer::reset() {
+    if (!mDirty) return;
+    mDirty = false;
+    for (int32_t ch = 0; ch < 2; ch++) {
+        std::fill(mInput[ch].begin(), mInput[ch].end(), 0.0f);
+        std::fill(mFdlRe[ch].begin(), mFdlRe[ch].end(), 0.0f);
+        std::fill(mFdlIm[ch].begin(), mFdlIm[ch].end(), 0.0f);
+        std::fill(mOutput[ch].begin(), mOutput[ch].end(), 0.0f);
+    }
+    mFdlIndex = 0;
+    mPosition = 0;
+}
+
+void BinauralRenderer::process(float* buffer, int32_t numFrames, int32_t layout, float mix) {
+    layout = std::clamp(layout, 0, kNumLayouts - 1);
+    mDirty = true;
+    const float dryMix = 1.0f - mix;
+
+    int32_t frame = 0;
+    while (frame < numFrames) {
+        int32_t chunk = std::min(numFrames - frame, kBlockSize - mPosition);
+        float* inputL = mInput[0].data();
+        float* inputR = mInput[1].data();
+        const float* earL = mOutput[0].data();
+        const float* earR = mOutput[1].data();
+
+        for (int32_t j = 0; j < chunk; j++) {
+            int32_t idx = (frame + j) * 2;
+            int32_t pos = mPosition + j;
+            // The first half of the input buffer is the previous block: the dry path delayed to match
+            float dryL = inputL[pos];
+            float dryR = inputR[pos];
+            inputL[kBlockSize + pos] = buffer[idx];
+            inputR[kBlockSize + pos] = buffer[idx + 1];
+            buffer[idx] = dryL * dryMix + earL[pos] * mix;
+            buffer[idx + 1] = dryR * dryMix + earR[pos] * mix;
+        }
+
+        frame += chunk;
+        mPosition += chunk;
+        if (mPosition == kBlockSize) {
+            processBlock(layout);
+            mPosition = 0;
+        }
+    }
+}
+
+void BinauralRenderer::processBlock(int32_t layout) {
+    const size_t pathSize = static_cast<size_t>(mNumPartitions) * mNumBins;
+    const float* filterRe = mFilterRe.data() + static_cast<size_t>(layout) * kNumPaths * pathSize;
+    const float* filterIm = mFilterIm.data() + static_cast<size_t>(layout) * kNumPaths * pathSize;
+
+    // One forward transform per input channel, shared by both ears
+    for (int32_t ch = 0; ch < 2; ch++) {
+        mPlan->forward(mInput[ch].data(),
+                       mFdlRe[ch].data() + mFdlIndex * mNumBins,
+                       mFdlIm[ch].data() + mFdlIndex * mNumBins,
+                       mWork.data());
+        std::memcpy(mInput[ch].data(), mInput[ch].data() + kBlockSize, kBlockSize * sizeof(float));
+    }
+
+    for (int32_t ear = 0; ear < 2; ear++) {
+        const int32_t fromLeft = (ear == 0) ? kLeftToLeft : kLeftToRight;
+        const int32_t fromRight = (ear == 0) ? kRightToLeft : kRightToRight;
+
+        std::fill(mAccRe.begin(), mAccRe.end(), 0.0f);
+        std::fill(mAccIm.begin(), mAccIm.end(), 0.0f);
+        const DspKernels& kernels = dspKernels();
+        for (int32_t p = 0; p < mNumPartitions; p++) {
+            int32_t slot = mFdlIndex - p;
+            if (slot < 0) slot += mNumPartitions;
+            size_t input = static_cast<size_t>(slot) * mNumBins;
+            size_t part = static_cast<size_t>(p) * mNumBins;
+            kernels.spectrumMultiplyAccumulate(mFdlRe[0].data() + input, mFdlIm[0].data() + input,
+                                               filterRe + fromLeft * pathSize + part,
+                                               filterIm + fromLeft * pathSize + part,
+                                               mAccRe.data(), mAccIm.data(), mNumBins);
+            kernels.spectrumMultiplyAccumulate(mFdlRe[1].data() + input, mFdlIm[1].data() + input,
+                                               filterRe + fromRight * pathSize + part,
+                                               filterIm + fromRight * pathSize + part,
+                                               mAccRe.data(), mAccIm.data(), mNumBins);
+        }
+
+        // Overlap-save: keep the second half
+        mPlan->inverse(mAccRe.data(), mAccIm.data(), mTime.data(), mWork.data());
+        std::memcpy(mOutput[ear].data(), mTime.data() + kBlockSize, kBlockSize * sizeof(float));
+    }
+
+    mFdlIndex = (mFdlIndex + 1) % mNumPartitions;
+}
+
+} // namespace euphoriae
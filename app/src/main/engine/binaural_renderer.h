@@ -0,0 +1,89 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EUPHORIAE_BINAURAL_RENDERER_H
+#define EUPHORIAE_BINAURAL_RENDERER_H
+
+#include "fft.h"
+#include "hrir_set.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace euphoriae {
+
+/**
+ * BinauralRenderer - Virtual speakers over headphones from an HRIR set
+ *
+ * Each headphone type selects a virtual speaker layout whose feeds are
+ * linear mixes of the stereo input. Because of that, every layout folds into
+ * four filters (L->left ear, L->right ear, R->left ear, R->right ear) built
+ * once at load time. Per block the renderer runs two forward FFTs shared by
+ * both ears, four spectral multiply-accumulates per partition and two inverse
+ * FFTs, regardless of how many speakers a layout has.
+ *
+ * Latency is one block; the dry signal is delayed to match before mixing.
+ * Switching layouts only swaps filter spectra, the input history is shared.
+ */
+class BinauralRenderer {
+public:
+    static constexpr int32_t kBlockSize = 64;
+    static constexpr int32_t kNumLayouts = 5;  // 0=Generic, 1=InEar, 2=OverEar, 3=OpenBack, 4=Studio
+
+    // HRIRs are resampled to sampleRate if the set was measured at another rate
+    BinauralRenderer(const HrirSet& hrirs, int32_t sampleRate);
+
+    // Stereo in place: delayed dry * (1 - mix) + binaural * mix
+    void process(float* buffer, int32_t numFrames, int32_t layout, float mix);
+
+    void reset();
+
+    // The rate the HRIRs were resampled to
+    int32_t sampleRate() const { return mSampleRate; }
+
+private:
+    enum Path { kLeftToLeft, kLeftToRight, kRightToLeft, kRightToRight, kNumPaths };
+
+    void processBlock(int32_t layout);
+
+    int32_t mSampleRate;
+    std::shared_ptr<const FftPlan> mPlan;  // 2 * kBlockSize
+    int32_t mNumBins = 0;
+    int32_t mNumPartitions = 0;
+
+    // Filter spectra: [layout][path] -> numPartitions * numBins
+    std::vector<float> mFilterRe;
+    std::vector<float> mFilterIm;
+
+    // Input blocks [previous | current] and their spectra delay lines, per input channel
+    std::vector<float> mInput[2];
+    std::vector<float> mFdlRe[2];
+    std::vector<float> mFdlIm[2];
+    int32_t mFdlIndex = 0;
+
+    std::vector<float> mOutput[2];  // Ear signals for the block being played out
+    int32_t mPosition = 0;
+    bool mDirty = false;  // Processed since the last reset
+
+    std::vector<float> mAccRe;
+    std::vector<float> mAccIm;
+    std::vector<float> mTime;
+    std::vector<float> mWork;
+};
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_BINAURAL_RENDERER_H
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef EUPHORIAE_CHANNEL_LAYOUT_H
+#define EUPHORIAE_CHANNEL_LAYOUT_H
+
+#include <cstdint>
+
+namespace euphoriae {
+
+enum class Speaker : uint8_t {
+    kFrontLeft,
+    kFrontRight,
+    kFrontCenter,
+    kLowFrequency,
+    kBackLeft,
+    kBackRight,
+    kBackCenter,
+    kSideLeft,
+    kSideRight,
+};
+
+/**
+ * ChannelLayout - Speaker of every channel in an interleaved stream
+ *
+ * Streams only carry a channel count, so the layout is the one ExoPlayer and
+ * AudioTrack use for that count, in Android (and WAVE) channel order:
+ *
+ *   1  C                     5  L R C Lb Rb
+ *   2  L R                   6  L R C LFE Lb Rb          (5.1)
+ *   3  L R C                 7  L R C LFE Lb Rb Cb       (6.1)
+ *   4  L R Lb Rb             8  L R C LFE Lb Rb Ls Rs    (7.1)
+ *
+ * Left/right pairs are always adjacent, left first, which lets stereo stages
+ * run on each pair with the frame as stride.
+ */
+struct ChannelLayout {
+    static constexpr int32_t kMaxChannels = 8;
+    static constexpr int32_t kMaxPairs = 3;
+
+    int32_t channels = 0;
+    Speaker speakers[kMaxChannels]{};
+
+    // Index of the left channel of each pair, front pair first
+    int32_t pairs[kMaxPairs]{};
+    int32_t numPairs = 0;
+
+    int32_t center = -1;
+    int32_t lfe = -1;
+
+    // Channels other than the LFE, what effects that mix channels feed from
+    int32_t fullRangeChannels = 0;
+
+    static ChannelLayout forChannelCount(int32_t channelCount) {
+        static constexpr Speaker kLayouts[kMaxChannels][kMaxChannels] = {
+            {Speaker::kFrontCenter},
+            {Speaker::kFrontLeft, Speaker::kFrontRight},
+            {Speaker::kFrontLeft, Speaker::kFrontRight, Speaker::kFrontCenter},
+            {Speaker::kFrontLeft, Speaker::kFrontRight, Speaker::kBackLeft, Speaker::kBackRight},
+            {Speaker::kFrontLeft, Speaker::kFrontRight, Speaker::kFrontCenter, Speaker::kBackLeft,
+             Speaker::kBackRight},
+            {Speaker::kFrontLeft, Speaker::kFrontRight, Speaker::kFrontCenter, Speaker::kLowFrequency,
+             Speaker::kBackLeft, Speaker::kBackRight},
+            {Speaker::kFrontLeft, Speaker::kFrontRight, Speaker::kFrontCenter, Speaker::kLowFrequency,
+             Speaker::kBackLeft, Speaker::kBackRight, Speaker::kBackCenter},
+            {Speaker::kFrontLeft, Speaker::kFrontRight, Speaker::kFrontCenter, Speaker::kLowFrequency,
+             Speaker::kBackLeft, Speaker::kBackRight, Speaker::kSideLeft, Speaker::kSideRight},
+        };
+
+        ChannelLayout layout;
+        if (channelCount < 1 || channelCount > kMaxChannels) return layout;
+        layout.channels = channelCount;
+        for (int32_t ch = 0; ch < channelCount; ch++) {
+            const Speaker speaker = kLayouts[channelCount - 1][ch];
+            layout.speakers[ch] = speaker;
+            if (speaker == Speaker::kFrontCenter) layout.center = ch;
+            if (speaker == Speaker::kLowFrequency) {
+                layout.lfe = ch;
+            } else {
+                layout.fullRangeChannels++;
+            }
+            if (speaker == Speaker::kFrontLeft || speaker == Speaker::kBackLeft || speaker == Speaker::kSideLeft) {
+                layout.pairs[layout.numPairs++] = ch;
+            }
+        }
+        return layout;
+    }
+
+    bool isSurround(int32_t ch) const {
+        return speakers[ch] == Speaker::kBackLeft || speakers[ch] == Speaker::kBackRight ||
+               speakers[ch] == Speaker::kBackCenter || speakers[ch] == Speaker::kSideLeft ||
+               speakers[ch] == Speaker::kSideRight;
+    }
+
+    // ITU-R BS.1770 channel weight: surrounds +1.5 dB, LFE left out
+    float loudnessWeight(int32_t ch) const {
+        if (ch == lfe) return 0.0f;
+        return isSurround(ch) ? 1.41f : 1.0f;
+    }
+
+    // ITU-R BS.775 stereo downmix gains (centre and surrounds at -3 dB, no LFE),
+    // scaled so a full-scale signal on every channel cannot exceed full scale
+    void downmixGains(float* left, float* right) const {
+        constexpr float kMinus3Db = 0.70710678f;
+        float leftSum = 0.0f;
+        for (int32_t ch = 0; ch < channels; ch++) {
+            left[ch] = 0.0f;
+            right[ch] = 0.0f;
+            switch (speakers[ch]) {
+                case Speaker::kFrontLeft: left[ch] = 1.0f; break;
+                case Speaker::kFrontRight: right[ch] = 1.0f; break;
+                case Speaker::kBackLeft:
+                case Speaker::kSideLeft: left[ch] = kMinus3Db; break;
+                case Speaker::kBackRight:
+                case Speaker::kSideRight: right[ch] = kMinus3Db; break;
+                case Speaker::kFrontCenter:
+                case Speaker::kBackCenter: left[ch] = right[ch] = kMinus3Db; break;
+                case Speaker::kLowFrequency: break;
+            }
+            leftSum += left[ch];
+        }
+        const float scale = leftSum > 1.0f ? 1.0f / leftSum : 1.0f;
+        for (int32_t ch = 0; ch < channels; ch++) {
+            left[ch] *= scale;
+            right[ch] *= scale;
+        }
+    }
+};
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_CHANNEL_LAYOUT_H
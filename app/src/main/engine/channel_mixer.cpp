@@ -0,0 +1,207 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "channel_mixer.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+
+namespace euphoriae {
+
+namespace {
+
+constexpr float kLfeFrequency = 120.0f;
+constexpr float kLfeGain = 0.5f;
+constexpr float kSurroundGain = 0.7f;
+constexpr float kSurroundDelaySeconds = 0.010f;
+constexpr float kDiffuserGain = 0.6f;
+constexpr float kEnergySeconds = 0.1f;
+
+// Diffuser delays at 48 kHz, mutually prime so the two sides never line up
+constexpr int32_t kLeftDiffuserDelays[2] = {89, 127};
+constexpr int32_t kRightDiffuserDelays[2] = {71, 113};
+
+// Interleaved frames of a fixed layout, downmixed four at a time: each channel's
+// four samples become one vector, so the gains are broadcasts
+template <int32_t kChannels>
+void downmixFrames(const float* input, int32_t numFrames, const float* leftGains, const float* rightGains,
+                   float* stereo) {
+    simd::float4 leftLanes[kChannels];
+    simd::float4 rightLanes[kChannels];
+    for (int32_t ch = 0; ch < kChannels; ch++) {
+        leftLanes[ch] = simd::set1(leftGains[ch]);
+        rightLanes[ch] = simd::set1(rightGains[ch]);
+    }
+
+    int32_t i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        const float* frames = input + i * kChannels;
+        simd::float4 left = simd::set1(0.0f);
+        simd::float4 right = simd::set1(0.0f);
+        for (int32_t ch = 0; ch < kChannels; ch++) {
+            alignas(16) const float column[4] = {frames[ch], frames[kChannels + ch], frames[2 * kChannels + ch],
+                                                 frames[3 * kChannels + ch]};
+            simd::float4 x = simd::load(column);
+            left = simd::mulAdd(left, leftLanes[ch], x);
+            right = simd::mulAdd(right, rightLanes[ch], x);
+        }
+        simd::store2Interleaved(stereo + i * 2, left, right);
+    }
+    for (; i < numFrames; i++) {
+        const float* frame = input + i * kChannels;
+        float left = 0.0f;
+        float right = 0.0f;
+        for (int32_t ch = 0; ch < kChannels; ch++) {
+            left += leftGains[ch] * frame[ch];
+            right += rightGains[ch] * frame[ch];
+        }
+        stereo[i * 2] = left;
+        stereo[i * 2 + 1] = right;
+    }
+}
+
+} // namespace
+
+ChannelMixer::ChannelMixer(int32_t sampleRate) : mSampleRate(0) {
+    setSampleRate(sampleRate);
+}
+
+void ChannelMixer::setSampleRate(int32_t sampleRate) {
+    mSampleRate = std::max(sampleRate, 8000);
+    const double fs = mSampleRate;
+
+    // RBJ low pass, Q = 1/sqrt(2)
+    const double w0 = 2.0 * M_PI * kLfeFrequency / fs;
+    const double alpha = std::sin(w0) / std::sqrt(2.0);
+    const double cosW = std::cos(w0);
+    const double a0 = 1.0 + alpha;
+    mLfeLowPass.b0 = static_cast<float>((1.0 - cosW) / 2.0 / a0);
+    mLfeLowPass.b1 = static_cast<float>((1.0 - cosW) / a0);
+    mLfeLowPass.b2 = mLfeLowPass.b0;
+    mLfeLowPass.a1 = static_cast<float>(-2.0 * cosW / a0);
+    mLfeLowPass.a2 = static_cast<float>((1.0 - alpha) / a0);
+
+    mEnergyCoef = static_cast<float>(std::exp(-1.0 / (kEnergySeconds * fs)));
+
+    const double scale = fs / 48000.0;
+    auto scaled = [scale](int32_t frames, int32_t limit) {
+        return std::clamp(static_cast<int32_t>(frames * scale), 1, limit);
+    };
+    mSurroundDelayFrames = scaled(static_cast<int32_t>(kSurroundDelaySeconds * 48000.0f),
+                                  decltype(mSurroundDelay)::kMaxDelay);
+    for (int32_t i = 0; i < 2; i++) {
+        mLeftDiffusers[i].delay = scaled(kLeftDiffuserDelays[i], decltype(mLeftDiffusers[i].line)::kMaxDelay);
+        mRightDiffusers[i].delay = scaled(kRightDiffuserDelays[i], decltype(mRightDiffusers[i].line)::kMaxDelay);
+    }
+    reset();
+}
+
+void ChannelMixer::reset() {
+    mLfeZ1 = 0.0f;
+    mLfeZ2 = 0.0f;
+    mMidEnergy = 0.0f;
+    mSideEnergy = 0.0f;
+    mCenterGain = 0.0f;
+    mSurroundDelay.clear();
+    for (Allpass& allpass : mLeftDiffusers) allpass.line.clear();
+    for (Allpass& allpass : mRightDiffusers) allpass.line.clear();
+}
+
+void ChannelMixer::upmix(const float* stereo, int32_t numFrames, float* output) {
+    if (stereo == nullptr || output == nullptr || numFrames <= 0) return;
+    for (int32_t frame = 0; frame < numFrames; frame += kAnalysisFrames) {
+        upmixBlock(stereo + frame * 2, std::min(kAnalysisFrames, numFrames - frame),
+                   output + frame * kUpmixChannels);
+    }
+}
+
+void ChannelMixer::upmixBlock(const float* stereo, int32_t numFrames, float* output) {
+    // Block energies drive the centre gain, ramped across the block
+    float midEnergy = 0.0f;
+    float sideEnergy = 0.0f;
+    for (int32_t i = 0; i < numFrames; i++) {
+        const float mid = 0.5f * (stereo[i * 2] + stereo[i * 2 + 1]);
+        const float side = 0.5f * (stereo[i * 2] - stereo[i * 2 + 1]);
+        midEnergy += mid * mid;
+        sideEnergy += side * side;
+    }
+    const float keep = std::pow(mEnergyCoef, static_cast<float>(numFrames));
+    mMidEnergy = keep * mMidEnergy + (1.0f - keep) * midEnergy / numFrames;
+    mSideEnergy = keep * mSideEnergy + (1.0f - keep) * sideEnergy / numFrames;
+
+    // 1 for a centred mono source, 0 for uncorrelated or out-of-phase channels
+    const float total = mMidEnergy + mSideEnergy;
+    const float targetGain = total > 1e-12f ? std::max((mMidEnergy - mSideEnergy) / total, 0.0f) : 0.0f;
+    const float gainStep = (targetGain - mCenterGain) / numFrames;
+
+    const Biquad& lp = mLfeLowPass;
+    float centerGain = mCenterGain;
+    for (int32_t i = 0; i < numFrames; i++) {
+        const float left = stereo[i * 2];
+        const float right = stereo[i * 2 + 1];
+        const float mid = 0.5f * (left + right);
+        const float side = 0.5f * (left - right);
+        centerGain += gainStep;
+
+        // Centre moved out of both fronts at equal power
+        const float center = centerGain * mid;
+
+        const float lfe = lp.b0 * mid + mLfeZ1;
+        mLfeZ1 = lp.b1 * mid - lp.a1 * lfe + mLfeZ2;
+        mLfeZ2 = lp.b2 * mid - lp.a2 * lfe;
+
+        const float delayed = mSurroundDelay.read(mSurroundDelayFrames);
+        mSurroundDelay.write(side);
+        float surroundLeft = delayed;
+        float surroundRight = delayed;
+        for (int32_t k = 0; k < 2; k++) {
+            surroundLeft = mLeftDiffusers[k].process(surroundLeft, kDiffuserGain);
+            surroundRight = mRightDiffusers[k].process(surroundRight, kDiffuserGain);
+        }
+
+        float* frame = output + i * kUpmixChannels;
+        frame[0] = left - center;
+        frame[1] = right - center;
+        frame[2] = static_cast<float>(M_SQRT2) * center;
+        frame[3] = kLfeGain * lfe;
+        frame[4] = kSurroundGain * surroundLeft;
+        frame[5] = -kSurroundGain * surroundRight;
+    }
+    mCenterGain = targetGain;
+}
+
+void ChannelMixer::downmix(const float* input, int32_t numFrames, int32_t channelCount, float* stereo) {
+    if (input == nullptr || stereo == nullptr || numFrames <= 0) return;
+    const ChannelLayout layout = ChannelLayout::forChannelCount(channelCount);
+    if (layout.channels == 0) return;
+    float left[ChannelLayout::kMaxChannels];
+    float right[ChannelLayout::kMaxChannels];
+    layout.downmixGains(left, right);
+
+    switch (channelCount) {
+        case 1: downmixFrames<1>(input, numFrames, left, right, stereo); break;
+        case 2: downmixFrames<2>(input, numFrames, left, right, stereo); break;
+        case 3: downmixFrames<3>(input, numFrames, left, right, stereo); break;
+        case 4: downmixFrames<4>(input, numFrames, left, right, stereo); break;
+        case 5: downmixFrames<5>(input, numFrames, left, right, stereo); break;
+        case 6: downmixFrames<6>(input, numFrames, left, right, stereo); break;
+        case 7: downmixFrames<7>(input, numFrames, left, right, stereo); break;
+        default: downmixFrames<8>(input, numFrames, left, right, stereo); break;
+    }
+}
+
+} // namespace euphoriae
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef EUPHORIAE_CHANNEL_MIXER_H
+#define EUPHORIAE_CHANNEL_MIXER_H
+
+#include "channel_layout.h"
+#include "delay_line.h"
+#include <cstdint>
+
+namespace euphoriae {
+
+/**
+ * ChannelMixer - Stereo to 5.1 upmix and multichannel to stereo downmix
+ *
+ * Upmix splits stereo into mid and side. The centre takes the part of the mid
+ * signal that is correlated between the channels (the ratio of mid to side
+ * energy, smoothed over ~100 ms), and is removed from the fronts at equal
+ * power. The surrounds get the side signal through a short delay and two
+ * different allpass cascades, so they are decorrelated from the fronts and
+ * from each other, and the LFE gets the mid signal below 120 Hz.
+ *
+ * Downmix uses the ITU-R BS.775 gains of the source layout (see
+ * ChannelLayout::downmixGains), four frames per SIMD vector.
+ */
+class ChannelMixer {
+public:
+    static constexpr int32_t kUpmixChannels = 6;  // 5.1, Android order
+
+    explicit ChannelMixer(int32_t sampleRate);
+
+    // Audio thread
+    void setSampleRate(int32_t sampleRate);
+    void reset();
+
+    // Interleaved stereo in, 5.1 out; the buffers must not overlap
+    void upmix(const float* stereo, int32_t numFrames, float* output);
+
+    // Any layout of 1 to 8 channels in, interleaved stereo out; the buffers must not overlap
+    static void downmix(const float* input, int32_t numFrames, int32_t channelCount, float* stereo);
+
+private:
+    // Centre analysis granularity, independent of the host buffer size
+    static constexpr int32_t kAnalysisFrames = 128;
+
+    void upmixBlock(const float* stereo, int32_t numFrames, float* output);
+
+    struct Biquad {
+        float b0, b1, b2, a1, a2;
+    };
+
+    // Schroeder allpass: y = d - g * x, d <- x + g * y
+    struct Allpass {
+        DelayLine<512> line;
+        int32_t delay = 1;
+        float process(float x, float gain) {
+            float y = line.read(delay) - gain * x;
+            line.write(x + gain * y);
+            return y;
+        }
+    };
+
+    int32_t mSampleRate;
+    Biquad mLfeLowPass{};
+    float mLfeZ1 = 0.0f;
+    float mLfeZ2 = 0.0f;
+
+    // Mid and side energy, smoothed across blocks
+    float mMidEnergy = 0.0f;
+    float mSideEnergy = 0.0f;
+    float mEnergyCoef = 0.0f;
+    float mCenterGain = 0.0f;
+
+    DelayLine<2048> mSurroundDelay;
+    int32_t mSurroundDelayFrames = 1;
+    Allpass mLeftDiffusers[2];
+    Allpass mRightDiffusers[2];
+};
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_CHANNEL_MIXER_H
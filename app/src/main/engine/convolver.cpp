@@ -0,0 +1,310 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "convolver.h"
+#include "dsp_kernels.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace euphoriae {
+
+Convolver::Convolver(const float* ir, int32_t irFrames, int32_t irChannels) {
+    if (ir == nullptr || irFrames <= 0 || irChannels < 1 || irChannels > kMaxChannels) return;
+    mIrFrames = std::min(irFrames, kMaxIrFrames);
+
+    // An immediate segment starts at an offset equal to its own partition size,
+    // so the block it computes when its input completes is due exactly one block
+    // later. A deferred one starts a partition later and gets that block's time
+    // to compute it in.
+    auto segmentStart = [](int32_t size) {
+        return size > kMaxImmediatePartitionSize ? size * 2 : size;
+    };
+    int32_t offset = kHeadLength;
+    int32_t partitionSize = kHeadLength;
+    while (offset < mIrFrames) {
+        int32_t nextSize = std::min(partitionSize * kPartitionGrowth, kMaxPartitionSize);
+        int32_t end = (nextSize > partitionSize) ? std::min(segmentStart(nextSize), mIrFrames) : mIrFrames;
+        int32_t numPartitions = (end - offset + partitionSize - 1) / partitionSize;
+
+        mSegments.push_back({partitionSize, offset, numPartitions, partitionSize > kMaxImmediatePartitionSize});
+        mPlans.push_back(FftPlan::get(partitionSize * 2));
+        mPeriod = partitionSize;
+
+        offset += numPartitions * partitionSize;
+        partitionSize = nextSize;
+    }
+
+    int32_t maxBins = mPeriod + 1;
+    mAccRe.assign(maxBins, 0.0f);
+    mAccIm.assign(maxBins, 0.0f);
+    mTime.assign(mPeriod * 2, 0.0f);
+    mWork.assign(mPeriod * 2, 0.0f);
+
+    // Transform every partition of every IR channel up front
+    mFilters.resize(irChannels);
+    for (int32_t ch = 0; ch < irChannels; ch++) {
+        Filter& filter = mFilters[ch];
+        auto tap = [&](int32_t i) { return i < mIrFrames ? ir[i * irChannels + ch] : 0.0f; };
+
+        filter.head.resize(kHeadLength);
+        for (int32_t k = 0; k < kHeadLength; k++) {
+            filter.head[k] = tap(kHeadLength - 1 - k);
+        }
+
+        filter.spectraRe.resize(mSegments.size());
+        filter.spectraIm.resize(mSegments.size());
+        for (size_t s = 0; s < mSegments.size(); s++) {
+            const Segment& segment = mSegments[s];
+            const FftPlan& plan = *mPlans[s];
+            int32_t numBins = plan.numBins();
+            filter.spectraRe[s].resize(segment.numPartitions * numBins);
+            filter.spectraIm[s].resize(segment.numPartitions * numBins);
+
+            for (int32_t p = 0; p < segment.numPartitions; p++) {
+                std::fill(mTime.begin(), mTime.end(), 0.0f);
+                int32_t start = segment.offset + p * segment.partitionSize;
+                for (int32_t i = 0; i < segment.partitionSize; i++) {
+                    mTime[i] = tap(start + i);
+                }
+                plan.forward(mTime.data(),
+                             filter.spectraRe[s].data() + p * numBins,
+                             filter.spectraIm[s].data() + p * numBins,
+                             mWork.data());
+            }
+        }
+    }
+
+    for (int32_t ch = 0; ch < kMaxChannels; ch++) {
+        ChannelState& channel = mChannels[ch];
+        channel.filter = &mFilters[std::min(ch, irChannels - 1)];
+        channel.history.assign(kHeadLength * 2 - 1, 0.0f);
+        channel.segments.resize(mSegments.size());
+        for (size_t s = 0; s < mSegments.size(); s++) {
+            const Segment& segment = mSegments[s];
+            int32_t numBins = mPlans[s]->numBins();
+            SegmentState& state = channel.segments[s];
+            state.input.assign(segment.partitionSize * 2, 0.0f);
+            state.fdlRe.assign(segment.numPartitions * numBins, 0.0f);
+            state.fdlIm.assign(segment.numPartitions * numBins, 0.0f);
+            state.output.assign(segment.partitionSize, 0.0f);
+            if (segment.deferred) {
+                state.window.assign(segment.partitionSize * 2, 0.0f);
+                state.pending.assign(segment.partitionSize, 0.0f);
+                state.accRe.assign(numBins, 0.0f);
+                state.accIm.assign(numBins, 0.0f);
+            }
+        }
+    }
+    mJobs.resize(mSegments.size());
+}
+
+void Convolver::reset() {
+    if (!mDirty) return;
+    mDirty = false;
+    for (ChannelState& channel : mChannels) {
+        std::fill(channel.history.begin(), channel.history.end(), 0.0f);
+        for (SegmentState& state : channel.segments) {
+            std::fill(state.input.begin(), state.input.end(), 0.0f);
+            std::fill(state.fdlRe.begin(), state.fdlRe.end(), 0.0f);
+            std::fill(state.fdlIm.begin(), state.fdlIm.end(), 0.0f);
+            std::fill(state.output.begin(), state.output.end(), 0.0f);
+            std::fill(state.pending.begin(), state.pending.end(), 0.0f);
+            state.fdlIndex = 0;
+        }
+    }
+    std::fill(mJobs.begin(), mJobs.end(), Job{});
+    mPosition = 0;
+}
+
+void Convolver::process(float* buffer, int32_t numFrames, int32_t channelCount, float wetMix) {
+    if (mIrFrames == 0 || buffer == nullptr) return;
+    mDirty = true;
+
+    const int32_t channels = std::min(channelCount, kMaxChannels);
+    const float dryMix = 1.0f - wetMix;
+    const DspKernels& kernels = dspKernels();
+    float wet[kHeadLength];
+
+    int32_t frame = 0;
+    while (frame < numFrames) {
+        // Chunks never straddle a head block boundary, which is where segments fire
+        int32_t chunk = std::min(numFrames - frame, kHeadLength - (mPosition % kHeadLength));
+
+        for (int32_t ch = 0; ch < channels; ch++) {
+            ChannelState& channel = mChannels[ch];
+            float* history = channel.history.data();
+            float* input = history + kHeadLength - 1;
+
+            for (int32_t j = 0; j < chunk; j++) {
+                input[j] = buffer[(frame + j) * channelCount + ch];
+            }
+
+            // Direct-form head: zero latency for the first kHeadLength taps
+            kernels.fir(channel.filter->head.data(), kHeadLength, history, wet, chunk);
+
+            // Partitioned tail: feed input, play out the block computed one partition ago
+            for (size_t s = 0; s < mSegments.size(); s++) {
+                int32_t partitionSize = mSegments[s].partitionSize;
+                int32_t offset = mPosition % partitionSize;
+                SegmentState& state = channel.segments[s];
+                std::memcpy(state.input.data() + partitionSize + offset, input, chunk * sizeof(float));
+                const float* output = state.output.data() + offset;
+                for (int32_t j = 0; j < chunk; j++) {
+                    wet[j] += output[j];
+                }
+            }
+
+            for (int32_t j = 0; j < chunk; j++) {
+                int32_t idx = (frame + j) * channelCount + ch;
+                buffer[idx] = input[j] * dryMix + wet[j] * wetMix;
+            }
+
+            std::memmove(history, history + chunk, (kHeadLength - 1) * sizeof(float));
+        }
+
+        frame += chunk;
+        mPosition = (mPosition + chunk) % mPeriod;
+
+        for (size_t s = 0; s < mSegments.size(); s++) {
+            if (mPosition % mSegments[s].partitionSize != 0) continue;
+            if (mSegments[s].deferred) {
+                startJob(static_cast<int32_t>(s), channels);
+                continue;
+            }
+            for (int32_t ch = 0; ch < channels; ch++) {
+                processSegment(mChannels[ch], static_cast<int32_t>(s));
+            }
+        }
+        if (mPosition % kHeadLength == 0) runDueJobSteps();
+    }
+}
+
+void Convolver::processSegment(ChannelState& channel, int32_t segmentIndex) {
+    const Segment& segment = mSegments[segmentIndex];
+    SegmentState& state = channel.segments[segmentIndex];
+    const FftPlan& plan = *mPlans[segmentIndex];
+    const int32_t partitionSize = segment.partitionSize;
+    const int32_t numBins = plan.numBins();
+
+    // Transform the newest 2 * partitionSize input samples into the delay line
+    float* slotRe = state.fdlRe.data() + state.fdlIndex * numBins;
+    float* slotIm = state.fdlIm.data() + state.fdlIndex * numBins;
+    plan.forward(state.input.data(), slotRe, slotIm, mWork.data());
+
+    std::fill(mAccRe.begin(), mAccRe.begin() + numBins, 0.0f);
+    std::fill(mAccIm.begin(), mAccIm.begin() + numBins, 0.0f);
+    const float* filterRe = channel.filter->spectraRe[segmentIndex].data();
+    const float* filterIm = channel.filter->spectraIm[segmentIndex].data();
+    const DspKernels& kernels = dspKernels();
+    for (int32_t p = 0; p < segment.numPartitions; p++) {
+        int32_t slot = state.fdlIndex - p;
+        if (slot < 0) slot += segment.numPartitions;
+        kernels.spectrumMultiplyAccumulate(state.fdlRe.data() + slot * numBins,
+                                           state.fdlIm.data() + slot * numBins,
+                                           filterRe + p * numBins, filterIm + p * numBins,
+                                           mAccRe.data(), mAccIm.data(), numBins);
+    }
+
+    // Overlap-save: the second half of the inverse transform is the valid output
+    plan.inverse(mAccRe.data(), mAccIm.data(), mTime.data(), mWork.data());
+    std::memcpy(state.output.data(), mTime.data() + partitionSize, partitionSize * sizeof(float));
+    std::memcpy(state.input.data(), state.input.data() + partitionSize, partitionSize * sizeof(float));
+
+    state.fdlIndex = (state.fdlIndex + 1) % segment.numPartitions;
+}
+
+void Convolver::startJob(int32_t segmentIndex, int32_t channels) {
+    const int32_t partitionSize = mSegments[segmentIndex].partitionSize;
+    Job& job = mJobs[segmentIndex];
+
+    // The previous block is due now. It has normally finished long ago; this
+    // only catches up if the schedule below was starved.
+    while (job.step < job.numSteps) runJobStep(segmentIndex);
+    for (int32_t ch = 0; ch < job.channels; ch++) {
+        SegmentState& state = mChannels[ch].segments[segmentIndex];
+        state.output.swap(state.pending);
+    }
+
+    for (int32_t ch = 0; ch < channels; ch++) {
+        SegmentState& state = mChannels[ch].segments[segmentIndex];
+        std::memcpy(state.window.data(), state.input.data(), partitionSize * 2 * sizeof(float));
+        std::memcpy(state.input.data(), state.input.data() + partitionSize, partitionSize * sizeof(float));
+    }
+    job.step = 0;
+    job.numSteps = channels * (mSegments[segmentIndex].numPartitions + 2);
+    job.channels = channels;
+}
+
+void Convolver::runJobStep(int32_t segmentIndex) {
+    const Segment& segment = mSegments[segmentIndex];
+    const FftPlan& plan = *mPlans[segmentIndex];
+    const int32_t numBins = plan.numBins();
+    Job& job = mJobs[segmentIndex];
+    const int32_t stepsPerChannel = segment.numPartitions + 2;
+    const int32_t step = job.step % stepsPerChannel;
+    ChannelState& channel = mChannels[job.step / stepsPerChannel];
+    SegmentState& state = channel.segments[segmentIndex];
+    job.step++;
+
+    if (step == 0) {
+        plan.forward(state.window.data(), state.fdlRe.data() + state.fdlIndex * numBins,
+                     state.fdlIm.data() + state.fdlIndex * numBins, mWork.data());
+        std::fill(state.accRe.begin(), state.accRe.end(), 0.0f);
+        std::fill(state.accIm.begin(), state.accIm.end(), 0.0f);
+    } else if (step <= segment.numPartitions) {
+        const int32_t p = step - 1;
+        int32_t slot = state.fdlIndex - p;
+        if (slot < 0) slot += segment.numPartitions;
+        dspKernels().spectrumMultiplyAccumulate(state.fdlRe.data() + slot * numBins,
+                                                state.fdlIm.data() + slot * numBins,
+                                                channel.filter->spectraRe[segmentIndex].data() + p * numBins,
+                                                channel.filter->spectraIm[segmentIndex].data() + p * numBins,
+                                                state.accRe.data(), state.accIm.data(), numBins);
+    } else {
+        plan.inverse(state.accRe.data(), state.accIm.data(), mTime.data(), mWork.data());
+        std::memcpy(state.pending.data(), mTime.data() + segment.partitionSize,
+                    segment.partitionSize * sizeof(float));
+        state.fdlIndex = (state.fdlIndex + 1) % segment.numPartitions;
+    }
+}
+
+// Called at every head block boundary. Runs one step of the job closest to
+// its deadline, plus whatever a job needs to still make it: a job may leave
+// at most one step for each later head block before its boundary.
+void Convolver::runDueJobSteps() {
+    bool ranOne = false;
+    while (true) {
+        int32_t urgent = -1;
+        int32_t minSlack = INT32_MAX;
+        for (size_t s = 0; s < mSegments.size(); s++) {
+            const Job& job = mJobs[s];
+            if (!mSegments[s].deferred || job.step >= job.numSteps) continue;
+            const int32_t partitionSize = mSegments[s].partitionSize;
+            const int32_t later = (partitionSize - mPosition % partitionSize) / kHeadLength - 1;
+            const int32_t slack = later - (job.numSteps - job.step);
+            if (slack < minSlack) {
+                minSlack = slack;
+                urgent = static_cast<int32_t>(s);
+            }
+        }
+        if (urgent < 0 || (ranOne && minSlack >= 0)) break;
+        runJobStep(urgent);
+        ranOne = true;
+    }
+}
+
+} // namespace euphoriae
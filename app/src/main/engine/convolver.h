@@ -0,0 +1,134 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EUPHORIAE_CONVOLVER_H
+#define EUPHORIAE_CONVOLVER_H
+
+#include "fft.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace euphoriae {
+
+/**
+ * Convolver - Zero-latency, non-uniformly partitioned convolution
+ *
+ * The first kHeadLength taps run as a direct FIR so there is no added delay.
+ * The rest of the impulse response is split into segments of uniformly
+ * partitioned FFT convolution whose partition size grows with the offset
+ * (64, 512, 4096, 16384), so cost grows far slower than the IR length.
+ *
+ * Segments up to kMaxImmediatePartitionSize are computed the moment their
+ * input block completes. Larger ones start one partition further into the
+ * IR, which gives their block a whole partition period until it is due; the
+ * transforms and products are spread over the head blocks of that period,
+ * so no callback carries a 32768-point FFT on top of every other segment.
+ *
+ * Construction allocates and transforms the IR; process() never allocates.
+ */
+class Convolver {
+public:
+    static constexpr int32_t kHeadLength = 64;
+    static constexpr int32_t kPartitionGrowth = 8;
+    static constexpr int32_t kMaxPartitionSize = 16384;
+    static constexpr int32_t kMaxImmediatePartitionSize = 512;
+    static constexpr int32_t kMaxChannels = 2;
+    static constexpr int32_t kMaxIrFrames = 48000 * 10;  // 10 seconds at 48kHz
+
+    // ir is interleaved with irChannels (1 or 2) channels. A mono IR is applied to both channels.
+    Convolver(const float* ir, int32_t irFrames, int32_t irChannels);
+
+    bool isEmpty() const { return mIrFrames == 0; }
+    int32_t irFrames() const { return mIrFrames; }
+
+    // Convolve the first kMaxChannels channels in place, blending wet and dry by wetMix.
+    // Beyond mono those are the front left/right pair; the rest pass through untouched.
+    void process(float* buffer, int32_t numFrames, int32_t channelCount, float wetMix);
+
+    void reset();
+
+private:
+    // One uniformly partitioned segment of the IR: taps [offset, offset + numPartitions * partitionSize)
+    struct Segment {
+        int32_t partitionSize;
+        int32_t offset;
+        int32_t numPartitions;
+        bool deferred;  // Computed over the following partition period instead of at once
+    };
+
+    // Precomputed spectra of one IR channel
+    struct Filter {
+        std::vector<float> head;  // Direct taps, time-reversed for contiguous dot products
+        std::vector<std::vector<float>> spectraRe;  // Per segment: numPartitions * numBins
+        std::vector<std::vector<float>> spectraIm;
+    };
+
+    // Streaming state of one segment for one channel
+    struct SegmentState {
+        std::vector<float> input;   // Last two blocks of input (2 * partitionSize)
+        std::vector<float> fdlRe;   // Frequency-domain delay line (numPartitions * numBins)
+        std::vector<float> fdlIm;
+        std::vector<float> output;  // Output block being played out (partitionSize)
+        int32_t fdlIndex = 0;
+
+        // Deferred segments only: the block being computed and its inputs
+        std::vector<float> window;   // Input snapshot taken when the block started (2 * partitionSize)
+        std::vector<float> pending;  // Output due at the next boundary (partitionSize)
+        std::vector<float> accRe;    // Spectrum accumulated so far (numBins)
+        std::vector<float> accIm;
+    };
+
+    // Progress of a deferred segment's block: numPartitions + 2 steps per channel
+    // (forward transform, one product per partition, inverse transform)
+    struct Job {
+        int32_t step = 0;
+        int32_t numSteps = 0;
+        int32_t channels = 0;
+    };
+
+    struct ChannelState {
+        const Filter* filter = nullptr;
+        std::vector<float> history;  // kHeadLength - 1 previous samples + current chunk
+        std::vector<SegmentState> segments;
+    };
+
+    void processSegment(ChannelState& channel, int32_t segmentIndex);
+    void startJob(int32_t segmentIndex, int32_t channels);
+    void runJobStep(int32_t segmentIndex);
+    void runDueJobSteps();
+
+    int32_t mIrFrames = 0;
+    int32_t mPeriod = kHeadLength;  // Largest partition size; block boundaries repeat with it
+    int32_t mPosition = 0;
+    bool mDirty = false;  // Processed since the last reset
+    std::vector<Segment> mSegments;
+    std::vector<Job> mJobs;  // One per segment, used by deferred ones
+    std::vector<std::shared_ptr<const FftPlan>> mPlans;  // One per segment (size 2 * partitionSize)
+    std::vector<Filter> mFilters;
+    ChannelState mChannels[kMaxChannels];
+
+    // Scratch shared by all segments, sized for the largest one; deferred
+    // segments keep their accumulators in their own state across head blocks
+    std::vector<float> mAccRe;
+    std::vector<float> mAccIm;
+    std::vector<float> mTime;
+    std::vector<float> mWork;
+};
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_CONVOLVER_H
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "cpu_features.h"
+
+#if defined(__linux__) && (defined(__arm__) || defined(__aarch64__))
+#include <sys/auxv.h>
+#endif
+
+namespace euphoriae {
+
+namespace {
+
+// Bits of AT_HWCAP, for headers that predate them
+#if defined(__aarch64__)
+constexpr unsigned long kHwcapFphp = 1UL << 9;
+constexpr unsigned long kHwcapAsimdhp = 1UL << 10;
+constexpr unsigned long kHwcapAsimddp = 1UL << 20;
+#elif defined(__arm__)
+constexpr unsigned long kHwcapNeon = 1UL << 12;
+#endif
+
+CpuFeatures probe() {
+    CpuFeatures features;
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    features.avx2 = __builtin_cpu_supports("avx2");
+    features.fma = __builtin_cpu_supports("fma");
+#elif defined(__aarch64__)
+    features.neon = true;
+#if defined(__linux__)
+    // Reported, not dispatched on: both are outside the float32 DSP
+    const unsigned long hwcap = getauxval(AT_HWCAP);
+    features.dotProduct = (hwcap & kHwcapAsimddp) != 0;
+    features.fp16 = (hwcap & kHwcapFphp) != 0 && (hwcap & kHwcapAsimdhp) != 0;
+#endif
+#elif defined(__arm__)
+#if defined(__linux__)
+    features.neon = (getauxval(AT_HWCAP) & kHwcapNeon) != 0;
+#elif defined(__ARM_NEON)
+    features.neon = true;
+#endif
+#endif
+    return features;
+}
+
+} // namespace
+
+const CpuFeatures& cpuFeatures() {
+    static const CpuFeatures features = probe();
+    return features;
+}
+
+} // namespace euphoriae
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef EUPHORIAE_CPU_FEATURES_H
+#define EUPHORIAE_CPU_FEATURES_H
+
+namespace euphoriae {
+
+/**
+ * CpuFeatures - Instruction set extensions the CPU (and OS) support beyond the ABI baseline
+ *
+ * Probed once, on first use: cpuid through the compiler's builtins on x86
+ * (which also check that the OS saves the AVX registers), the kernel's
+ * hwcaps on ARM. Extensions of the other architecture are always false.
+ */
+struct CpuFeatures {
+    // x86
+    bool avx2 = false;
+    bool fma = false;
+    
+    // ARM (NEON is part of the arm64 baseline). The arm64 extensions are
+    // probed for diagnostics only: no DspKernels set depends on them.
+    bool neon = false;
+    bool dotProduct = false;  // SDOT/UDOT, 8-bit integer only
+    bool fp16 = false;        // Half-precision arithmetic
+};
+
+const CpuFeatures& cpuFeatures();
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_CPU_FEATURES_H
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef EUPHORIAE_DELAY_LINE_H
+#define EUPHORIAE_DELAY_LINE_H
+
+#include <cstdint>
+#include <cstring>
+
+namespace euphoriae {
+
+/**
+ * DelayLine - Power-of-two ring buffer with a mirrored second copy
+ *
+ * Positions wrap with a mask instead of a modulo, and every sample is also
+ * written kSize frames further on, so any run of up to kSize samples is
+ * contiguous in memory: block code can read a whole span with one pointer and
+ * vectorize over it. Delays are in frames, 1 (the newest sample) to kSize.
+ *
+ * clear() only zeroes what was written since the last clear, so resetting an
+ * idle or briefly used line costs next to nothing.
+ */
+template <int32_t kSize>
+class DelayLine {
+    static_assert(kSize > 0 && (kSize & (kSize - 1)) == 0, "DelayLine size must be a power of two");
+
+public:
+    static constexpr int32_t kMaxDelay = kSize;
+
+    void clear() {
+        // Writes since the last clear started at 0, so they cover [0, mWritten)
+        // and its mirror
+        std::memset(mBuffer, 0, mWritten * sizeof(float));
+        std::memset(mBuffer + kSize, 0, mWritten * sizeof(float));
+        mWrite = 0;
+        mWritten = 0;
+    }
+
+    void write(float sample) {
+        mBuffer[mWrite] = sample;
+        mBuffer[mWrite + kSize] = sample;
+        mWrite = (mWrite + 1) & kMask;
+        if (mWritten < kSize) mWritten++;
+    }
+
+    // numSamples <= kSize
+    void write(const float* samples, int32_t numSamples) {
+        std::memcpy(mBuffer + mWrite, samples, numSamples * sizeof(float));
+        // Mirror: the part below kSize goes up a copy, the part past it comes down
+        int32_t low = kSize - mWrite < numSamples ? kSize - mWrite : numSamples;
+        std::memcpy(mBuffer + mWrite + kSize, samples, low * sizeof(float));
+        std::memcpy(mBuffer, samples + low, (numSamples - low) * sizeof(float));
+        mWrite = (mWrite + numSamples) & kMask;
+        mWritten = mWritten + numSamples < kSize ? mWritten + numSamples : kSize;
+    }
+
+    // The sample written delay frames ago
+    float read(int32_t delay) const { return mBuffer[(mWrite - delay) & kMask]; }
+
+    // Linear interpolation between whole-frame delays, 1 <= delay < kSize
+    float readFractional(float delay) const {
+        int32_t whole = static_cast<int32_t>(delay);
+        float fraction = delay - static_cast<float>(whole);
+        const float* pair = span(whole + 1);
+        return pair[1] + fraction * (pair[0] - pair[1]);
+    }
+
+    // Samples from delay frames ago onward, oldest first, contiguous for up to kSize
+    // samples; the first delay of them are already written
+    const float* span(int32_t delay) const { return mBuffer + ((mWrite - delay) & kMask); }
+
+private:
+    static constexpr int32_t kMask = kSize - 1;
+
+    alignas(16) float mBuffer[kSize * 2] = {};
+    int32_t mWrite = 0;
+    int32_t mWritten = 0;  // Frames written since the last clear, up to kSize
+};
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_DELAY_LINE_H
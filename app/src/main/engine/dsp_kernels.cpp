@@ -0,0 +1,68 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "EuphoriaeAudio"
+
+#include "dsp_kernels.h"
+#include "cpu_features.h"
+#include "dsp_kernels_impl.h"
+#include "engine_log.h"
+
+namespace euphoriae {
+
+#if defined(EUPHORIAE_KERNELS_AVX2)
+extern const DspKernels kAvx2Kernels;
+#endif
+
+namespace {
+
+#if defined(EUPHORIAE_SIMD_NEON)
+constexpr const char* kBaselineName = "neon";
+#elif defined(EUPHORIAE_SIMD_SSE)
+constexpr const char* kBaselineName = "sse2";
+#else
+constexpr const char* kBaselineName = "scalar";
+#endif
+
+const DspKernels kBaselineKernels = {kBaselineName, fir, spectrumMultiplyAccumulate};
+
+const DspKernels& select() {
+    const DspKernels* best = &kBaselineKernels;
+#if defined(EUPHORIAE_KERNELS_AVX2)
+    if (cpuFeatures().avx2 && cpuFeatures().fma) best = &kAvx2Kernels;
+#endif
+    LOGI("DSP kernels: %s", best->name);
+    return *best;
+}
+
+} // namespace
+
+const DspKernels& dspKernels() {
+    static const DspKernels& kernels = select();
+    return kernels;
+}
+
+int32_t supportedDspKernels(const DspKernels** kernels, int32_t maxKernels) {
+    int32_t count = 0;
+    if (count < maxKernels) kernels[count++] = &kBaselineKernels;
+#if defined(EUPHORIAE_KERNELS_AVX2)
+    if (count < maxKernels && cpuFeatures().avx2 && cpuFeatures().fma) kernels[count++] = &kAvx2Kernels;
+#endif
+    return count;
+}
+
+} // namespace euphoriae
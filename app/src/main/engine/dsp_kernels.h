@@ -0,0 +1,62 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef EUPHORIAE_DSP_KERNELS_H
+#define EUPHORIAE_DSP_KERNELS_H
+
+#include <cstdint>
+
+namespace euphoriae {
+
+/**
+ * DspKernels - Two convolution inner loops, built for more than one instruction set
+ *
+ * The library is built once per ABI, for that ABI's baseline (SSE2 on x86,
+ * NEON on ARM). Only the two loops below are also built for newer extensions:
+ * the Convolver's direct FIR head, and the spectrum multiply-accumulate of
+ * the Convolver's and BinauralRenderer's partitions. Each set lives in its own
+ * translation unit compiled with the extension's flags (AVX2 and FMA on x86:
+ * eight lanes and fused multiply-adds), and dspKernels() picks the best set
+ * the CPU supports the first time it is called. AudioEngine calls it on
+ * construction, so the probe never runs on the audio thread. The FFT passes
+ * and every other stage stay on the baseline build.
+ *
+ * ARM has only the NEON set. cpu_features.cpp probes the dot product and FP16
+ * hwcaps, but the DSP is float32 throughout and neither extension adds float32
+ * instructions, so they are reported (kernel_benchmark) and never selected on.
+ */
+struct DspKernels {
+    const char* name;
+    
+    // output[j] = sum of taps[k] * input[j + k] over k < numTaps, for j < numOutputs
+    void (*fir)(const float* taps, int32_t numTaps, const float* input, float* output, int32_t numOutputs);
+    
+    // acc += a * b over numBins complex bins in split layout
+    void (*spectrumMultiplyAccumulate)(const float* aRe, const float* aIm, const float* bRe, const float* bIm,
+                                       float* accRe, float* accIm, int32_t numBins);
+};
+
+// The set for this CPU, chosen on the first call
+const DspKernels& dspKernels();
+
+// Every set built into the library that this CPU can run, baseline first (for
+// benchmarks and checks); returns the count
+int32_t supportedDspKernels(const DspKernels** kernels, int32_t maxKernels);
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_DSP_KERNELS_H
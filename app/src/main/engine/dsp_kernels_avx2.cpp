@@ -0,0 +1,26 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+// Built with -mavx2 -mfma on x86 only; see dsp_kernels_impl.h before adding includes
+#include "dsp_kernels.h"
+#include "dsp_kernels_impl.h"
+
+namespace euphoriae {
+
+extern const DspKernels kAvx2Kernels = {"avx2+fma", fir, spectrumMultiplyAccumulate};
+
+} // namespace euphoriae
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef EUPHORIAE_DSP_KERNELS_IMPL_H
+#define EUPHORIAE_DSP_KERNELS_IMPL_H
+
+/*
+ * Bodies of the DspKernels, included by one translation unit per instruction
+ * set and compiled with that set's flags. The vector type is whatever the
+ * flags allow: eight lanes with AVX2 and FMA, simd::float4 otherwise.
+ *
+ * Everything here has internal linkage. An inline function or template the
+ * linker merges across translation units (simd.h, the standard library)
+ * could otherwise end up as the AVX2 build in baseline code, so the units
+ * built with extra flags include nothing but this file and the intrinsics.
+ */
+
+#include <cstdint>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#else
+#include "simd.h"
+#endif
+
+namespace {
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+using Vector = __m256;
+constexpr int32_t kLanes = 8;
+
+inline Vector load(const float* p) { return _mm256_loadu_ps(p); }
+inline void store(float* p, Vector v) { _mm256_storeu_ps(p, v); }
+inline Vector zero() { return _mm256_setzero_ps(); }
+inline Vector add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+// acc + a * b, acc - a * b
+inline Vector mulAdd(Vector acc, Vector a, Vector b) { return _mm256_fmadd_ps(a, b, acc); }
+inline Vector mulSub(Vector acc, Vector a, Vector b) { return _mm256_fnmadd_ps(a, b, acc); }
+inline float sum(Vector v) {
+    __m128 x = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+    x = _mm_add_ss(x, _mm_shuffle_ps(x, x, 1));
+    return _mm_cvtss_f32(x);
+}
+
+#else
+
+using Vector = euphoriae::simd::float4;
+constexpr int32_t kLanes = 4;
+
+inline Vector load(const float* p) { return euphoriae::simd::load(p); }
+inline void store(float* p, Vector v) { euphoriae::simd::store(p, v); }
+inline Vector zero() { return euphoriae::simd::set1(0.0f); }
+inline Vector add(Vector a, Vector b) { return euphoriae::simd::add(a, b); }
+inline Vector mulAdd(Vector acc, Vector a, Vector b) { return euphoriae::simd::mulAdd(acc, a, b); }
+inline Vector mulSub(Vector acc, Vector a, Vector b) { return euphoriae::simd::mulSub(acc, a, b); }
+inline float sum(Vector v) { return euphoriae::simd::sum(v); }
+
+#endif
+
+// Two accumulators, so consecutive multiply-adds do not wait on each other
+void fir(const float* taps, int32_t numTaps, const float* input, float* output, int32_t numOutputs) {
+    for (int32_t j = 0; j < numOutputs; j++) {
+        const float* x = input + j;
+        Vector acc0 = zero();
+        Vector acc1 = zero();
+        int32_t k = 0;
+        for (; k + 2 * kLanes <= numTaps; k += 2 * kLanes) {
+            acc0 = mulAdd(acc0, load(taps + k), load(x + k));
+            acc1 = mulAdd(acc1, load(taps + k + kLanes), load(x + k + kLanes));
+        }
+        float tail = 0.0f;
+        for (; k < numTaps; k++) {
+            tail += taps[k] * x[k];
+        }
+        output[j] = sum(add(acc0, acc1)) + tail;
+    }
+}
+
+void spectrumMultiplyAccumulate(const float* aRe, const float* aIm, const float* bRe, const float* bIm,
+                                float* accRe, float* accIm, int32_t numBins) {
+    int32_t k = 0;
+    for (; k + kLanes <= numBins; k += kLanes) {
+        Vector ar = load(aRe + k);
+        Vector ai = load(aIm + k);
+        Vector br = load(bRe + k);
+        Vector bi = load(bIm + k);
+        Vector cr = load(accRe + k);
+        Vector ci = load(accIm + k);
+        cr = mulSub(mulAdd(cr, ar, br), ai, bi);
+        ci = mulAdd(mulAdd(ci, ar, bi), ai, br);
+        store(accRe + k, cr);
+        store(accIm + k, ci);
+    }
+    for (; k < numBins; k++) {
+        accRe[k] += aRe[k] * bRe[k] - aIm[k] * bIm[k];
+        accIm[k] += aRe[k] * bIm[k] + aIm[k] * bRe[k];
+    }
+}
+
+} // namespace
+
+#endif // EUPHORIAE_DSP_KERNELS_IMPL_H
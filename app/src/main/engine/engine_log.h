@@ -0,0 +1,42 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef EUPHORIAE_ENGINE_LOG_H
+#define EUPHORIAE_ENGINE_LOG_H
+
+/*
+ * Engine logging: logcat on Android, stderr in host tools. Sources define
+ * LOG_TAG before including this header.
+ */
+
+#ifdef __ANDROID__
+#include <android/log.h>
+
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#else
+#include <cstdio>
+
+// Info and debug output would drown host tool output; only errors are printed
+inline void engineLogDiscard(const char*, ...) {}
+#define LOGI(...) engineLogDiscard(__VA_ARGS__)
+#define LOGD(...) engineLogDiscard(__VA_ARGS__)
+#define LOGE(...) (std::fprintf(stderr, LOG_TAG ": " __VA_ARGS__), std::fputc('\n', stderr))
+#endif
+
+#endif // EUPHORIAE_ENGINE_LOG_H
@@ -0,0 +1,433 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fft.h"
+#include "simd.h"
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace euphoriae {
+
+namespace {
+
+using simd::float4;
+
+// (ar + i*ai) * (br + i*bi)
+inline void complexMultiply(float4 ar, float4 ai, float4 br, float4 bi, float4& outRe, float4& outIm) {
+    outRe = simd::mulSub(simd::mul(ar, br), ai, bi);
+    outIm = simd::mulAdd(simd::mul(ar, bi), ai, br);
+}
+
+// Radix-4 butterfly on four inputs spaced a quarter transform apart
+struct Radix4Outputs {
+    float4 r0, i0, r1, i1, r2, i2, r3, i3;
+};
+
+inline Radix4Outputs radix4Butterfly(float4 ar, float4 ai, float4 br, float4 bi,
+                                     float4 cr, float4 ci, float4 dr, float4 di,
+                                     float4 w1r, float4 w1i, float4 w2r, float4 w2i,
+                                     float4 w3r, float4 w3i) {
+    float4 apcR = simd::add(ar, cr), apcI = simd::add(ai, ci);
+    float4 amcR = simd::sub(ar, cr), amcI = simd::sub(ai, ci);
+    float4 bpdR = simd::add(br, dr), bpdI = simd::add(bi, di);
+    float4 bmdR = simd::sub(br, dr), bmdI = simd::sub(bi, di);
+
+    Radix4Outputs out;
+    out.r0 = simd::add(apcR, bpdR);
+    out.i0 = simd::add(apcI, bpdI);
+    // (a - c) - i(b - d), (a + c) - (b + d), (a - c) + i(b - d), each twiddled
+    complexMultiply(simd::add(amcR, bmdI), simd::sub(amcI, bmdR), w1r, w1i, out.r1, out.i1);
+    complexMultiply(simd::sub(apcR, bpdR), simd::sub(apcI, bpdI), w2r, w2i, out.r2, out.i2);
+    complexMultiply(simd::sub(amcR, bmdI), simd::add(amcI, bmdR), w3r, w3i, out.r3, out.i3);
+    return out;
+}
+
+// First pass (stride 1): vectorized across p, outputs transposed on store
+void radix4First(int32_t length, const float* xr, const float* xi, float* yr, float* yi,
+                 const float* tw) {
+    const int32_t m = length / 4;
+    const float* w1r = tw;
+    const float* w1i = tw + m;
+    const float* w2r = tw + 2 * m;
+    const float* w2i = tw + 3 * m;
+    const float* w3r = tw + 4 * m;
+    const float* w3i = tw + 5 * m;
+
+    for (int32_t p = 0; p < m; p += 4) {
+        Radix4Outputs out = radix4Butterfly(
+                simd::load(xr + p), simd::load(xi + p),
+                simd::load(xr + p + m), simd::load(xi + p + m),
+                simd::load(xr + p + 2 * m), simd::load(xi + p + 2 * m),
+                simd::load(xr + p + 3 * m), simd::load(xi + p + 3 * m),
+                simd::load(w1r + p), simd::load(w1i + p),
+                simd::load(w2r + p), simd::load(w2i + p),
+                simd::load(w3r + p), simd::load(w3i + p));
+        simd::store4Interleaved(yr + 4 * p, out.r0, out.r1, out.r2, out.r3);
+        simd::store4Interleaved(yi + 4 * p, out.i0, out.i1, out.i2, out.i3);
+    }
+}
+
+// Later passes (stride >= 4): vectorized across the interleaved sub-transforms
+void radix4(int32_t length, int32_t stride, const float* xr, const float* xi,
+            float* yr, float* yi, const float* tw) {
+    const int32_t m = length / 4;
+    const int32_t s = stride;
+
+    for (int32_t p = 0; p < m; p++) {
+        float4 w1r = simd::set1(tw[p]), w1i = simd::set1(tw[m + p]);
+        float4 w2r = simd::set1(tw[2 * m + p]), w2i = simd::set1(tw[3 * m + p]);
+        float4 w3r = simd::set1(tw[4 * m + p]), w3i = simd::set1(tw[5 * m + p]);
+
+        const int32_t a = s * p, b = s * (p + m), c = s * (p + 2 * m), d = s * (p + 3 * m);
+        const int32_t y = s * 4 * p;
+        for (int32_t q = 0; q < s; q += 4) {
+            Radix4Outputs out = radix4Butterfly(
+                    simd::load(xr + a + q), simd::load(xi + a + q),
+                    simd::load(xr + b + q), simd::load(xi + b + q),
+                    simd::load(xr + c + q), simd::load(xi + c + q),
+                    simd::load(xr + d + q), simd::load(xi + d + q),
+                    w1r, w1i, w2r, w2i, w3r, w3i);
+            simd::store(yr + y + q, out.r0);
+            simd::store(yi + y + q, out.i0);
+            simd::store(yr + y + s + q, out.r1);
+            simd::store(yi + y + s + q, out.i1);
+            simd::store(yr + y + 2 * s + q, out.r2);
+            simd::store(yi + y + 2 * s + q, out.i2);
+            simd::store(yr + y + 3 * s + q, out.r3);
+            simd::store(yi + y + 3 * s + q, out.i3);
+        }
+    }
+}
+
+void radix2(int32_t length, int32_t stride, const float* xr, const float* xi,
+            float* yr, float* yi, const float* tw) {
+    const int32_t m = length / 2;
+    const int32_t s = stride;
+
+    for (int32_t p = 0; p < m; p++) {
+        float4 wr = simd::set1(tw[p]), wi = simd::set1(tw[m + p]);
+        const int32_t a = s * p, b = s * (p + m), y = s * 2 * p;
+        for (int32_t q = 0; q < s; q += 4) {
+            float4 ar = simd::load(xr + a + q), ai = simd::load(xi + a + q);
+            float4 br = simd::load(xr + b + q), bi = simd::load(xi + b + q);
+            float4 dr, di;
+            complexMultiply(simd::sub(ar, br), simd::sub(ai, bi), wr, wi, dr, di);
+            simd::store(yr + y + q, simd::add(ar, br));
+            simd::store(yi + y + q, simd::add(ai, bi));
+            simd::store(yr + y + s + q, dr);
+            simd::store(yi + y + s + q, di);
+        }
+    }
+}
+
+void deinterleave(const float* input, float* re, float* im, int32_t count) {
+    for (int32_t i = 0; i < count; i += 4) {
+        float4 even, odd;
+        simd::load2Deinterleaved(input + 2 * i, even, odd);
+        simd::store(re + i, even);
+        simd::store(im + i, odd);
+    }
+}
+
+void interleave(const float* re, const float* im, float* output, int32_t count) {
+    for (int32_t i = 0; i < count; i += 4) {
+        simd::store2Interleaved(output + 2 * i, simd::load(re + i), simd::load(im + i));
+    }
+}
+
+} // namespace
+
+std::shared_ptr<const FftPlan> FftPlan::get(int32_t size) {
+    if (size < kMinSize || size > kMaxSize || (size & (size - 1)) != 0) return nullptr;
+
+    static std::mutex cacheMutex;
+    static std::map<int32_t, std::weak_ptr<const FftPlan>> cache;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::weak_ptr<const FftPlan>& slot = cache[size];
+    std::shared_ptr<const FftPlan> plan = slot.lock();
+    if (!plan) {
+        plan = std::make_shared<const FftPlan>(size);
+        slot = plan;
+    }
+    return plan;
+}
+
+FftPlan::FftPlan(int32_t size) : mSize(size), mHalf(size / 2) {
+    int32_t log2Half = 0;
+    while ((1 << log2Half) < mHalf) log2Half++;
+
+    // Prefer radix-4; trade one radix-4 pass for two radix-2 passes when needed to
+    // make the pass count even. Radix-2 passes run last, where the stride is >= 4.
+    int32_t radix4Passes = log2Half / 2;
+    int32_t radix2Passes = log2Half % 2;
+    if ((radix4Passes + radix2Passes) % 2 != 0) {
+        radix4Passes--;
+        radix2Passes += 2;
+    }
+
+    // Twiddles are computed in double precision so large sizes stay accurate
+    auto addTwiddles = [this](int32_t length, int32_t count, int32_t power) {
+        size_t offset = mTwiddles.size();
+        mTwiddles.resize(offset + 2 * count);
+        for (int32_t p = 0; p < count; p++) {
+            double phase = -2.0 * M_PI * power * p / length;
+            mTwiddles[offset + p] = static_cast<float>(std::cos(phase));
+            mTwiddles[offset + count + p] = static_cast<float>(std::sin(phase));
+        }
+    };
+
+    int32_t length = mHalf;
+    int32_t stride = 1;
+    for (int32_t i = 0; i < radix4Passes; i++) {
+        mStages.push_back({4, length, stride, static_cast<int32_t>(mTwiddles.size())});
+        for (int32_t power = 1; power <= 3; power++) {
+            addTwiddles(length, length / 4, power);
+        }
+        length /= 4;
+        stride *= 4;
+    }
+    for (int32_t i = 0; i < radix2Passes; i++) {
+        mStages.push_back({2, length, stride, static_cast<int32_t>(mTwiddles.size())});
+        addTwiddles(length, length / 2, 1);
+        length /= 2;
+        stride *= 2;
+    }
+
+    mRealTwiddleRe.resize(mHalf / 2);
+    mRealTwiddleIm.resize(mHalf / 2);
+    for (int32_t k = 0; k < mHalf / 2; k++) {
+        double phase = -2.0 * M_PI * k / mSize;
+        mRealTwiddleRe[k] = static_cast<float>(std::cos(phase));
+        mRealTwiddleIm[k] = static_cast<float>(std::sin(phase));
+    }
+}
+
+void FftPlan::transform(float* re, float* im, float* scratchRe, float* scratchIm) const {
+    float* srcRe = re;
+    float* srcIm = im;
+    float* dstRe = scratchRe;
+    float* dstIm = scratchIm;
+
+    for (const Stage& stage : mStages) {
+        const float* tw = mTwiddles.data() + stage.twiddles;
+        if (stage.radix == 2) {
+            radix2(stage.length, stage.stride, srcRe, srcIm, dstRe, dstIm, tw);
+        } else if (stage.stride == 1) {
+            radix4First(stage.length, srcRe, srcIm, dstRe, dstIm, tw);
+        } else {
+            radix4(stage.length, stage.stride, srcRe, srcIm, dstRe, dstIm, tw);
+        }
+        std::swap(srcRe, dstRe);
+        std::swap(srcIm, dstIm);
+    }
+}
+
+template <bool kPacked>
+void FftPlan::splitSpectrum(const float* zRe, const float* zIm, float* outRe, float* outIm) const {
+    // With Z the half-size FFT of (even + i * odd) samples, bins k and half - k come
+    // from the same pair: X[k] = E + T, X[half - k] = conj(E - T), T = W^k * O
+    const int32_t half = mHalf;
+    const int32_t quarter = mHalf / 2;
+    const float4 oneHalf = simd::set1(0.5f);
+
+    auto store = [&](int32_t k, float4 re, float4 im) {
+        if (kPacked) {
+            simd::store2Interleaved(outRe + 2 * k, re, im);
+        } else {
+            simd::store(outRe + k, re);
+            simd::store(outIm + k, im);
+        }
+    };
+
+    int32_t k = 1;
+    for (; k + 4 <= quarter; k += 4) {
+        int32_t mirror = half - k - 3;
+        float4 ar = simd::load(zRe + k), ai = simd::load(zIm + k);
+        float4 br = simd::reverse(simd::load(zRe + mirror));
+        float4 bi = simd::reverse(simd::load(zIm + mirror));
+
+        float4 er = simd::mul(oneHalf, simd::add(ar, br));
+        float4 ei = simd::mul(oneHalf, simd::sub(ai, bi));
+        float4 or_ = simd::mul(oneHalf, simd::add(ai, bi));
+        float4 oi = simd::mul(oneHalf, simd::sub(br, ar));
+
+        float4 tr, ti;
+        complexMultiply(or_, oi, simd::load(mRealTwiddleRe.data() + k),
+                        simd::load(mRealTwiddleIm.data() + k), tr, ti);
+
+        store(k, simd::add(er, tr), simd::add(ei, ti));
+        store(mirror, simd::reverse(simd::sub(er, tr)), simd::reverse(simd::sub(ti, ei)));
+    }
+    for (; k < quarter; k++) {
+        float ar = zRe[k], ai = zIm[k];
+        float br = zRe[half - k], bi = zIm[half - k];
+        float er = 0.5f * (ar + br), ei = 0.5f * (ai - bi);
+        float or_ = 0.5f * (ai + bi), oi = 0.5f * (br - ar);
+        float wr = mRealTwiddleRe[k], wi = mRealTwiddleIm[k];
+        float tr = or_ * wr - oi * wi;
+        float ti = or_ * wi + oi * wr;
+        if (kPacked) {
+            outRe[2 * k] = er + tr;
+            outRe[2 * k + 1] = ei + ti;
+            outRe[2 * (half - k)] = er - tr;
+            outRe[2 * (half - k) + 1] = ti - ei;
+        } else {
+            outRe[k] = er + tr;
+            outIm[k] = ei + ti;
+            outRe[half - k] = er - tr;
+            outIm[half - k] = ti - ei;
+        }
+    }
+
+    // DC and Nyquist are purely real; the quarter bin is conj(Z)
+    float dc = zRe[0] + zIm[0];
+    float nyquist = zRe[0] - zIm[0];
+    if (kPacked) {
+        outRe[0] = dc;
+        outRe[1] = nyquist;
+        outRe[2 * quarter] = zRe[quarter];
+        outRe[2 * quarter + 1] = -zIm[quarter];
+    } else {
+        outRe[0] = dc;
+        outIm[0] = 0.0f;
+        outRe[half] = nyquist;
+        outIm[half] = 0.0f;
+        outRe[quarter] = zRe[quarter];
+        outIm[quarter] = -zIm[quarter];
+    }
+}
+
+template <bool kPacked>
+void FftPlan::mergeSpectrum(const float* inRe, const float* inIm, float* zRe, float* zIm) const {
+    // Inverse of splitSpectrum, with the 1/size normalization folded in:
+    // Z[k] = E + i*O, Z[half - k] = conj(E) + i*conj(O)
+    const int32_t half = mHalf;
+    const int32_t quarter = mHalf / 2;
+    const float scale = 1.0f / static_cast<float>(mSize);
+    const float4 scale4 = simd::set1(scale);
+
+    auto load = [&](int32_t k, float4& re, float4& im) {
+        if (kPacked) {
+            simd::load2Deinterleaved(inRe + 2 * k, re, im);
+        } else {
+            re = simd::load(inRe + k);
+            im = simd::load(inIm + k);
+        }
+    };
+
+    int32_t k = 1;
+    for (; k + 4 <= quarter; k += 4) {
+        int32_t mirror = half - k - 3;
+        float4 ar, ai, br, bi;
+        load(k, ar, ai);
+        load(mirror, br, bi);
+        br = simd::reverse(br);
+        bi = simd::reverse(bi);
+
+        float4 er = simd::add(ar, br), ei = simd::sub(ai, bi);
+        float4 dr = simd::sub(ar, br), di = simd::add(ai, bi);
+        float4 wr = simd::load(mRealTwiddleRe.data() + k);
+        float4 wi = simd::load(mRealTwiddleIm.data() + k);
+        // O = D * conj(W^k)
+        float4 or_ = simd::mulAdd(simd::mul(dr, wr), di, wi);
+        float4 oi = simd::mulSub(simd::mul(di, wr), dr, wi);
+
+        simd::store(zRe + k, simd::mul(scale4, simd::sub(er, oi)));
+        simd::store(zIm + k, simd::mul(scale4, simd::add(ei, or_)));
+        simd::store(zRe + mirror, simd::reverse(simd::mul(scale4, simd::add(er, oi))));
+        simd::store(zIm + mirror, simd::reverse(simd::mul(scale4, simd::sub(or_, ei))));
+    }
+    for (; k < quarter; k++) {
+        float ar, ai, br, bi;
+        if (kPacked) {
+            ar = inRe[2 * k];
+            ai = inRe[2 * k + 1];
+            br = inRe[2 * (half - k)];
+            bi = inRe[2 * (half - k) + 1];
+        } else {
+            ar = inRe[k];
+            ai = inIm[k];
+            br = inRe[half - k];
+            bi = inIm[half - k];
+        }
+        float er = ar + br, ei = ai - bi;
+        float dr = ar - br, di = ai + bi;
+        float wr = mRealTwiddleRe[k], wi = mRealTwiddleIm[k];
+        float or_ = dr * wr + di * wi;
+        float oi = di * wr - dr * wi;
+        zRe[k] = scale * (er - oi);
+        zIm[k] = scale * (ei + or_);
+        zRe[half - k] = scale * (er + oi);
+        zIm[half - k] = scale * (or_ - ei);
+    }
+
+    float dc, nyquist, quarterRe, quarterIm;
+    if (kPacked) {
+        dc = inRe[0];
+        nyquist = inRe[1];
+        quarterRe = inRe[2 * quarter];
+        quarterIm = inRe[2 * quarter + 1];
+    } else {
+        dc = inRe[0];
+        nyquist = inRe[half];
+        quarterRe = inRe[quarter];
+        quarterIm = inIm[quarter];
+    }
+    zRe[0] = scale * (dc + nyquist);
+    zIm[0] = scale * (dc - nyquist);
+    zRe[quarter] = 2.0f * scale * quarterRe;
+    zIm[quarter] = -2.0f * scale * quarterIm;
+}
+
+void FftPlan::forward(const float* input, float* re, float* im, float* work) const {
+    float* workRe = work;
+    float* workIm = work + mHalf;
+    deinterleave(input, workRe, workIm, mHalf);
+    transform(workRe, workIm, re, im);
+    splitSpectrum<false>(workRe, workIm, re, im);
+}
+
+void FftPlan::inverse(const float* re, const float* im, float* output, float* work) const {
+    float* workRe = work;
+    float* workIm = work + mHalf;
+    mergeSpectrum<false>(re, im, workRe, workIm);
+    // Swapping real and imaginary parts turns the forward transform into the inverse
+    transform(workIm, workRe, output + mHalf, output);
+    interleave(workRe, workIm, output, mHalf);
+}
+
+void FftPlan::forwardInPlace(float* data, float* work) const {
+    float* workRe = work;
+    float* workIm = work + mHalf;
+    deinterleave(data, workRe, workIm, mHalf);
+    transform(workRe, workIm, data, data + mHalf);
+    splitSpectrum<true>(workRe, workIm, data, nullptr);
+}
+
+void FftPlan::inverseInPlace(float* data, float* work) const {
+    float* workRe = work;
+    float* workIm = work + mHalf;
+    mergeSpectrum<true>(data, nullptr, workRe, workIm);
+    transform(workIm, workRe, data + mHalf, data);
+    interleave(workRe, workIm, data, mHalf);
+}
+
+RealFft::RealFft(int32_t size) : mPlan(FftPlan::get(size)), mWork(size) {}
+
+} // namespace euphoriae
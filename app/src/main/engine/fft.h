@@ -0,0 +1,119 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EUPHORIAE_FFT_H
+#define EUPHORIAE_FFT_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace euphoriae {
+
+/**
+ * FftPlan - Precomputed tables for a real FFT of one power-of-two size
+ *
+ * The real transform runs as a half-size complex FFT built from radix-4
+ * Stockham passes (plus radix-2 passes where log2 is odd), followed by a
+ * split pass that separates the even/odd spectra. Stockham ordering needs
+ * no bit reversal and keeps every pass a contiguous 4-wide NEON/SSE loop.
+ *
+ * Plans are immutable. Transforms take a caller-owned work buffer of
+ * workSize() floats, so one plan can serve several threads at once.
+ *
+ * Spectrum layouts:
+ *  - split:  re[numBins], im[numBins]
+ *  - packed: data[0] = DC, data[1] = Nyquist, data[2k], data[2k + 1] = bin k
+ * Inverse transforms are scaled so that inverse(forward(x)) == x.
+ */
+class FftPlan {
+public:
+    static constexpr int32_t kMinSize = 64;
+    static constexpr int32_t kMaxSize = 65536;
+
+    // Shared plan for a power-of-two size in [kMinSize, kMaxSize], nullptr otherwise.
+    // Builds tables on first use of a size, so call it off the audio thread.
+    static std::shared_ptr<const FftPlan> get(int32_t size);
+
+    explicit FftPlan(int32_t size);
+
+    int32_t size() const { return mSize; }
+    int32_t numBins() const { return mHalf + 1; }
+    int32_t workSize() const { return mSize; }
+
+    // Out of place: input[size] -> split spectrum
+    void forward(const float* input, float* re, float* im, float* work) const;
+    void inverse(const float* re, const float* im, float* output, float* work) const;
+
+    // In place: data[size] holds samples before and a packed spectrum after
+    void forwardInPlace(float* data, float* work) const;
+    void inverseInPlace(float* data, float* work) const;
+
+private:
+    struct Stage {
+        int32_t radix;
+        int32_t length;    // Sub-transform length at this pass
+        int32_t stride;    // Distance between interleaved sub-transforms
+        int32_t twiddles;  // Offset of this pass in mTwiddles
+    };
+
+    // Complex FFT of length mHalf on split data. Passes alternate between (re, im)
+    // and the scratch pair; the stage count is always even so the result lands in (re, im).
+    void transform(float* re, float* im, float* scratchRe, float* scratchIm) const;
+
+    template <bool kPacked>
+    void splitSpectrum(const float* zRe, const float* zIm, float* outRe, float* outIm) const;
+
+    template <bool kPacked>
+    void mergeSpectrum(const float* inRe, const float* inIm, float* zRe, float* zIm) const;
+
+    int32_t mSize;
+    int32_t mHalf;
+    std::vector<Stage> mStages;
+    std::vector<float> mTwiddles;       // Per pass: radix - 1 twiddle vectors, split re/im
+    std::vector<float> mRealTwiddleRe;  // e^(-2*pi*i*k / size), k <= half / 2
+    std::vector<float> mRealTwiddleIm;
+};
+
+/**
+ * RealFft - An FftPlan bundled with its own work buffer
+ *
+ * Convenient for single-threaded owners. Not thread-safe; create one per thread.
+ */
+class RealFft {
+public:
+    explicit RealFft(int32_t size);
+
+    int32_t size() const { return mPlan->size(); }
+    int32_t numBins() const { return mPlan->numBins(); }
+
+    void forward(const float* input, float* re, float* im) {
+        mPlan->forward(input, re, im, mWork.data());
+    }
+    void inverse(const float* re, const float* im, float* output) {
+        mPlan->inverse(re, im, output, mWork.data());
+    }
+    void forwardInPlace(float* data) { mPlan->forwardInPlace(data, mWork.data()); }
+    void inverseInPlace(float* data) { mPlan->inverseInPlace(data, mWork.data()); }
+
+private:
+    std::shared_ptr<const FftPlan> mPlan;
+    std::vector<float> mWork;
+};
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_FFT_H
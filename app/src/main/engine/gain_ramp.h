@@ -0,0 +1,209 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef EUPHORIAE_GAIN_RAMP_H
+#define EUPHORIAE_GAIN_RAMP_H
+
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace euphoriae {
+
+enum class RampCurve : int32_t {
+    kLinear = 0,
+    kExponential = 1,  // Constant dB per frame
+};
+
+/**
+ * GainRamp - A gain (or any coefficient) that moves to a target over a number of frames
+ *
+ * Linear ramps add a fixed step per frame, exponential ramps multiply by a
+ * fixed ratio, so a fade sounds even in dB. An exponential ramp cannot reach
+ * zero: it runs from or to kFloor (-80 dB) and snaps to zero at the end.
+ * follow() turns it into a smoothed parameter: each new target starts a ramp
+ * from wherever the value is, so a slider never steps the signal.
+ *
+ * The per-frame gains come from a vector recurrence (four frames per step,
+ * restarted from the double-precision value every kChunkFrames), so there is
+ * no transcendental per sample. A settled ramp is a constant gain, and a
+ * settled unity gain costs nothing.
+ */
+class GainRamp {
+public:
+    static constexpr float kFloor = 1e-4f;
+    
+    // Most frames render() fills at a time
+    static constexpr int32_t kChunkFrames = 64;
+
+    explicit GainRamp(float value = 1.0f) { set(value); }
+
+    // Jump to value, ending any ramp
+    void set(float value) {
+        mValue = value;
+        mTarget = value;
+        mRemaining = 0;
+    }
+
+    // Ramp from the current value; frames <= 0 jumps
+    void start(float target, int64_t frames, RampCurve curve) {
+        if (frames <= 0) {
+            set(target);
+            return;
+        }
+        mTarget = target;
+        mRemaining = frames;
+        mCurve = curve;
+        if (curve == RampCurve::kExponential) {
+            const double from = std::max(mValue, static_cast<double>(kFloor));
+            const double to = std::max(target, kFloor);
+            mValue = from;
+            mStep = std::pow(to / from, 1.0 / static_cast<double>(frames));
+        } else {
+            mStep = (target - mValue) / static_cast<double>(frames);
+        }
+    }
+
+    // Smoothing: ramp to target whenever it differs from the current one
+    void follow(float target, int64_t frames, RampCurve curve = RampCurve::kLinear) {
+        if (target != mTarget) start(target, frames, curve);
+    }
+
+    bool isSettled() const { return mRemaining == 0; }
+    float value() const { return static_cast<float>(mValue); }
+    float target() const { return mTarget; }
+
+    // Moves the ramp on without touching audio; true when it ended in these frames
+    bool advance(int64_t numFrames) {
+        if (mRemaining == 0) return false;
+        const int64_t count = std::min(numFrames, mRemaining);
+        if (mCurve == RampCurve::kExponential) {
+            mValue *= std::pow(mStep, static_cast<double>(count));
+        } else {
+            mValue += mStep * static_cast<double>(count);
+        }
+        mRemaining -= count;
+        if (mRemaining > 0) return false;
+        mValue = mTarget;
+        return true;
+    }
+
+    // Multiplies interleaved frames by the ramp and advances it; true when the
+    // ramp ended in these frames. kChannels 1 and 2 are vectorized across frames,
+    // 0 takes channelCount.
+    template <int kChannels>
+    bool apply(float* buffer, int32_t numFrames, int32_t channelCount) {
+        const int32_t channels = kChannels > 0 ? kChannels : channelCount;
+        bool ended = false;
+        int32_t frame = 0;
+        while (mRemaining > 0 && frame < numFrames) {
+            const int32_t count = static_cast<int32_t>(std::min<int64_t>(
+                std::min(numFrames - frame, kChunkFrames), mRemaining));
+            alignas(16) float gains[kChunkFrames];
+            fillGains(gains, count);
+            scaleFrames<kChannels>(buffer + static_cast<int64_t>(frame) * channels, gains, count, channels);
+            ended = advance(count);
+            frame += count;
+        }
+        if (frame < numFrames && mValue != 1.0) {
+            scaleConstant(buffer + static_cast<int64_t>(frame) * channels,
+                          (numFrames - frame) * channels, static_cast<float>(mValue));
+        }
+        return ended;
+    }
+
+    // Per-frame values of the next count frames (at most kChunkFrames, values
+    // rounded up to a multiple of 4), advancing the ramp
+    void render(float* values, int32_t count) {
+        fillGains(values, count);
+        advance(count);
+    }
+
+private:
+    // Gains of the next count frames, from the current value (not advanced);
+    // frames past the end of the ramp hold the target
+    void fillGains(float* gains, int32_t count) const {
+        const int32_t ramped = static_cast<int32_t>(std::min<int64_t>(count, mRemaining));
+        const float v = static_cast<float>(mValue);
+        simd::float4 lanes;
+        simd::float4 step4;
+        if (mCurve == RampCurve::kExponential) {
+            const float r = static_cast<float>(mStep);
+            alignas(16) const float init[4] = {v, v * r, v * r * r, v * r * r * r};
+            lanes = simd::load(init);
+            step4 = simd::set1(r * r * r * r);
+            for (int32_t i = 0; i < ramped; i += 4) {
+                simd::store(gains + i, lanes);
+                lanes = simd::mul(lanes, step4);
+            }
+        } else {
+            const float s = static_cast<float>(mStep);
+            alignas(16) const float init[4] = {v, v + s, v + 2.0f * s, v + 3.0f * s};
+            lanes = simd::load(init);
+            step4 = simd::set1(4.0f * s);
+            for (int32_t i = 0; i < ramped; i += 4) {
+                simd::store(gains + i, lanes);
+                lanes = simd::add(lanes, step4);
+            }
+        }
+        std::fill(gains + ramped, gains + count, mTarget);
+    }
+
+    template <int kChannels>
+    static void scaleFrames(float* buffer, const float* gains, int32_t numFrames, int32_t channels) {
+        int32_t i = 0;
+        if (kChannels == 1) {
+            for (; i + 4 <= numFrames; i += 4) {
+                simd::store(buffer + i, simd::mul(simd::load(buffer + i), simd::load(gains + i)));
+            }
+        } else if (kChannels == 2) {
+            for (; i + 4 <= numFrames; i += 4) {
+                simd::float4 left, right;
+                simd::load2Deinterleaved(buffer + i * 2, left, right);
+                const simd::float4 g = simd::load(gains + i);
+                simd::store2Interleaved(buffer + i * 2, simd::mul(left, g), simd::mul(right, g));
+            }
+        }
+        for (; i < numFrames; i++) {
+            for (int32_t ch = 0; ch < channels; ch++) {
+                buffer[i * channels + ch] *= gains[i];
+            }
+        }
+    }
+
+    static void scaleConstant(float* buffer, int32_t numSamples, float gain) {
+        const simd::float4 g = simd::set1(gain);
+        int32_t i = 0;
+        for (; i + 4 <= numSamples; i += 4) {
+            simd::store(buffer + i, simd::mul(simd::load(buffer + i), g));
+        }
+        for (; i < numSamples; i++) {
+            buffer[i] *= gain;
+        }
+    }
+
+    double mValue = 1.0;
+    double mStep = 0.0;  // Per frame: increment (linear) or ratio (exponential)
+    float mTarget = 1.0f;
+    int64_t mRemaining = 0;
+    RampCurve mCurve = RampCurve::kLinear;
+};
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_GAIN_RAMP_H
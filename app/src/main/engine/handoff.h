@@ -0,0 +1,78 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EUPHORIAE_HANDOFF_H
+#define EUPHORIAE_HANDOFF_H
+
+#include <atomic>
+#include <mutex>
+
+namespace euphoriae {
+
+/**
+ * Handoff - Passes heap objects built on a control thread to the audio thread
+ *
+ * publish() queues a new instance; acquire() on the audio thread swaps it in
+ * and parks the replaced instance, which the next publish() frees. The audio
+ * thread never allocates or frees. acquire() only swaps while the retired slot
+ * is empty, and publish() drains it after queueing, so once publishers are idle
+ * a pending instance never waits on an occupied slot.
+ */
+template <typename T>
+class Handoff {
+public:
+    Handoff() = default;
+    Handoff(const Handoff&) = delete;
+    Handoff& operator=(const Handoff&) = delete;
+
+    // Only safe once the audio thread has stopped
+    ~Handoff() {
+        delete mCurrent;
+        delete mPending.exchange(nullptr);
+        delete mRetired.exchange(nullptr);
+    }
+
+    // Any thread: takes ownership of object, which must not be nullptr
+    void publish(T* object) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        // An instance the audio thread never picked up can be freed right away
+        delete mPending.exchange(object);
+        // After queueing, so a park that raced this call is freed too
+        delete mRetired.exchange(nullptr);
+    }
+
+    // Audio thread: current instance (may be nullptr), swapping in a pending one first
+    T* acquire() {
+        // Plain load first: no read-modify-write, so the line stays shared, on every block
+        if (mPending.load(std::memory_order_relaxed) == nullptr) return mCurrent;
+        // Parking over an instance nobody has freed yet would leak it
+        T* empty = nullptr;
+        if (!mRetired.compare_exchange_strong(empty, mCurrent)) return mCurrent;
+        // Only this thread clears the pending slot, so it still holds an instance
+        mCurrent = mPending.exchange(nullptr);
+        return mCurrent;
+    }
+
+private:
+    T* mCurrent = nullptr;  // Audio thread only
+    std::atomic<T*> mPending{nullptr};
+    std::atomic<T*> mRetired{nullptr};
+    std::mutex mMutex;      // Serializes publishers
+};
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_HANDOFF_H
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hrir_set.h"
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace euphoriae {
+
+namespace {
+
+struct HrirHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t sampleRate;
+    uint32_t irLength;
+    uint32_t numDirections;
+};
+
+constexpr uint32_t kHrirVersion = 1;
+
+} // namespace
+
+std::unique_ptr<HrirSet> HrirSet::open(const char* path) {
+    if (path == nullptr) return nullptr;
+
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+
+    struct stat info {};
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(HrirHeader))) {
+        close(fd);
+        return nullptr;
+    }
+    size_t fileSize = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // The mapping keeps the file referenced
+    if (mapping == MAP_FAILED) return nullptr;
+
+    std::unique_ptr<HrirSet> set(new HrirSet());
+    set->mMapping = mapping;
+    set->mMappingSize = fileSize;
+
+    HrirHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+    if (std::memcmp(header.magic, "EHIR", 4) != 0 || header.version != kHrirVersion) return nullptr;
+    if (header.irLength == 0 || header.irLength > kMaxIrLength) return nullptr;
+    if (header.numDirections == 0 || header.numDirections > kMaxDirections) return nullptr;
+    if (header.sampleRate < kMinSampleRate || header.sampleRate > kMaxSampleRate) return nullptr;
+
+    size_t recordBytes = (2 + 2 * static_cast<size_t>(header.irLength)) * sizeof(float);
+    if (sizeof(HrirHeader) + recordBytes * header.numDirections > fileSize) return nullptr;
+
+    set->mRecords = reinterpret_cast<const float*>(static_cast<const uint8_t*>(mapping) + sizeof(HrirHeader));
+    set->mSampleRate = static_cast<int32_t>(header.sampleRate);
+    set->mIrLength = static_cast<int32_t>(header.irLength);
+    set->mNumDirections = static_cast<int32_t>(header.numDirections);
+    return set;
+}
+
+HrirSet::~HrirSet() {
+    if (mMapping != nullptr) munmap(mMapping, mMappingSize);
+}
+
+int32_t HrirSet::nearest(float azimuth, float elevation) const {
+    constexpr float kDegToRad = static_cast<float>(M_PI / 180.0);
+    const float az = azimuth * kDegToRad;
+    const float el = elevation * kDegToRad;
+    const float x = std::cos(el) * std::cos(az);
+    const float y = std::cos(el) * std::sin(az);
+    const float z = std::sin(el);
+
+    // Largest dot product = smallest angle
+    int32_t best = 0;
+    float bestDot = -2.0f;
+    for (int32_t i = 0; i < mNumDirections; i++) {
+        const float* r = record(i);
+        float rAz = r[0] * kDegToRad;
+        float rEl = r[1] * kDegToRad;
+        float dot = x * std::cos(rEl) * std::cos(rAz) + y * std::cos(rEl) * std::sin(rAz) + z * std::sin(rEl);
+        if (dot > bestDot) {
+            bestDot = dot;
+            best = i;
+        }
+    }
+    return best;
+}
+
+} // namespace euphoriae
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EUPHORIAE_HRIR_SET_H
+#define EUPHORIAE_HRIR_SET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace euphoriae {
+
+/**
+ * HrirSet - Memory-mapped set of head-related impulse responses
+ *
+ * File layout (little-endian, "EHIR" version 1):
+ *   char[4]  magic "EHIR"
+ *   uint32   version
+ *   uint32   sampleRate     kMinSampleRate to kMaxSampleRate
+ *   uint32   irLength       taps per ear
+ *   uint32   numDirections
+ *   numDirections records of:
+ *     float  azimuth        degrees, 0 = front, positive = right
+ *     float  elevation      degrees, positive = up
+ *     float  left[irLength]
+ *     float  right[irLength]
+ *
+ * The file is mapped read-only and never copied; pages are loaded on demand.
+ */
+class HrirSet {
+public:
+    static constexpr int32_t kMaxIrLength = 1024;
+    static constexpr int32_t kMaxDirections = 16384;
+    // Resampling to the engine rate stretches the HRIRs by the ratio of the two,
+    // so an absurd rate in the header would size the renderer without bound
+    static constexpr int32_t kMinSampleRate = 8000;
+    static constexpr int32_t kMaxSampleRate = 384000;
+
+    // nullptr if the file is missing or malformed
+    static std::unique_ptr<HrirSet> open(const char* path);
+
+    ~HrirSet();
+    HrirSet(const HrirSet&) = delete;
+    HrirSet& operator=(const HrirSet&) = delete;
+
+    int32_t sampleRate() const { return mSampleRate; }
+    int32_t irLength() const { return mIrLength; }
+    int32_t numDirections() const { return mNumDirections; }
+
+    // Index of the measured direction closest to (azimuth, elevation) on the sphere
+    int32_t nearest(float azimuth, float elevation) const;
+
+    const float* left(int32_t direction) const { return record(direction) + 2; }
+    const float* right(int32_t direction) const { return record(direction) + 2 + mIrLength; }
+
+private:
+    HrirSet() = default;
+
+    const float* record(int32_t direction) const {
+        return mRecords + static_cast<size_t>(direction) * (2 + 2 * mIrLength);
+    }
+
+    void* mMapping = nullptr;
+    size_t mMappingSize = 0;
+    const float* mRecords = nullptr;
+    int32_t mSampleRate = 0;
+    int32_t mIrLength = 0;
+    int32_t mNumDirections = 0;
+};
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_HRIR_SET_H
@@ -14,13 +14,26 @@
  * limitations under the License.
  */
 
+#define LOG_TAG "EuphoriaeAudio"
+
 #include <jni.h>
 #include "audio_engine.h"
+#include "engine_log.h"
+#include "jni_checks.h"
+#include "loudness_scanner.h"
+#include "media_decoder.h"
+#include "offline_renderer.h"
+#include "pcm_file.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
 #include <memory>
-#include <android/log.h>
-
-#define LOG_TAG "EuphoriaeAudio"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 static std::unique_ptr<euphoriae::AudioEngine> sEngine;
 
@@ -50,6 +63,7 @@ Java_com_oss_euphoriae_engine_AudioEngine_nativeProcessAudio(
         jint numFrames, 
         jint channelCount) {
     if (!sEngine || audioBuffer == nullptr) return;
+    if (!euphoriae::holdsFrames(env->GetArrayLength(audioBuffer), numFrames, channelCount)) return;
     
     jfloat* buffer = env->GetFloatArrayElements(audioBuffer, nullptr);
     if (buffer == nullptr) return;
@@ -59,6 +73,76 @@ Java_com_oss_euphoriae_engine_AudioEngine_nativeProcessAudio(
     env->ReleaseFloatArrayElements(audioBuffer, buffer, 0);
 }
 
+JNIEXPORT void JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeProcessAudioMixed(
+        JNIEnv *env,
+        jobject thiz,
+        jfloatArray inputBuffer,
+        jint inputChannels,
+        jfloatArray outputBuffer,
+        jint outputChannels,
+        jint numFrames) {
+    if (!sEngine || inputBuffer == nullptr || outputBuffer == nullptr) return;
+    if (!euphoriae::holdsFrames(env->GetArrayLength(inputBuffer), numFrames, inputChannels)) return;
+    if (!euphoriae::holdsFrames(env->GetArrayLength(outputBuffer), numFrames, outputChannels)) return;
+    
+    jfloat* input = env->GetFloatArrayElements(inputBuffer, nullptr);
+    if (input == nullptr) return;
+    jfloat* output = env->GetFloatArrayElements(outputBuffer, nullptr);
+    if (output == nullptr) {
+        env->ReleaseFloatArrayElements(inputBuffer, input, JNI_ABORT);
+        return;
+    }
+    
+    sEngine->processAudio(input, inputChannels, output, outputChannels, numFrames);
+    
+    env->ReleaseFloatArrayElements(outputBuffer, output, 0);
+    env->ReleaseFloatArrayElements(inputBuffer, input, JNI_ABORT);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeGetOutputChannelCount(JNIEnv *env, jobject thiz, jint inputChannels) {
+    return sEngine ? sEngine->outputChannelCount(inputChannels) : inputChannels;
+}
+
+JNIEXPORT void JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeConfigure(JNIEnv *env, jobject thiz, jint sampleRate, jint channelCount) {
+    if (sEngine) sEngine->configure(sampleRate, channelCount);
+}
+
+JNIEXPORT void JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeReset(JNIEnv *env, jobject thiz) {
+    if (sEngine) sEngine->reset();
+}
+
+// ================== Automation ==================
+
+JNIEXPORT jboolean JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeScheduleRamp(JNIEnv *env, jobject thiz, jint parameter, jfloat target,
+                                                             jlong startFrame, jlong durationFrames,
+                                                             jboolean exponential) {
+    if (!sEngine) return JNI_FALSE;
+    euphoriae::RampCurve curve = exponential ? euphoriae::RampCurve::kExponential : euphoriae::RampCurve::kLinear;
+    return sEngine->scheduleRamp(parameter, target, startFrame, durationFrames, curve) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeGetFramePosition(JNIEnv *env, jobject thiz) {
+    return sEngine ? sEngine->getFramePosition() : 0;
+}
+
+// ================== Chain Order ==================
+
+JNIEXPORT jboolean JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeSetStageOrder(JNIEnv *env, jobject thiz, jintArray stageOrder) {
+    if (!sEngine || stageOrder == nullptr) return JNI_FALSE;
+    jint order[euphoriae::AudioEngine::kNumChainStages];
+    const jsize count = env->GetArrayLength(stageOrder);
+    if (count != euphoriae::AudioEngine::kNumChainStages) return JNI_FALSE;
+    env->GetIntArrayRegion(stageOrder, 0, count, order);
+    return sEngine->setStageOrder(order, count) ? JNI_TRUE : JNI_FALSE;
+}
+
 // ================== Basic Effects ==================
 
 JNIEXPORT void JNICALL
@@ -71,6 +155,16 @@ Java_com_oss_euphoriae_engine_AudioEngine_nativeSetBassBoost(JNIEnv *env, jobjec
     if (sEngine) sEngine->setBassBoost(strength);
 }
 
+JNIEXPORT void JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeSetBassFrequency(JNIEnv *env, jobject thiz, jfloat hz) {
+    if (sEngine) sEngine->setBassFrequency(hz);
+}
+
+JNIEXPORT void JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeSetBassMode(JNIEnv *env, jobject thiz, jint mode) {
+    if (sEngine) sEngine->setBassMode(mode);
+}
+
 JNIEXPORT void JNICALL
 Java_com_oss_euphoriae_engine_AudioEngine_nativeSetVirtualizer(JNIEnv *env, jobject thiz, jfloat strength) {
     if (sEngine) sEngine->setVirtualizer(strength);
@@ -123,6 +217,19 @@ Java_com_oss_euphoriae_engine_AudioEngine_nativeSetHeadphoneType(JNIEnv *env, jo
     if (sEngine) sEngine->setHeadphoneType(type);
 }
 
+JNIEXPORT jboolean JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeLoadHrirSet(JNIEnv *env, jobject thiz, jstring path) {
+    if (!sEngine || path == nullptr) return JNI_FALSE;
+    
+    const char* pathChars = env->GetStringUTFChars(path, nullptr);
+    if (pathChars == nullptr) return JNI_FALSE;
+    
+    bool loaded = sEngine->loadHrirSet(pathChars);
+    
+    env->ReleaseStringUTFChars(path, pathChars);
+    return loaded ? JNI_TRUE : JNI_FALSE;
+}
+
 JNIEXPORT void JNICALL
 Java_com_oss_euphoriae_engine_AudioEngine_nativeSetClarity(JNIEnv *env, jobject thiz, jfloat level) {
     if (sEngine) sEngine->setClarity(level);
@@ -148,6 +255,16 @@ Java_com_oss_euphoriae_engine_AudioEngine_nativeSetVolumeLeveler(JNIEnv *env, jo
     if (sEngine) sEngine->setVolumeLeveler(level);
 }
 
+JNIEXPORT void JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeSetVolumeLevelerTarget(JNIEnv *env, jobject thiz, jfloat lufs) {
+    if (sEngine) sEngine->setVolumeLevelerTarget(lufs);
+}
+
+JNIEXPORT void JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeSetTrackGain(JNIEnv *env, jobject thiz, jfloat gainDb) {
+    if (sEngine) sEngine->setTrackGain(gainDb);
+}
+
 // ================== Stereo ==================
 
 JNIEXPORT void JNICALL
@@ -212,6 +329,269 @@ Java_com_oss_euphoriae_engine_AudioEngine_nativeGetReverbPreset(JNIEnv *env, job
     return sEngine ? sEngine->getReverbPreset() : 0;
 }
 
+// ================== Convolution ==================
+
+JNIEXPORT jboolean JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeLoadImpulseResponse(
+        JNIEnv *env,
+        jobject thiz,
+        jfloatArray impulseResponse,
+        jint numFrames,
+        jint channelCount) {
+    if (!sEngine || impulseResponse == nullptr) return JNI_FALSE;
+    if (!euphoriae::holdsFrames(env->GetArrayLength(impulseResponse), numFrames, channelCount)) return JNI_FALSE;
+    
+    jfloat* ir = env->GetFloatArrayElements(impulseResponse, nullptr);
+    if (ir == nullptr) return JNI_FALSE;
+    
+    bool loaded = sEngine->loadImpulseResponse(ir, numFrames, channelCount);
+    
+    env->ReleaseFloatArrayElements(impulseResponse, ir, JNI_ABORT);
+    return loaded ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeClearImpulseResponse(JNIEnv *env, jobject thiz) {
+    if (sEngine) sEngine->clearImpulseResponse();
+}
+
+JNIEXPORT void JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeSetConvolutionMix(JNIEnv *env, jobject thiz, jfloat wetMix) {
+    if (sEngine) sEngine->setConvolutionMix(wetMix);
+}
+
+// Spectrum analyzer
+JNIEXPORT void JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeSetSpectrumAnalyzerEnabled(JNIEnv *env, jobject thiz, jboolean enabled) {
+    if (sEngine) sEngine->setSpectrumAnalyzerEnabled(enabled);
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeGetSpectrum(JNIEnv *env, jobject thiz, jobject bands) {
+    if (!sEngine || bands == nullptr) return JNI_FALSE;
+    
+    // Direct buffer: written in place, no array copies on the UI thread
+    auto* data = static_cast<float*>(env->GetDirectBufferAddress(bands));
+    jlong capacity = env->GetDirectBufferCapacity(bands);
+    if (data == nullptr || capacity < static_cast<jlong>(sizeof(float))) return JNI_FALSE;
+    
+    int32_t numBands = static_cast<int32_t>(capacity / static_cast<jlong>(sizeof(float)));
+    return sEngine->getSpectrum(data, numBands) ? JNI_TRUE : JNI_FALSE;
+}
+
+// Loudness (LUFS)
+JNIEXPORT jfloat JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeGetMomentaryLoudness(JNIEnv *env, jobject thiz) {
+    return sEngine ? sEngine->getMomentaryLoudness() : -70.0f;
+}
+
+JNIEXPORT jfloat JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeGetShortTermLoudness(JNIEnv *env, jobject thiz) {
+    return sEngine ? sEngine->getShortTermLoudness() : -70.0f;
+}
+
+JNIEXPORT jfloat JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeGetIntegratedLoudness(JNIEnv *env, jobject thiz) {
+    return sEngine ? sEngine->getIntegratedLoudness() : -70.0f;
+}
+
+// DSP kernel set in use on this device (process-wide, no engine needed)
+JNIEXPORT jstring JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeGetSimdVariant(JNIEnv *env, jobject thiz) {
+    return env->NewStringUTF(euphoriae::AudioEngine::simdVariant());
+}
+
+// Library loudness scanning (independent of the engine instance). Each scan
+// gets an id and a cancel flag before it starts, so a cancel meant for it can
+// neither come too early to count nor reach a later scan.
+static std::mutex sScansMutex;
+static jlong sLastScanId = 0;
+static std::unordered_map<jlong, std::shared_ptr<std::atomic<bool>>> sScans;  // Not yet finished
+
+static void storeLoudnessResult(const euphoriae::LoudnessResult& result, float* out) {
+    out[0] = result.valid ? result.integratedLufs : NAN;
+    out[1] = result.valid ? result.truePeakDb : NAN;
+    out[2] = result.valid ? result.loudnessRange : NAN;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeAnalyzeLoudness(
+        JNIEnv *env,
+        jobject thiz,
+        jfloatArray pcm,
+        jint numFrames,
+        jint channelCount,
+        jint sampleRate,
+        jfloatArray result) {
+    if (pcm == nullptr || result == nullptr || env->GetArrayLength(result) < 3) return JNI_FALSE;
+    if (channelCount > euphoriae::LoudnessMeter::kMaxChannels) return JNI_FALSE;
+    if (!euphoriae::holdsFrames(env->GetArrayLength(pcm), numFrames, channelCount)) return JNI_FALSE;
+    
+    jfloat* samples = env->GetFloatArrayElements(pcm, nullptr);
+    if (samples == nullptr) return JNI_FALSE;
+    euphoriae::LoudnessResult loudness =
+            euphoriae::LoudnessScanner::analyzePcm(samples, numFrames, channelCount, sampleRate);
+    env->ReleaseFloatArrayElements(pcm, samples, JNI_ABORT);
+    
+    float values[3];
+    storeLoudnessResult(loudness, values);
+    env->SetFloatArrayRegion(result, 0, 3, values);
+    return loudness.valid ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeNewLoudnessScan(JNIEnv *env, jobject thiz) {
+    std::lock_guard<std::mutex> lock(sScansMutex);
+    sScans.emplace(++sLastScanId, std::make_shared<std::atomic<bool>>(false));
+    return sLastScanId;
+}
+
+static jint scanLoudness(JNIEnv *env, jobjectArray paths, jfloatArray results,
+                         const std::atomic<bool>& cancelled) {
+    if (paths == nullptr || results == nullptr) return 0;
+    jsize count = env->GetArrayLength(paths);
+    if (count == 0 || !euphoriae::holdsFrames(env->GetArrayLength(results), count, 3)) return 0;
+    
+    std::vector<std::string> filePaths(count);
+    for (jsize i = 0; i < count; i++) {
+        auto path = static_cast<jstring>(env->GetObjectArrayElement(paths, i));
+        if (path == nullptr) continue;
+        const char* chars = env->GetStringUTFChars(path, nullptr);
+        if (chars != nullptr) {
+            filePaths[i] = chars;
+            env->ReleaseStringUTFChars(path, chars);
+        }
+        env->DeleteLocalRef(path);
+    }
+    
+    // Workers write disjoint slots; nothing touches JNI until the scan is over
+    std::vector<float> values(count * 3, NAN);  // Skipped on cancel stays NaN
+    std::atomic<jint> analyzed{0};
+    // A background job: leave cores for playback and the UI, and yield to them
+    // (Android's background thread priority) whenever they need the CPU
+    const int32_t numThreads = std::clamp(static_cast<int32_t>(std::thread::hardware_concurrency()) - 2, 1, 4);
+    constexpr int32_t kBackgroundNiceness = 10;
+    euphoriae::LoudnessScanner scanner(numThreads, kBackgroundNiceness);
+    scanner.scanFiles(filePaths, [&](size_t index, const euphoriae::LoudnessResult& result) {
+        storeLoudnessResult(result, values.data() + index * 3);
+        if (result.valid) analyzed++;
+    }, cancelled);
+    
+    env->SetFloatArrayRegion(results, 0, count * 3, values.data());
+    LOGI("Loudness scan: %d of %d tracks analyzed", analyzed.load(), count);
+    return analyzed.load();
+}
+
+JNIEXPORT jint JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeScanLoudness(
+        JNIEnv *env,
+        jobject thiz,
+        jlong scanId,
+        jobjectArray paths,
+        jfloatArray results) {
+    std::shared_ptr<std::atomic<bool>> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(sScansMutex);
+        auto scan = sScans.find(scanId);
+        if (scan == sScans.end()) return 0;  // Unknown or already run
+        cancelled = scan->second;
+    }
+    jint analyzed = scanLoudness(env, paths, results, *cancelled);
+    
+    std::lock_guard<std::mutex> lock(sScansMutex);
+    sScans.erase(scanId);
+    return analyzed;
+}
+
+JNIEXPORT void JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeCancelLoudnessScan(JNIEnv *env, jobject thiz, jlong scanId) {
+    std::lock_guard<std::mutex> lock(sScansMutex);
+    auto scan = sScans.find(scanId);
+    if (scan != sScans.end()) scan->second->store(true);
+}
+
+// Offline rendering (a snapshot of the engine's settings, run on the caller's thread)
+static std::atomic<bool> sRenderCancelled{false};
+static std::atomic<float> sRenderProgress{0.0f};
+
+JNIEXPORT jboolean JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeRenderFile(
+        JNIEnv *env,
+        jobject thiz,
+        jstring inputPath,
+        jstring outputPath) {
+    if (!sEngine || inputPath == nullptr || outputPath == nullptr) return JNI_FALSE;
+    
+    const char* input = env->GetStringUTFChars(inputPath, nullptr);
+    const char* output = env->GetStringUTFChars(outputPath, nullptr);
+    std::string inputFile = input != nullptr ? input : "";
+    std::string outputFile = output != nullptr ? output : "";
+    if (input != nullptr) env->ReleaseStringUTFChars(inputPath, input);
+    if (output != nullptr) env->ReleaseStringUTFChars(outputPath, output);
+    
+    sRenderCancelled.store(false);
+    sRenderProgress.store(0.0f);
+    
+    euphoriae::MediaDecoder decoder;
+    if (!decoder.open(inputFile.c_str())) {
+        LOGE("Render: cannot decode %s", inputFile.c_str());
+        return JNI_FALSE;
+    }
+    
+    // Leave cores for playback and the UI; memory grows with the worker count
+    const int32_t numThreads = std::clamp(static_cast<int32_t>(std::thread::hardware_concurrency()) - 2, 1, 4);
+    std::unique_ptr<euphoriae::PcmWriter> writer;
+    std::unique_ptr<euphoriae::OfflineRenderer> renderer;
+    int32_t streamRate = 0;
+    int32_t streamChannels = 0;
+    int64_t expectedFrames = 0;
+    
+    bool decoded = decoder.decode([&](const float* pcm, int32_t numFrames, int32_t channelCount, int32_t sampleRate) {
+        if (!renderer) {
+            writer = euphoriae::PcmWriter::create(outputFile.c_str(), sampleRate, channelCount,
+                                                  euphoriae::SampleFormat::kInt16);
+            if (!writer) return false;
+            streamRate = sampleRate;
+            streamChannels = channelCount;
+            expectedFrames = decoder.durationUs() * sampleRate / 1000000;
+            renderer = std::make_unique<euphoriae::OfflineRenderer>(
+                    *sEngine, sampleRate, channelCount,
+                    [&](const float* out, int32_t outFrames) {
+                        if (expectedFrames > 0) {
+                            float done = static_cast<float>(renderer->framesRendered() + outFrames) / expectedFrames;
+                            sRenderProgress.store(std::min(done, 0.99f));
+                        }
+                        return writer->write(out, outFrames);
+                    },
+                    sRenderCancelled, numThreads);
+        }
+        if (sampleRate != streamRate || channelCount != streamChannels) return false;
+        return renderer->push(pcm, numFrames);
+    });
+    
+    bool ok = decoded && renderer && !sRenderCancelled.load() && renderer->finish();
+    ok = writer && writer->close() && ok;
+    if (!ok) {
+        std::remove(outputFile.c_str());
+        LOGE("Render of %s failed or was cancelled", inputFile.c_str());
+        return JNI_FALSE;
+    }
+    sRenderProgress.store(1.0f);
+    LOGI("Rendered %s: %lld frames on %d threads", outputFile.c_str(),
+         static_cast<long long>(renderer->framesRendered()), numThreads);
+    return JNI_TRUE;
+}
+
+JNIEXPORT jfloat JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeGetRenderProgress(JNIEnv *env, jobject thiz) {
+    return sRenderProgress.load();
+}
+
+JNIEXPORT void JNICALL
+Java_com_oss_euphoriae_engine_AudioEngine_nativeCancelRender(JNIEnv *env, jobject thiz) {
+    sRenderCancelled.store(true);
+}
+
 // Tempo/Pitch
 JNIEXPORT void JNICALL
 Java_com_oss_euphoriae_engine_AudioEngine_nativeSetTempo(JNIEnv *env, jobject thiz, jfloat tempo) {
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EUPHORIAE_JNI_CHECKS_H
+#define EUPHORIAE_JNI_CHECKS_H
+
+#include <cstdint>
+
+namespace euphoriae {
+
+/*
+ * Argument checks of the JNI entry points, kept out of jni_bridge.cpp so the
+ * host fuzzer can run them against the same lengths and counts an app could
+ * pass. Array lengths are jsize and counts jint; products are taken in 64 bits
+ * so large counts cannot wrap past the check.
+ */
+
+// Whether a Java array of arrayLength elements holds numFrames interleaved
+// frames of channelCount channels
+inline bool holdsFrames(int64_t arrayLength, int32_t numFrames, int32_t channelCount) {
+    return numFrames > 0 && channelCount > 0 &&
+           arrayLength >= static_cast<int64_t>(numFrames) * channelCount;
+}
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_JNI_CHECKS_H
@@ -0,0 +1,251 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "loudness_meter.h"
+#include "channel_layout.h"
+#include <algorithm>
+#include <cmath>
+
+namespace euphoriae {
+
+namespace {
+
+constexpr double kLoudnessOffset = -0.691;  // BS.1770 calibration constant
+constexpr double kRelativeGate = -10.0;     // LU below the absolute-gated mean
+constexpr double kRangeRelativeGate = -20.0;
+constexpr double kRangeLowPercentile = 0.10;
+constexpr double kRangeHighPercentile = 0.95;
+
+double energyToLoudness(double energy) {
+    return kLoudnessOffset + 10.0 * std::log10(std::max(energy, 1e-20));
+}
+
+double loudnessToEnergy(double loudness) {
+    return std::pow(10.0, (loudness - kLoudnessOffset) / 10.0);
+}
+
+} // namespace
+
+LoudnessMeter::LoudnessMeter(int32_t sampleRate) {
+    for (int32_t i = 0; i < kHistogramBins; i++) {
+        mBinEnergy[i] = loudnessToEnergy(kAbsoluteGate + (i + 0.5) * kHistogramStep);
+    }
+    setSampleRate(sampleRate);
+}
+
+void LoudnessMeter::setSampleRate(int32_t sampleRate) {
+    const double fs = std::max(sampleRate, 8000);
+
+    // Stage 1: high shelf modelling the acoustic effect of the head
+    {
+        const double f0 = 1681.974450955533;
+        const double gainDb = 3.999843853973347;
+        const double q = 0.7071752369554196;
+        const double k = std::tan(M_PI * f0 / fs);
+        const double vh = std::pow(10.0, gainDb / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+        mShelf.b0 = static_cast<float>((vh + vb * k / q + k * k) / a0);
+        mShelf.b1 = static_cast<float>(2.0 * (k * k - vh) / a0);
+        mShelf.b2 = static_cast<float>((vh - vb * k / q + k * k) / a0);
+        mShelf.a1 = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+        mShelf.a2 = static_cast<float>((1.0 - k / q + k * k) / a0);
+    }
+
+    // Stage 2: RLB high-pass
+    {
+        const double f0 = 38.13547087602444;
+        const double q = 0.5003270373238773;
+        const double k = std::tan(M_PI * f0 / fs);
+        const double a0 = 1.0 + k / q + k * k;
+        mHighPass.b0 = 1.0f;
+        mHighPass.b1 = -2.0f;
+        mHighPass.b2 = 1.0f;
+        mHighPass.a1 = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+        mHighPass.a2 = static_cast<float>((1.0 - k / q + k * k) / a0);
+    }
+
+    mStepFrames = static_cast<int32_t>(fs / 10.0);
+    reset();
+}
+
+void LoudnessMeter::reset() {
+    mState.fill(FilterState{});
+    mSteps.fill(0.0);
+    mHistogram.fill(0);
+    mShortTermHistogram.fill(0);
+    mStepPosition = 0;
+    mStepEnergy = 0.0;
+    mStepIndex = 0;
+    mStepCount = 0;
+    mGatedBlocks = 0;
+    mMomentary.store(kAbsoluteGate, std::memory_order_relaxed);
+    mShortTerm.store(kAbsoluteGate, std::memory_order_relaxed);
+    mIntegrated.store(kAbsoluteGate, std::memory_order_relaxed);
+}
+
+void LoudnessMeter::process(const float* buffer, int32_t numFrames, int32_t channelCount) {
+    if (buffer == nullptr || channelCount <= 0) return;
+    const int32_t channels = std::min(channelCount, kMaxChannels);
+    const ChannelLayout layout = ChannelLayout::forChannelCount(channels);
+
+    int32_t frame = 0;
+    while (frame < numFrames) {
+        int32_t chunk = std::min(numFrames - frame, mStepFrames - mStepPosition);
+
+        // Channel-major so each channel's filter state stays in registers
+        for (int32_t ch = 0; ch < channels; ch++) {
+            const float weight = layout.loudnessWeight(ch);
+            if (weight == 0.0f) continue;
+            FilterState shelf = mState[ch * 2];
+            FilterState highPass = mState[ch * 2 + 1];
+            float energy = 0.0f;
+            for (int32_t i = 0; i < chunk; i++) {
+                float x = buffer[(frame + i) * channelCount + ch];
+
+                // Transposed direct form II
+                float y = mShelf.b0 * x + shelf.z1;
+                shelf.z1 = mShelf.b1 * x - mShelf.a1 * y + shelf.z2;
+                shelf.z2 = mShelf.b2 * x - mShelf.a2 * y;
+
+                float k = y + highPass.z1;
+                highPass.z1 = -2.0f * y - mHighPass.a1 * k + highPass.z2;
+                highPass.z2 = y - mHighPass.a2 * k;
+
+                energy += k * k;
+            }
+            mState[ch * 2] = shelf;
+            mState[ch * 2 + 1] = highPass;
+            mStepEnergy += weight * energy;
+        }
+
+        frame += chunk;
+        mStepPosition += chunk;
+        if (mStepPosition == mStepFrames) {
+            finishStep();
+        }
+    }
+}
+
+void LoudnessMeter::processSilence(int32_t numFrames) {
+    int32_t frame = 0;
+    while (frame < numFrames) {
+        int32_t chunk = std::min(numFrames - frame, mStepFrames - mStepPosition);
+        frame += chunk;
+        mStepPosition += chunk;
+        if (mStepPosition == mStepFrames) {
+            finishStep();
+        }
+    }
+}
+
+void LoudnessMeter::finishStep() {
+    mSteps[mStepIndex] = mStepEnergy / mStepFrames;
+    mStepIndex = (mStepIndex + 1) % kShortTermSteps;
+    mStepCount = std::min(mStepCount + 1, kShortTermSteps);
+    mStepEnergy = 0.0;
+    mStepPosition = 0;
+
+    auto windowEnergy = [this](int32_t steps) {
+        double sum = 0.0;
+        for (int32_t i = 1; i <= steps; i++) {
+            sum += mSteps[(mStepIndex - i + kShortTermSteps) % kShortTermSteps];
+        }
+        return sum / steps;
+    };
+
+    // Windows are only reported once full; until then the meter reads silence
+    if (mStepCount >= kMomentarySteps) {
+        double momentary = energyToLoudness(windowEnergy(kMomentarySteps));
+        mMomentary.store(static_cast<float>(std::max(momentary, static_cast<double>(kAbsoluteGate))),
+                         std::memory_order_relaxed);
+
+        // Every momentary window is also a 75%-overlapped gating block
+        if (momentary >= kAbsoluteGate) {
+            mHistogram[histogramBin(momentary)]++;
+            mGatedBlocks++;
+            updateIntegrated();
+        }
+    }
+    if (mStepCount >= kShortTermSteps) {
+        double shortTerm = energyToLoudness(windowEnergy(kShortTermSteps));
+        mShortTerm.store(static_cast<float>(std::max(shortTerm, static_cast<double>(kAbsoluteGate))),
+                         std::memory_order_relaxed);
+        if (shortTerm >= kAbsoluteGate) {
+            mShortTermHistogram[histogramBin(shortTerm)]++;
+        }
+    }
+}
+
+int32_t LoudnessMeter::histogramBin(double loudness) {
+    int32_t bin = static_cast<int32_t>((loudness - kAbsoluteGate) / kHistogramStep);
+    return std::clamp(bin, 0, kHistogramBins - 1);
+}
+
+void LoudnessMeter::updateIntegrated() {
+    // Absolute gate: every block in the histogram already passed it
+    double sum = 0.0;
+    uint64_t count = 0;
+    for (int32_t i = 0; i < kHistogramBins; i++) {
+        sum += mHistogram[i] * mBinEnergy[i];
+        count += mHistogram[i];
+    }
+    if (count == 0) return;
+
+    // Relative gate
+    double gate = energyToLoudness(sum / count) + kRelativeGate;
+    int32_t firstBin = std::max(0, static_cast<int32_t>(std::ceil((gate - kAbsoluteGate) / kHistogramStep - 0.5)));
+    sum = 0.0;
+    count = 0;
+    for (int32_t i = firstBin; i < kHistogramBins; i++) {
+        sum += mHistogram[i] * mBinEnergy[i];
+        count += mHistogram[i];
+    }
+    if (count == 0) return;
+    mIntegrated.store(static_cast<float>(energyToLoudness(sum / count)), std::memory_order_relaxed);
+}
+
+float LoudnessMeter::loudnessRange() const {
+    double sum = 0.0;
+    uint64_t count = 0;
+    for (int32_t i = 0; i < kHistogramBins; i++) {
+        sum += mShortTermHistogram[i] * mBinEnergy[i];
+        count += mShortTermHistogram[i];
+    }
+    if (count == 0) return 0.0f;
+
+    double gate = energyToLoudness(sum / count) + kRangeRelativeGate;
+    int32_t firstBin = std::max(0, static_cast<int32_t>(std::ceil((gate - kAbsoluteGate) / kHistogramStep - 0.5)));
+    count = 0;
+    for (int32_t i = firstBin; i < kHistogramBins; i++) {
+        count += mShortTermHistogram[i];
+    }
+    if (count < 2) return 0.0f;
+
+    // Walk the gated histogram to the two percentiles
+    auto percentile = [&](double fraction) {
+        uint64_t target = static_cast<uint64_t>(fraction * (count - 1));
+        uint64_t seen = 0;
+        for (int32_t i = firstBin; i < kHistogramBins; i++) {
+            seen += mShortTermHistogram[i];
+            if (seen > target) return kAbsoluteGate + (i + 0.5) * kHistogramStep;
+        }
+        return kAbsoluteGate + (kHistogramBins - 0.5) * kHistogramStep;
+    };
+    return static_cast<float>(percentile(kRangeHighPercentile) - percentile(kRangeLowPercentile));
+}
+
+} // namespace euphoriae
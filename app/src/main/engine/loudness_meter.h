@@ -0,0 +1,112 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EUPHORIAE_LOUDNESS_METER_H
+#define EUPHORIAE_LOUDNESS_METER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace euphoriae {
+
+/**
+ * LoudnessMeter - ITU-R BS.1770 / EBU R128 loudness of a stream
+ *
+ * Signals are K-weighted (shelf + RLB high-pass) and their energy is summed
+ * over channels in 100 ms steps. Momentary loudness covers the last 400 ms,
+ * short-term the last 3 s. Integrated loudness is gated: 400 ms blocks below
+ * -70 LUFS are dropped, then blocks more than 10 LU below the remaining mean.
+ * Blocks are kept in a 0.1 LU histogram, so memory and cost stay constant
+ * however long the stream runs. Short-term values go into a second histogram
+ * for the loudness range (EBU Tech 3342).
+ *
+ * Channels are weighted per BS.1770 for the layout of their count (see
+ * ChannelLayout): surrounds 1.41, the LFE left out, everything else 1.0.
+ */
+class LoudnessMeter {
+public:
+    static constexpr int32_t kMaxChannels = 8;
+    static constexpr float kAbsoluteGate = -70.0f;  // LUFS; also what the meter reads in silence
+
+    explicit LoudnessMeter(int32_t sampleRate);
+
+    // Audio thread: rebuilds the filters and clears all history
+    void setSampleRate(int32_t sampleRate);
+    void reset();
+
+    // Audio thread: measures without modifying the buffer
+    void process(const float* buffer, int32_t numFrames, int32_t channelCount);
+
+    // Audio thread: numFrames of silence, once the filters have rung out
+    void processSilence(int32_t numFrames);
+
+    // Any thread, in LUFS
+    float momentary() const { return mMomentary.load(std::memory_order_relaxed); }
+    float shortTerm() const { return mShortTerm.load(std::memory_order_relaxed); }
+    float integrated() const { return mIntegrated.load(std::memory_order_relaxed); }
+
+    // Processing thread: LRA in LU, 0 until enough short-term values are gated in
+    float loudnessRange() const;
+
+    // Processing thread: false until a 400 ms block has passed the absolute gate;
+    // until then integrated() is the silence reading, not a measurement
+    bool hasIntegrated() const { return mGatedBlocks > 0; }
+
+private:
+    static constexpr int32_t kMomentarySteps = 4;    // 400 ms
+    static constexpr int32_t kShortTermSteps = 30;   // 3 s
+    static constexpr float kHistogramStep = 0.1f;    // LU per bin
+    static constexpr int32_t kHistogramBins = 750;   // -70 to +5 LUFS
+
+    struct Biquad {
+        float b0, b1, b2, a1, a2;
+    };
+
+    struct FilterState {
+        float z1 = 0.0f;
+        float z2 = 0.0f;
+    };
+
+    void finishStep();
+    void updateIntegrated();
+    static int32_t histogramBin(double loudness);
+
+    Biquad mShelf{};
+    Biquad mHighPass{};
+    std::array<FilterState, kMaxChannels * 2> mState{};
+
+    int32_t mStepFrames = 0;
+    int32_t mStepPosition = 0;
+    double mStepEnergy = 0.0;
+
+    std::array<double, kShortTermSteps> mSteps{};  // Mean-square energy per 100 ms step
+    int32_t mStepIndex = 0;
+    int32_t mStepCount = 0;
+
+    std::array<uint32_t, kHistogramBins> mHistogram{};
+    std::array<uint32_t, kHistogramBins> mShortTermHistogram{};
+    std::array<double, kHistogramBins> mBinEnergy{};
+    uint64_t mGatedBlocks = 0;
+
+    std::atomic<float> mMomentary{kAbsoluteGate};
+    std::atomic<float> mShortTerm{kAbsoluteGate};
+    std::atomic<float> mIntegrated{kAbsoluteGate};
+};
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_LOUDNESS_METER_H
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "loudness_scanner.h"
+#include "media_decoder.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+namespace euphoriae {
+
+void TrackAnalyzer::process(const float* pcm, int32_t numFrames, int32_t channelCount) {
+    mLoudness.process(pcm, numFrames, channelCount);
+    mTruePeak.process(pcm, numFrames, channelCount);
+}
+
+LoudnessResult TrackAnalyzer::result() const {
+    LoudnessResult result;
+    // Silent or shorter than one gating block: there is no loudness to normalize to
+    result.valid = mLoudness.hasIntegrated();
+    result.integratedLufs = mLoudness.integrated();
+    result.truePeakDb = 20.0f * std::log10(std::max(mTruePeak.peak(), 1e-5f));
+    result.loudnessRange = mLoudness.loudnessRange();
+    return result;
+}
+
+LoudnessResult LoudnessScanner::analyzePcm(const float* pcm, int64_t numFrames,
+                                           int32_t channelCount, int32_t sampleRate) {
+    if (pcm == nullptr || numFrames <= 0 || channelCount <= 0 || sampleRate <= 0) return {};
+
+    TrackAnalyzer analyzer(sampleRate);
+    constexpr int32_t kChunkFrames = 4096;
+    for (int64_t frame = 0; frame < numFrames; frame += kChunkFrames) {
+        int32_t chunk = static_cast<int32_t>(std::min<int64_t>(kChunkFrames, numFrames - frame));
+        analyzer.process(pcm + frame * channelCount, chunk, channelCount);
+    }
+    return analyzer.result();
+}
+
+LoudnessResult LoudnessScanner::analyzeFile(const char* path, const std::atomic<bool>& cancelled) {
+    MediaDecoder decoder;
+    if (!decoder.open(path)) return {};
+
+    // Created on the first output buffer: only then are the decoded rate and layout known
+    std::unique_ptr<TrackAnalyzer> analyzer;
+    int32_t analyzerRate = 0;
+    bool aborted = false;
+    bool ok = decoder.decode([&](const float* pcm, int32_t numFrames, int32_t channelCount, int32_t sampleRate) {
+        // A rate change mid-stream would mis-measure, so give up on the track
+        if (cancelled.load(std::memory_order_relaxed) || (analyzer && sampleRate != analyzerRate)) {
+            aborted = true;
+            return false;
+        }
+        if (!analyzer) {
+            analyzer = std::make_unique<TrackAnalyzer>(sampleRate);
+            analyzerRate = sampleRate;
+        }
+        analyzer->process(pcm, numFrames, channelCount);
+        return true;
+    });
+
+    if (!ok || aborted || !analyzer) return {};
+    return analyzer->result();
+}
+
+void LoudnessScanner::scanFiles(const std::vector<std::string>& paths, const ResultCallback& onResult,
+                                const std::atomic<bool>& cancelled) {
+    for (size_t i = 0; i < paths.size(); i++) {
+        mPool.submit([&, i] {
+            LoudnessResult result;
+            if (!cancelled.load(std::memory_order_relaxed)) {
+                result = analyzeFile(paths[i].c_str(), cancelled);
+            }
+            onResult(i, result);
+        });
+    }
+    mPool.wait();
+}
+
+} // namespace euphoriae
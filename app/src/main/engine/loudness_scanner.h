@@ -0,0 +1,84 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EUPHORIAE_LOUDNESS_SCANNER_H
+#define EUPHORIAE_LOUDNESS_SCANNER_H
+
+#include "loudness_meter.h"
+#include "thread_pool.h"
+#include "true_peak_meter.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace euphoriae {
+
+/** LoudnessResult - What the library scanner stores per track */
+struct LoudnessResult {
+    bool valid = false;
+    float integratedLufs = LoudnessMeter::kAbsoluteGate;
+    float truePeakDb = -96.0f;  // dBTP
+    float loudnessRange = 0.0f; // LU
+};
+
+/**
+ * TrackAnalyzer - Integrated loudness, true peak and loudness range of one stream
+ */
+class TrackAnalyzer {
+public:
+    explicit TrackAnalyzer(int32_t sampleRate) : mLoudness(sampleRate) {}
+
+    void process(const float* pcm, int32_t numFrames, int32_t channelCount);
+    LoudnessResult result() const;
+
+private:
+    LoudnessMeter mLoudness;
+    TruePeakMeter mTruePeak;
+};
+
+/**
+ * LoudnessScanner - Batch loudness analysis of a music library on a work-stealing pool
+ *
+ * One task per file; decoding runs inside the task, so throughput scales with
+ * cores and long tracks do not hold up short ones.
+ */
+class LoudnessScanner {
+public:
+    // Called from worker threads, once per path, in completion order
+    using ResultCallback = std::function<void(size_t index, const LoudnessResult& result)>;
+
+    explicit LoudnessScanner(int32_t numThreads = 0, int32_t niceness = 0) : mPool(numThreads, niceness) {}
+
+    // Already decoded interleaved PCM, analyzed on the calling thread
+    static LoudnessResult analyzePcm(const float* pcm, int64_t numFrames,
+                                     int32_t channelCount, int32_t sampleRate);
+
+    // Decodes and analyzes one file on the calling thread
+    static LoudnessResult analyzeFile(const char* path, const std::atomic<bool>& cancelled);
+
+    // Blocks until every path has been analyzed or the scan is cancelled
+    void scanFiles(const std::vector<std::string>& paths, const ResultCallback& onResult,
+                   const std::atomic<bool>& cancelled);
+
+private:
+    ThreadPool mPool;
+};
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_LOUDNESS_SCANNER_H
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "media_decoder.h"
+#include <media/NdkMediaCodec.h>
+#include <media/NdkMediaExtractor.h>
+#include <media/NdkMediaFormat.h>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace euphoriae {
+
+namespace {
+
+constexpr int32_t kEncodingPcm16 = 2;
+constexpr int32_t kEncodingPcmFloat = 4;
+constexpr int64_t kDequeueTimeoutUs = 10000;
+
+} // namespace
+
+MediaDecoder::~MediaDecoder() {
+    if (mCodec != nullptr) {
+        AMediaCodec_stop(mCodec);
+        AMediaCodec_delete(mCodec);
+    }
+    if (mExtractor != nullptr) AMediaExtractor_delete(mExtractor);
+    if (mFd >= 0) close(mFd);
+}
+
+bool MediaDecoder::open(const char* path) {
+    if (path == nullptr) return false;
+    mFd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (mFd < 0) return false;
+
+    struct stat info {};
+    if (fstat(mFd, &info) != 0) return false;
+
+    mExtractor = AMediaExtractor_new();
+    if (AMediaExtractor_setDataSourceFd(mExtractor, mFd, 0, info.st_size) != AMEDIA_OK) return false;
+
+    const size_t numTracks = AMediaExtractor_getTrackCount(mExtractor);
+    for (size_t track = 0; track < numTracks; track++) {
+        AMediaFormat* format = AMediaExtractor_getTrackFormat(mExtractor, track);
+        const char* mime = nullptr;
+        bool isAudio = AMediaFormat_getString(format, AMEDIAFORMAT_KEY_MIME, &mime) &&
+                       std::strncmp(mime, "audio/", 6) == 0;
+        if (isAudio) {
+            AMediaFormat_getInt32(format, AMEDIAFORMAT_KEY_SAMPLE_RATE, &mSampleRate);
+            AMediaFormat_getInt32(format, AMEDIAFORMAT_KEY_CHANNEL_COUNT, &mChannelCount);
+            AMediaFormat_getInt64(format, AMEDIAFORMAT_KEY_DURATION, &mDurationUs);
+
+            // Float output avoids a 16-bit round trip where the decoder supports it
+            AMediaFormat_setInt32(format, AMEDIAFORMAT_KEY_PCM_ENCODING, kEncodingPcmFloat);
+
+            mCodec = AMediaCodec_createDecoderByType(mime);
+            bool started = mCodec != nullptr &&
+                           AMediaExtractor_selectTrack(mExtractor, track) == AMEDIA_OK &&
+                           AMediaCodec_configure(mCodec, format, nullptr, nullptr, 0) == AMEDIA_OK &&
+                           AMediaCodec_start(mCodec) == AMEDIA_OK;
+            AMediaFormat_delete(format);
+            return started;
+        }
+        AMediaFormat_delete(format);
+    }
+    return false;
+}
+
+bool MediaDecoder::decode(const PcmCallback& onPcm) {
+    if (mCodec == nullptr) return false;
+
+    bool inputDone = false;
+    while (true) {
+        if (!inputDone) {
+            ssize_t index = AMediaCodec_dequeueInputBuffer(mCodec, kDequeueTimeoutUs);
+            if (index >= 0) {
+                size_t capacity = 0;
+                uint8_t* input = AMediaCodec_getInputBuffer(mCodec, index, &capacity);
+                ssize_t size = AMediaExtractor_readSampleData(mExtractor, input, capacity);
+                if (size < 0) {
+                    AMediaCodec_queueInputBuffer(mCodec, index, 0, 0, 0, AMEDIACODEC_BUFFER_FLAG_END_OF_STREAM);
+                    inputDone = true;
+                } else {
+                    int64_t timeUs = AMediaExtractor_getSampleTime(mExtractor);
+                    AMediaCodec_queueInputBuffer(mCodec, index, 0, size, timeUs, 0);
+                    AMediaExtractor_advance(mExtractor);
+                }
+            }
+        }
+
+        AMediaCodecBufferInfo info;
+        ssize_t index = AMediaCodec_dequeueOutputBuffer(mCodec, &info, kDequeueTimeoutUs);
+        if (index == AMEDIACODEC_INFO_OUTPUT_FORMAT_CHANGED) {
+            AMediaFormat* format = AMediaCodec_getOutputFormat(mCodec);
+            AMediaFormat_getInt32(format, AMEDIAFORMAT_KEY_SAMPLE_RATE, &mSampleRate);
+            AMediaFormat_getInt32(format, AMEDIAFORMAT_KEY_CHANNEL_COUNT, &mChannelCount);
+            if (!AMediaFormat_getInt32(format, AMEDIAFORMAT_KEY_PCM_ENCODING, &mPcmEncoding)) {
+                mPcmEncoding = kEncodingPcm16;
+            }
+            AMediaFormat_delete(format);
+            continue;
+        }
+        if (index < 0) continue;  // Try again later / buffers changed
+
+        bool keepGoing = true;
+        size_t capacity = 0;
+        const uint8_t* buffer = AMediaCodec_getOutputBuffer(mCodec, index, &capacity);
+        if (buffer != nullptr && info.size > 0 && mChannelCount > 0 && mSampleRate > 0) {
+            const uint8_t* output = buffer + info.offset;
+            int32_t numFrames = 0;
+            if (mPcmEncoding == kEncodingPcmFloat) {
+                int32_t numSamples = info.size / static_cast<int32_t>(sizeof(float));
+                numFrames = numSamples / mChannelCount;
+                mPcm.resize(numSamples);
+                std::memcpy(mPcm.data(), output, numSamples * sizeof(float));
+            } else {
+                int32_t numSamples = info.size / static_cast<int32_t>(sizeof(int16_t));
+                numFrames = numSamples / mChannelCount;
+                mPcm.resize(numSamples);
+                const auto* samples = reinterpret_cast<const int16_t*>(output);
+                for (int32_t i = 0; i < numSamples; i++) {
+                    mPcm[i] = samples[i] * (1.0f / 32768.0f);
+                }
+            }
+            keepGoing = onPcm(mPcm.data(), numFrames, mChannelCount, mSampleRate);
+        }
+        AMediaCodec_releaseOutputBuffer(mCodec, index, false);
+
+        if (!keepGoing) return true;
+        if (info.flags & AMEDIACODEC_BUFFER_FLAG_END_OF_STREAM) return true;
+    }
+}
+
+} // namespace euphoriae
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EUPHORIAE_MEDIA_DECODER_H
+#define EUPHORIAE_MEDIA_DECODER_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+struct AMediaExtractor;
+struct AMediaCodec;
+
+namespace euphoriae {
+
+/**
+ * MediaDecoder - Decodes the first audio track of a file to float PCM (NDK media codecs)
+ *
+ * Output is streamed in codec-sized chunks, so a whole track is never held in memory.
+ */
+class MediaDecoder {
+public:
+    // Interleaved PCM as decoded; return false to stop early
+    using PcmCallback = std::function<bool(const float* pcm, int32_t numFrames,
+                                           int32_t channelCount, int32_t sampleRate)>;
+
+    MediaDecoder() = default;
+    ~MediaDecoder();
+    MediaDecoder(const MediaDecoder&) = delete;
+    MediaDecoder& operator=(const MediaDecoder&) = delete;
+
+    // false if the file cannot be read or has no decodable audio track
+    bool open(const char* path);
+
+    // true if the stream was decoded to the end (or the callback stopped it)
+    bool decode(const PcmCallback& onPcm);
+
+    // Container duration after open(), 0 if unknown
+    int64_t durationUs() const { return mDurationUs; }
+
+private:
+    AMediaExtractor* mExtractor = nullptr;
+    AMediaCodec* mCodec = nullptr;
+    int mFd = -1;
+    int32_t mSampleRate = 0;
+    int32_t mChannelCount = 0;
+    int64_t mDurationUs = 0;
+    int32_t mPcmEncoding = 2;  // Android AudioFormat encoding: 2 = 16-bit, 4 = float
+    std::vector<float> mPcm;
+};
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_MEDIA_DECODER_H
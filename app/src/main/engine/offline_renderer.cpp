@@ -0,0 +1,170 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "offline_renderer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace euphoriae {
+
+namespace {
+
+constexpr int64_t kMinSegmentSeconds = 20;
+constexpr int64_t kSegmentsPerWarmup = 2;  // Pre-roll costs at most half a segment
+
+} // namespace
+
+OfflineRenderer::OfflineRenderer(const AudioEngine& settings, int32_t sampleRate, int32_t channelCount,
+                                 OutputCallback onOutput, const std::atomic<bool>& cancelled,
+                                 int32_t numThreads)
+    : mChannelCount(channelCount),
+      mOnOutput(std::move(onOutput)),
+      mCancelled(cancelled),
+      mPool(numThreads) {
+    // 10 ms blocks, ten to a loudness meter step
+    mBlockFrames = std::max(1, sampleRate / 100);
+    const int64_t step = static_cast<int64_t>(mBlockFrames) * 10;
+    auto roundUp = [step](int64_t frames) { return (frames + step - 1) / step * step; };
+
+    mWorkers.resize(mPool.numThreads());
+    for (Worker& worker : mWorkers) {
+        worker.engine = std::make_unique<AudioEngine>();
+        worker.engine->configure(sampleRate, channelCount);
+        worker.engine->copySettingsFrom(settings);
+    }
+
+    // A single engine never jumps, so it never needs warming up
+    if (mWorkers.size() > 1) mWarmupFrames = roundUp(mWorkers[0].engine->settleFrames());
+    mSegmentFrames = roundUp(std::max(kMinSegmentSeconds * sampleRate, kSegmentsPerWarmup * mWarmupFrames));
+
+    mBuffer.resize(static_cast<size_t>(mSegmentFrames * static_cast<int64_t>(mWorkers.size())) * channelCount);
+    mHistory.resize(static_cast<size_t>(mWarmupFrames) * channelCount);
+    for (Worker& worker : mWorkers) {
+        worker.preroll.resize(static_cast<size_t>(mWarmupFrames) * channelCount);
+    }
+}
+
+bool OfflineRenderer::push(const float* pcm, int64_t numFrames) {
+    const int64_t capacity = static_cast<int64_t>(mBuffer.size()) / mChannelCount;
+    while (numFrames > 0) {
+        if (mFailed || mCancelled.load()) return false;
+
+        int64_t count = std::min(numFrames, capacity - mChunkFrames);
+        std::memcpy(mBuffer.data() + mChunkFrames * mChannelCount, pcm,
+                    static_cast<size_t>(count * mChannelCount) * sizeof(float));
+        mChunkFrames += count;
+        pcm += count * mChannelCount;
+        numFrames -= count;
+
+        if (mChunkFrames == capacity && !renderChunk()) {
+            mFailed = true;
+            return false;
+        }
+    }
+    return !mFailed;
+}
+
+bool OfflineRenderer::finish() {
+    if (mFailed) return false;
+    mFailed = !renderChunk();
+    return !mFailed;
+}
+
+bool OfflineRenderer::renderChunk() {
+    if (mChunkFrames == 0) return true;
+    const int32_t ch = mChannelCount;
+
+    // Segments are rendered in place, so every pre-roll is copied out of the
+    // input first; so is the history the next chunk's first segment needs
+    struct Segment {
+        int64_t start;
+        int64_t numFrames;
+        int64_t prerollFrames;
+    };
+    std::vector<Segment> segments;
+    for (size_t i = 0; i < mWorkers.size(); i++) {
+        int64_t start = static_cast<int64_t>(i) * mSegmentFrames;
+        if (start >= mChunkFrames) break;
+
+        Worker& worker = mWorkers[i];
+        Segment segment{start, std::min(mSegmentFrames, mChunkFrames - start), 0};
+        if (worker.position != mChunkStart + start && mWarmupFrames > 0) {
+            if (start == 0) {
+                segment.prerollFrames = mHistoryFrames;
+                std::memcpy(worker.preroll.data(), mHistory.data() + (mWarmupFrames - mHistoryFrames) * ch,
+                            static_cast<size_t>(mHistoryFrames * ch) * sizeof(float));
+            } else {
+                segment.prerollFrames = std::min(mWarmupFrames, start);
+                std::memcpy(worker.preroll.data(), mBuffer.data() + (start - segment.prerollFrames) * ch,
+                            static_cast<size_t>(segment.prerollFrames * ch) * sizeof(float));
+            }
+        }
+        segments.push_back(segment);
+    }
+    if (mWarmupFrames > 0 && mChunkFrames >= mWarmupFrames) {
+        std::memcpy(mHistory.data(), mBuffer.data() + (mChunkFrames - mWarmupFrames) * ch,
+                    static_cast<size_t>(mWarmupFrames * ch) * sizeof(float));
+        mHistoryFrames = mWarmupFrames;
+    }
+
+    std::atomic<bool> ok{true};
+    for (size_t i = 0; i < segments.size(); i++) {
+        mPool.submit([this, &ok, &segments, i] {
+            const Segment& segment = segments[i];
+            if (!renderSegment(mWorkers[i], mBuffer.data() + segment.start * mChannelCount,
+                               mChunkStart + segment.start, segment.numFrames, segment.prerollFrames)) {
+                ok.store(false);
+            }
+        });
+    }
+    mPool.wait();
+    if (!ok.load()) return false;
+
+    // Output in stream order, never more than the callback can take at once
+    constexpr int64_t kMaxCallbackFrames = 1 << 20;
+    for (int64_t frame = 0; frame < mChunkFrames; frame += kMaxCallbackFrames) {
+        int32_t count = static_cast<int32_t>(std::min(kMaxCallbackFrames, mChunkFrames - frame));
+        if (!mOnOutput(mBuffer.data() + frame * ch, count)) return false;
+    }
+    mFramesRendered += mChunkFrames;
+    mChunkStart += mChunkFrames;
+    mChunkFrames = 0;
+    return true;
+}
+
+bool OfflineRenderer::renderSegment(Worker& worker, float* pcm, int64_t start, int64_t numFrames,
+                                    int64_t prerollFrames) {
+    AudioEngine& engine = *worker.engine;
+    const int32_t ch = mChannelCount;
+
+    // Warm up on the audio before the segment and throw the result away
+    for (int64_t frame = 0; frame < prerollFrames; frame += mBlockFrames) {
+        if (mCancelled.load()) return false;
+        int32_t count = static_cast<int32_t>(std::min<int64_t>(mBlockFrames, prerollFrames - frame));
+        engine.processAudio(worker.preroll.data() + frame * ch, count, ch);
+    }
+
+    for (int64_t frame = 0; frame < numFrames; frame += mBlockFrames) {
+        if (mCancelled.load()) return false;
+        int32_t count = static_cast<int32_t>(std::min<int64_t>(mBlockFrames, numFrames - frame));
+        engine.processAudio(pcm + frame * ch, count, ch);
+    }
+    worker.position = start + numFrames;
+    return true;
+}
+
+} // namespace euphoriae
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef EUPHORIAE_OFFLINE_RENDERER_H
+#define EUPHORIAE_OFFLINE_RENDERER_H
+
+#include "audio_engine.h"
+#include "thread_pool.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace euphoriae {
+
+/**
+ * OfflineRenderer - Runs a whole stream through the effect chain as fast as the cores allow
+ *
+ * Input is collected into chunks of one segment per worker. Every worker owns
+ * an engine with the template's settings and renders its segment after
+ * pre-rolling the audio just before it, so filters, reverb tails and the
+ * leveler reach the state a continuous run would have at that point. The
+ * pre-roll is AudioEngine::settleFrames() long; segments are several times
+ * that, which bounds the extra work. With one thread the engine runs straight
+ * through and the output matches realtime processing exactly.
+ *
+ * Segment boundaries and processing blocks fall on 100 ms multiples, the
+ * loudness meter's step, so block-rate decisions line up across segments.
+ */
+class OfflineRenderer {
+public:
+    // Rendered frames in stream order; return false to stop
+    using OutputCallback = std::function<bool(const float* pcm, int32_t numFrames)>;
+
+    // numThreads <= 0 uses every hardware thread
+    OfflineRenderer(const AudioEngine& settings, int32_t sampleRate, int32_t channelCount,
+                    OutputCallback onOutput, const std::atomic<bool>& cancelled,
+                    int32_t numThreads = 0);
+
+    // Interleaved input; false once cancelled or the output callback stopped
+    bool push(const float* pcm, int64_t numFrames);
+
+    // Renders what is still buffered; call once after the last push
+    bool finish();
+
+    int64_t framesRendered() const { return mFramesRendered; }
+    int64_t warmupFrames() const { return mWarmupFrames; }
+
+private:
+    struct Worker {
+        std::unique_ptr<AudioEngine> engine;
+        std::vector<float> preroll;  // Copy of the input before its segment
+        int64_t position = 0;        // Stream frame the engine's state corresponds to
+    };
+
+    bool renderChunk();
+    bool renderSegment(Worker& worker, float* pcm, int64_t start, int64_t numFrames,
+                       int64_t prerollFrames);
+
+    const int32_t mChannelCount;
+    const OutputCallback mOnOutput;
+    const std::atomic<bool>& mCancelled;
+
+    int32_t mBlockFrames = 0;
+    int64_t mWarmupFrames = 0;
+    int64_t mSegmentFrames = 0;
+
+    ThreadPool mPool;
+    std::vector<Worker> mWorkers;
+
+    std::vector<float> mBuffer;   // One segment per worker, rendered in place
+    std::vector<float> mHistory;  // Input just before the chunk, right-aligned
+    int64_t mHistoryFrames = 0;
+    int64_t mChunkFrames = 0;
+    int64_t mChunkStart = 0;  // Stream frame of the chunk's first frame
+    int64_t mFramesRendered = 0;
+    bool mFailed = false;
+};
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_OFFLINE_RENDERER_H
@@ -0,0 +1,345 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "pcm_file.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace euphoriae {
+
+namespace {
+
+constexpr uint16_t kFormatPcm = 1;
+constexpr uint16_t kFormatFloat = 3;
+constexpr uint16_t kFormatExtensible = 0xFFFE;
+constexpr uint32_t kSizeInDs64 = 0xFFFFFFFFu;
+
+constexpr size_t kWindowBytes = 16 << 20;
+constexpr int32_t kHeaderBytes = 80;  // RIFF + JUNK/ds64 + fmt + data header; keeps float data 16-byte aligned
+constexpr int32_t kDs64Bytes = 28;
+
+// WAV is little-endian, as are all targets
+uint16_t readU16(const uint8_t* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+uint32_t readU32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24); }
+uint64_t readU64(const uint8_t* p) { return readU32(p) | (static_cast<uint64_t>(readU32(p + 4)) << 32); }
+
+void writeU16(uint8_t* p, uint16_t v) { p[0] = v & 0xFF; p[1] = v >> 8; }
+void writeU32(uint8_t* p, uint32_t v) { for (int i = 0; i < 4; i++) p[i] = (v >> (8 * i)) & 0xFF; }
+void writeU64(uint8_t* p, uint64_t v) { writeU32(p, static_cast<uint32_t>(v)); writeU32(p + 4, static_cast<uint32_t>(v >> 32)); }
+
+int64_t pageSize() {
+    static const int64_t size = sysconf(_SC_PAGESIZE);
+    return size;
+}
+
+bool readAt(int fd, int64_t offset, void* out, size_t bytes) {
+    return pread(fd, out, bytes, offset) == static_cast<ssize_t>(bytes);
+}
+
+} // namespace
+
+int32_t bytesPerSample(SampleFormat format) {
+    switch (format) {
+        case SampleFormat::kInt16: return 2;
+        case SampleFormat::kInt24: return 3;
+        case SampleFormat::kInt32:
+        case SampleFormat::kFloat32:
+        default: return 4;
+    }
+}
+
+// ================== PcmReader ==================
+
+std::unique_ptr<PcmReader> PcmReader::open(const char* path) {
+    if (path == nullptr) return nullptr;
+    std::unique_ptr<PcmReader> reader(new PcmReader());
+    reader->mFd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (reader->mFd < 0) return nullptr;
+    const int fd = reader->mFd;
+
+    struct stat info {};
+    if (fstat(fd, &info) != 0) return nullptr;
+    const int64_t fileSize = info.st_size;
+
+    uint8_t riff[12];
+    if (!readAt(fd, 0, riff, sizeof(riff))) return nullptr;
+    const bool rf64 = std::memcmp(riff, "RF64", 4) == 0;
+    if ((!rf64 && std::memcmp(riff, "RIFF", 4) != 0) || std::memcmp(riff + 8, "WAVE", 4) != 0) return nullptr;
+
+    uint64_t ds64DataSize = 0;
+    bool haveFormat = false;
+    int64_t offset = 12;
+    uint8_t header[8];
+    while (offset + 8 <= fileSize && readAt(fd, offset, header, sizeof(header))) {
+        uint64_t size = readU32(header + 4);
+        offset += 8;
+
+        if (std::memcmp(header, "ds64", 4) == 0 && size >= 24) {
+            uint8_t ds64[24];
+            if (!readAt(fd, offset, ds64, sizeof(ds64))) return nullptr;
+            ds64DataSize = readU64(ds64 + 8);
+        } else if (std::memcmp(header, "fmt ", 4) == 0) {
+            uint8_t fmt[40] = {};
+            if (size < 16 || !readAt(fd, offset, fmt, std::min<uint64_t>(size, sizeof(fmt)))) return nullptr;
+            uint16_t tag = readU16(fmt);
+            if (tag == kFormatExtensible && size >= 26) tag = readU16(fmt + 24);  // Sub-format GUID
+            const int32_t channels = readU16(fmt + 2);
+            const int32_t rate = static_cast<int32_t>(readU32(fmt + 4));
+            const int32_t bits = readU16(fmt + 14);
+
+            if (tag == kFormatFloat && bits == 32) reader->mFormat = SampleFormat::kFloat32;
+            else if (tag == kFormatPcm && bits == 16) reader->mFormat = SampleFormat::kInt16;
+            else if (tag == kFormatPcm && bits == 24) reader->mFormat = SampleFormat::kInt24;
+            else if (tag == kFormatPcm && bits == 32) reader->mFormat = SampleFormat::kInt32;
+            else return nullptr;
+            if (channels <= 0 || rate <= 0) return nullptr;
+
+            reader->mChannelCount = channels;
+            reader->mSampleRate = rate;
+            reader->mFrameBytes = channels * bytesPerSample(reader->mFormat);
+            haveFormat = true;
+        } else if (std::memcmp(header, "data", 4) == 0) {
+            if (!haveFormat) return nullptr;
+            if (rf64 && size == kSizeInDs64) size = ds64DataSize;
+            // Files cut short (or still being written) have a data size past the end
+            size = std::min<uint64_t>(size, static_cast<uint64_t>(fileSize - offset));
+            reader->mDataOffset = offset;
+            reader->mNumFrames = static_cast<int64_t>(size / reader->mFrameBytes);
+            return reader;
+        }
+        offset += static_cast<int64_t>(size + (size & 1));
+    }
+    return nullptr;
+}
+
+PcmReader::~PcmReader() {
+    if (mWindow != nullptr) munmap(mWindow, mWindowSize);
+    if (mFd >= 0) close(mFd);
+}
+
+void PcmReader::seek(int64_t frame) {
+    mPosition = std::clamp<int64_t>(frame, 0, mNumFrames);
+}
+
+const uint8_t* PcmReader::mapFrames(int32_t numFrames) {
+    const int64_t start = mDataOffset + mPosition * mFrameBytes;
+    const int64_t end = start + static_cast<int64_t>(numFrames) * mFrameBytes;
+    if (mWindow == nullptr || start < mWindowOffset ||
+        end > mWindowOffset + static_cast<int64_t>(mWindowSize)) {
+        if (mWindow != nullptr) munmap(mWindow, mWindowSize);
+        mWindowOffset = start / pageSize() * pageSize();
+        const int64_t dataEnd = mDataOffset + mNumFrames * mFrameBytes;
+        mWindowSize = static_cast<size_t>(std::min<int64_t>(std::max<int64_t>(kWindowBytes, end - mWindowOffset),
+                                                            dataEnd - mWindowOffset));
+        mWindow = mmap(nullptr, mWindowSize, PROT_READ, MAP_PRIVATE, mFd, mWindowOffset);
+        if (mWindow == MAP_FAILED) {
+            mWindow = nullptr;
+            return nullptr;
+        }
+        madvise(mWindow, mWindowSize, MADV_SEQUENTIAL);
+    }
+    return static_cast<const uint8_t*>(mWindow) + (start - mWindowOffset);
+}
+
+const float* PcmReader::mapFloatFrames(int32_t maxFrames, int32_t* numFrames) {
+    *numFrames = 0;
+    if (mFormat != SampleFormat::kFloat32 || mDataOffset % alignof(float) != 0) return nullptr;
+
+    int32_t count = static_cast<int32_t>(std::min<int64_t>({maxFrames, mNumFrames - mPosition,
+                                                            static_cast<int64_t>(kWindowBytes / mFrameBytes)}));
+    if (count <= 0) return nullptr;
+    const uint8_t* bytes = mapFrames(count);
+    if (bytes == nullptr) return nullptr;
+    mPosition += count;
+    *numFrames = count;
+    return reinterpret_cast<const float*>(bytes);
+}
+
+int32_t PcmReader::read(float* frames, int32_t maxFrames) {
+    int32_t count = static_cast<int32_t>(std::min<int64_t>({maxFrames, mNumFrames - mPosition,
+                                                            static_cast<int64_t>(kWindowBytes / mFrameBytes)}));
+    if (count <= 0) return 0;
+    const uint8_t* bytes = mapFrames(count);
+    if (bytes == nullptr) return 0;
+    mPosition += count;
+
+    const int32_t numSamples = count * mChannelCount;
+    switch (mFormat) {
+        case SampleFormat::kInt16:
+            for (int32_t i = 0; i < numSamples; i++) {
+                frames[i] = static_cast<int16_t>(readU16(bytes + i * 2)) * (1.0f / 32768.0f);
+            }
+            break;
+        case SampleFormat::kInt24:
+            for (int32_t i = 0; i < numSamples; i++) {
+                const uint8_t* p = bytes + i * 3;
+                int32_t v = static_cast<int32_t>((p[0] << 8) | (p[1] << 16) | (static_cast<uint32_t>(p[2]) << 24)) >> 8;
+                frames[i] = v * (1.0f / 8388608.0f);
+            }
+            break;
+        case SampleFormat::kInt32:
+            for (int32_t i = 0; i < numSamples; i++) {
+                frames[i] = static_cast<float>(static_cast<int32_t>(readU32(bytes + i * 4)) * (1.0 / 2147483648.0));
+            }
+            break;
+        case SampleFormat::kFloat32:
+            std::memcpy(frames, bytes, static_cast<size_t>(numSamples) * sizeof(float));
+            break;
+    }
+    return count;
+}
+
+// ================== PcmWriter ==================
+
+std::unique_ptr<PcmWriter> PcmWriter::create(const char* path, int32_t sampleRate,
+                                             int32_t channelCount, SampleFormat format) {
+    if (path == nullptr || sampleRate <= 0 || channelCount <= 0 || channelCount > 0xFFFF) return nullptr;
+    std::unique_ptr<PcmWriter> writer(new PcmWriter());
+    writer->mFd = ::open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (writer->mFd < 0) return nullptr;
+    writer->mSampleRate = sampleRate;
+    writer->mChannelCount = channelCount;
+    writer->mFormat = format;
+    writer->mFrameBytes = channelCount * bytesPerSample(format);
+    return writer;
+}
+
+PcmWriter::~PcmWriter() {
+    close();
+}
+
+bool PcmWriter::mapWindow() {
+    if (!unmapWindow()) return false;
+    const int64_t cursor = kHeaderBytes + mDataBytes;
+    mWindowOffset = cursor / pageSize() * pageSize();
+    mWindowSize = kWindowBytes;
+    mWindowUsed = static_cast<size_t>(cursor - mWindowOffset);
+
+    // Reserve the blocks first: running out of space then fails here, not as SIGBUS on a store
+    if (posix_fallocate(mFd, mWindowOffset, static_cast<off_t>(mWindowSize)) != 0) return false;
+    void* mapping = mmap(nullptr, mWindowSize, PROT_READ | PROT_WRITE, MAP_SHARED, mFd, mWindowOffset);
+    if (mapping == MAP_FAILED) return false;
+    mWindow = static_cast<uint8_t*>(mapping);
+    return true;
+}
+
+bool PcmWriter::unmapWindow() {
+    if (mWindow == nullptr) return true;
+    bool ok = munmap(mWindow, mWindowSize) == 0;
+    mWindow = nullptr;
+    return ok;
+}
+
+bool PcmWriter::write(const float* frames, int32_t numFrames) {
+    if (mFd < 0 || mFailed) return false;
+    if (numFrames <= 0) return true;
+
+    const size_t numSamples = static_cast<size_t>(numFrames) * mChannelCount;
+    const uint8_t* source = reinterpret_cast<const uint8_t*>(frames);
+    if (mFormat != SampleFormat::kFloat32) {
+        mConverted.resize(numSamples * bytesPerSample(mFormat));
+        uint8_t* out = mConverted.data();
+        // Same scale as reading (2^(bits-1)), so integer files round-trip exactly; +1.0 clips one step short
+        for (size_t i = 0; i < numSamples; i++) {
+            const double s = frames[i];
+            switch (mFormat) {
+                case SampleFormat::kInt16: {
+                    int32_t v = static_cast<int32_t>(std::clamp(std::lrint(s * 32768.0), -32768L, 32767L));
+                    writeU16(out + i * 2, static_cast<uint16_t>(v));
+                    break;
+                }
+                case SampleFormat::kInt24: {
+                    int32_t v = static_cast<int32_t>(std::clamp(std::lrint(s * 8388608.0), -8388608L, 8388607L));
+                    out[i * 3] = v & 0xFF;
+                    out[i * 3 + 1] = (v >> 8) & 0xFF;
+                    out[i * 3 + 2] = (v >> 16) & 0xFF;
+                    break;
+                }
+                default: {
+                    int64_t v = std::clamp<int64_t>(std::llrint(s * 2147483648.0), INT32_MIN, INT32_MAX);
+                    writeU32(out + i * 4, static_cast<uint32_t>(v));
+                    break;
+                }
+            }
+        }
+        source = out;
+    }
+
+    // Frames may straddle windows; copy bytes window by window
+    size_t remaining = numSamples * bytesPerSample(mFormat);
+    while (remaining > 0) {
+        if (mWindow == nullptr || mWindowUsed == mWindowSize) {
+            if (!mapWindow()) {
+                mFailed = true;
+                return false;
+            }
+        }
+        size_t count = std::min(remaining, mWindowSize - mWindowUsed);
+        std::memcpy(mWindow + mWindowUsed, source, count);
+        mWindowUsed += count;
+        mDataBytes += static_cast<int64_t>(count);
+        source += count;
+        remaining -= count;
+    }
+    return true;
+}
+
+bool PcmWriter::close() {
+    if (mFd < 0) return false;
+    bool ok = !mFailed && unmapWindow();
+
+    // Data chunks are padded to an even size
+    const int64_t padded = mDataBytes + (mDataBytes & 1);
+    const bool rf64 = kHeaderBytes - 8 + padded > 0xFFFFFFFFll;
+    const uint16_t bits = static_cast<uint16_t>(bytesPerSample(mFormat) * 8);
+
+    uint8_t header[kHeaderBytes] = {};
+    std::memcpy(header, rf64 ? "RF64" : "RIFF", 4);
+    writeU32(header + 4, rf64 ? kSizeInDs64 : static_cast<uint32_t>(kHeaderBytes - 8 + padded));
+    std::memcpy(header + 8, "WAVE", 4);
+    std::memcpy(header + 12, rf64 ? "ds64" : "JUNK", 4);
+    writeU32(header + 16, kDs64Bytes);
+    if (rf64) {
+        writeU64(header + 20, static_cast<uint64_t>(kHeaderBytes - 8 + padded));
+        writeU64(header + 28, static_cast<uint64_t>(mDataBytes));
+        writeU64(header + 36, static_cast<uint64_t>(mDataBytes / mFrameBytes));
+    }
+    std::memcpy(header + 48, "fmt ", 4);
+    writeU32(header + 52, 16);
+    writeU16(header + 56, mFormat == SampleFormat::kFloat32 ? kFormatFloat : kFormatPcm);
+    writeU16(header + 58, static_cast<uint16_t>(mChannelCount));
+    writeU32(header + 60, static_cast<uint32_t>(mSampleRate));
+    writeU32(header + 64, static_cast<uint32_t>(mSampleRate) * mFrameBytes);
+    writeU16(header + 68, static_cast<uint16_t>(mFrameBytes));
+    writeU16(header + 70, bits);
+    std::memcpy(header + 72, "data", 4);
+    writeU32(header + 76, rf64 ? kSizeInDs64 : static_cast<uint32_t>(mDataBytes));
+
+    ok = ok && pwrite(mFd, header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header));
+    // Drop the unused reservation of the last window; a pad byte reads back as zero
+    ok = ok && ftruncate(mFd, kHeaderBytes + padded) == 0;
+    ok = (::close(mFd) == 0) && ok;
+    mFd = -1;
+    return ok;
+}
+
+} // namespace euphoriae
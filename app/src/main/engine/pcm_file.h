@@ -0,0 +1,133 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef EUPHORIAE_PCM_FILE_H
+#define EUPHORIAE_PCM_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace euphoriae {
+
+enum class SampleFormat { kInt16, kInt24, kInt32, kFloat32 };
+
+int32_t bytesPerSample(SampleFormat format);
+
+/**
+ * PcmReader - Memory-mapped WAV / RF64 reader
+ *
+ * Only a window of the file is mapped at a time and it slides forward as the
+ * file is read, so arbitrarily large files stream in constant memory and
+ * address space. Float files are read without copying: mapFloatFrames() hands
+ * out pointers straight into the mapping.
+ */
+class PcmReader {
+public:
+    // nullptr if the file is missing, malformed or in an unsupported format
+    static std::unique_ptr<PcmReader> open(const char* path);
+
+    ~PcmReader();
+    PcmReader(const PcmReader&) = delete;
+    PcmReader& operator=(const PcmReader&) = delete;
+
+    int32_t sampleRate() const { return mSampleRate; }
+    int32_t channelCount() const { return mChannelCount; }
+    SampleFormat format() const { return mFormat; }
+    int64_t numFrames() const { return mNumFrames; }
+    int64_t position() const { return mPosition; }
+
+    void seek(int64_t frame);
+
+    // Converts up to maxFrames interleaved frames at the read position; 0 at the end
+    int32_t read(float* frames, int32_t maxFrames);
+
+    // Zero-copy read of float files: up to maxFrames frames at the read position,
+    // valid until the next read, map or seek. nullptr for other formats.
+    const float* mapFloatFrames(int32_t maxFrames, int32_t* numFrames);
+
+private:
+    PcmReader() = default;
+
+    // Points the window at the bytes of numFrames frames from the read position
+    const uint8_t* mapFrames(int32_t numFrames);
+
+    int mFd = -1;
+    int64_t mDataOffset = 0;
+    int32_t mSampleRate = 0;
+    int32_t mChannelCount = 0;
+    int32_t mFrameBytes = 0;
+    SampleFormat mFormat = SampleFormat::kInt16;
+    int64_t mNumFrames = 0;
+    int64_t mPosition = 0;
+
+    void* mWindow = nullptr;
+    size_t mWindowSize = 0;
+    int64_t mWindowOffset = 0;  // File offset of the mapping, page aligned
+};
+
+/**
+ * PcmWriter - Memory-mapped WAV writer that switches to RF64 past 4 GB
+ *
+ * Space is reserved and mapped a window at a time. A JUNK chunk after the
+ * RIFF header becomes the ds64 chunk if the data outgrows 32-bit sizes
+ * (EBU Tech 3306), so the header never has to move.
+ */
+class PcmWriter {
+public:
+    // nullptr if the file cannot be created
+    static std::unique_ptr<PcmWriter> create(const char* path, int32_t sampleRate,
+                                             int32_t channelCount, SampleFormat format);
+
+    ~PcmWriter();
+    PcmWriter(const PcmWriter&) = delete;
+    PcmWriter& operator=(const PcmWriter&) = delete;
+
+    // Interleaved frames, clipped and rounded to the file format
+    bool write(const float* frames, int32_t numFrames);
+
+    // Writes the final header and trims the file; false if anything failed
+    bool close();
+
+    int64_t numFrames() const { return mDataBytes / mFrameBytes; }
+
+private:
+    PcmWriter() = default;
+
+    bool mapWindow();
+    bool unmapWindow();
+
+    int mFd = -1;
+    int32_t mSampleRate = 0;
+    int32_t mChannelCount = 0;
+    int32_t mFrameBytes = 0;
+    SampleFormat mFormat = SampleFormat::kInt16;
+    int64_t mDataBytes = 0;
+    bool mFailed = false;
+
+    uint8_t* mWindow = nullptr;
+    size_t mWindowSize = 0;
+    int64_t mWindowOffset = 0;  // File offset of the mapping
+    size_t mWindowUsed = 0;
+
+    std::vector<uint8_t> mConverted;  // Integer samples on their way into the window
+};
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_PCM_FILE_H
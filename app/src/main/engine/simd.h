@@ -0,0 +1,197 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EUPHORIAE_SIMD_H
+#define EUPHORIAE_SIMD_H
+
+#include <cmath>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define EUPHORIAE_SIMD_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define EUPHORIAE_SIMD_SSE 1
+#endif
+
+namespace euphoriae {
+namespace simd {
+
+/**
+ * float4 - Four packed floats mapped onto NEON or SSE registers
+ *
+ * Every ABI we ship (armeabi-v7a, arm64-v8a, x86, x86_64) has one of the two,
+ * the scalar fallback only exists so host tools build anywhere.
+ */
+#if defined(EUPHORIAE_SIMD_NEON)
+
+using float4 = float32x4_t;
+
+inline float4 load(const float* p) { return vld1q_f32(p); }
+inline void store(float* p, float4 v) { vst1q_f32(p, v); }
+inline float4 set1(float x) { return vdupq_n_f32(x); }
+inline float4 add(float4 a, float4 b) { return vaddq_f32(a, b); }
+inline float4 sub(float4 a, float4 b) { return vsubq_f32(a, b); }
+inline float4 mul(float4 a, float4 b) { return vmulq_f32(a, b); }
+inline float4 abs(float4 v) { return vabsq_f32(v); }
+inline float4 max(float4 a, float4 b) { return vmaxq_f32(a, b); }
+inline float4 min(float4 a, float4 b) { return vminq_f32(a, b); }
+
+// acc + a * b
+inline float4 mulAdd(float4 acc, float4 a, float4 b) {
+#if defined(__aarch64__)
+    return vfmaq_f32(acc, a, b);
+#else
+    return vmlaq_f32(acc, a, b);
+#endif
+}
+
+// acc - a * b
+inline float4 mulSub(float4 acc, float4 a, float4 b) {
+#if defined(__aarch64__)
+    return vfmsq_f32(acc, a, b);
+#else
+    return vmlsq_f32(acc, a, b);
+#endif
+}
+
+// p[4 * i + k] = lane i of the k-th vector (4x4 transpose on store)
+inline void store4Interleaved(float* p, float4 a, float4 b, float4 c, float4 d) {
+    float32x4x4_t v = {{a, b, c, d}};
+    vst4q_f32(p, v);
+}
+
+// Split p[0..7] into even and odd elements
+inline void load2Deinterleaved(const float* p, float4& even, float4& odd) {
+    float32x4x2_t v = vld2q_f32(p);
+    even = v.val[0];
+    odd = v.val[1];
+}
+
+inline void store2Interleaved(float* p, float4 even, float4 odd) {
+    float32x4x2_t v = {{even, odd}};
+    vst2q_f32(p, v);
+}
+
+inline float4 reverse(float4 v) {
+    float32x4_t r = vrev64q_f32(v);
+    return vcombine_f32(vget_high_f32(r), vget_low_f32(r));
+}
+
+#elif defined(EUPHORIAE_SIMD_SSE)
+
+using float4 = __m128;
+
+inline float4 load(const float* p) { return _mm_loadu_ps(p); }
+inline void store(float* p, float4 v) { _mm_storeu_ps(p, v); }
+inline float4 set1(float x) { return _mm_set1_ps(x); }
+inline float4 add(float4 a, float4 b) { return _mm_add_ps(a, b); }
+inline float4 sub(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+inline float4 mul(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+inline float4 abs(float4 v) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), v); }
+inline float4 max(float4 a, float4 b) { return _mm_max_ps(a, b); }
+inline float4 min(float4 a, float4 b) { return _mm_min_ps(a, b); }
+inline float4 mulAdd(float4 acc, float4 a, float4 b) { return _mm_add_ps(acc, _mm_mul_ps(a, b)); }
+inline float4 mulSub(float4 acc, float4 a, float4 b) { return _mm_sub_ps(acc, _mm_mul_ps(a, b)); }
+
+inline void store4Interleaved(float* p, float4 a, float4 b, float4 c, float4 d) {
+    _MM_TRANSPOSE4_PS(a, b, c, d);
+    _mm_storeu_ps(p, a);
+    _mm_storeu_ps(p + 4, b);
+    _mm_storeu_ps(p + 8, c);
+    _mm_storeu_ps(p + 12, d);
+}
+
+inline void load2Deinterleaved(const float* p, float4& even, float4& odd) {
+    __m128 lo = _mm_loadu_ps(p);
+    __m128 hi = _mm_loadu_ps(p + 4);
+    even = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+    odd = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+inline void store2Interleaved(float* p, float4 even, float4 odd) {
+    _mm_storeu_ps(p, _mm_unpacklo_ps(even, odd));
+    _mm_storeu_ps(p + 4, _mm_unpackhi_ps(even, odd));
+}
+
+inline float4 reverse(float4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 1, 2, 3)); }
+
+#else
+
+struct float4 {
+    float v[4];
+};
+
+inline float4 load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline void store(float* p, float4 a) { for (int i = 0; i < 4; i++) p[i] = a.v[i]; }
+inline float4 set1(float x) { return {{x, x, x, x}}; }
+inline float4 add(float4 a, float4 b) {
+    return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+}
+inline float4 sub(float4 a, float4 b) {
+    return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}};
+}
+inline float4 mul(float4 a, float4 b) {
+    return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+}
+inline float4 mulAdd(float4 acc, float4 a, float4 b) { return add(acc, mul(a, b)); }
+inline float4 mulSub(float4 acc, float4 a, float4 b) { return sub(acc, mul(a, b)); }
+inline float4 abs(float4 a) {
+    return {{std::fabs(a.v[0]), std::fabs(a.v[1]), std::fabs(a.v[2]), std::fabs(a.v[3])}};
+}
+inline float4 max(float4 a, float4 b) {
+    return {{std::fmax(a.v[0], b.v[0]), std::fmax(a.v[1], b.v[1]), std::fmax(a.v[2], b.v[2]), std::fmax(a.v[3], b.v[3])}};
+}
+inline float4 min(float4 a, float4 b) {
+    return {{std::fmin(a.v[0], b.v[0]), std::fmin(a.v[1], b.v[1]), std::fmin(a.v[2], b.v[2]), std::fmin(a.v[3], b.v[3])}};
+}
+
+inline void store4Interleaved(float* p, float4 a, float4 b, float4 c, float4 d) {
+    for (int i = 0; i < 4; i++) {
+        p[4 * i] = a.v[i];
+        p[4 * i + 1] = b.v[i];
+        p[4 * i + 2] = c.v[i];
+        p[4 * i + 3] = d.v[i];
+    }
+}
+
+inline void load2Deinterleaved(const float* p, float4& even, float4& odd) {
+    even = {{p[0], p[2], p[4], p[6]}};
+    odd = {{p[1], p[3], p[5], p[7]}};
+}
+
+inline void store2Interleaved(float* p, float4 even, float4 odd) {
+    for (int i = 0; i < 4; i++) {
+        p[2 * i] = even.v[i];
+        p[2 * i + 1] = odd.v[i];
+    }
+}
+
+inline float4 reverse(float4 a) { return {{a.v[3], a.v[2], a.v[1], a.v[0]}}; }
+
+#endif
+
+// Horizontal sum of all four lanes
+inline float sum(float4 v) {
+    float lanes[4];
+    store(lanes, v);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+} // namespace simd
+} // namespace euphoriae
+
+#endif // EUPHORIAE_SIMD_H
@@ -0,0 +1,173 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "spectrum_analyzer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace euphoriae {
+
+namespace {
+
+constexpr float kMinFrequency = 40.0f;
+constexpr float kMaxFrequency = 16000.0f;
+constexpr float kFloorDb = -70.0f;
+constexpr float kRelease = 0.85f;  // Per analysis, ~60 per second
+constexpr auto kAnalysisInterval = std::chrono::milliseconds(16);
+
+} // namespace
+
+SpectrumAnalyzer::SpectrumAnalyzer(int32_t sampleRate) : mSampleRate(sampleRate) {
+    mWindow.resize(kFftSize);
+    for (int32_t i = 0; i < kFftSize; i++) {
+        mWindow[i] = 0.5f - 0.5f * std::cos(2.0f * static_cast<float>(M_PI) * i / kFftSize);
+    }
+    mHistory.assign(kFftSize, 0.0f);
+    mScratch.assign(kRingCapacity, 0.0f);
+    mSpectrum.assign(kFftSize, 0.0f);
+    computeBandEdges(sampleRate);
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer() {
+    setEnabled(false);
+}
+
+void SpectrumAnalyzer::setSampleRate(int32_t sampleRate) {
+    if (sampleRate > 0) mSampleRate.store(sampleRate, std::memory_order_relaxed);
+}
+
+void SpectrumAnalyzer::computeBandEdges(int32_t sampleRate) {
+    // Log-spaced band edges in FFT bins, each band at least one bin wide
+    const int32_t lastBin = kFftSize / 2 - 1;
+    const float maxFrequency = std::min(kMaxFrequency, sampleRate * 0.45f);
+    const float binWidth = static_cast<float>(sampleRate) / kFftSize;
+    mBandEdges.resize(kNumBands + 1);
+    for (int32_t b = 0; b <= kNumBands; b++) {
+        float frequency = kMinFrequency * std::pow(maxFrequency / kMinFrequency, static_cast<float>(b) / kNumBands);
+        int32_t bin = static_cast<int32_t>(std::lround(frequency / binWidth));
+        if (b > 0) bin = std::max(bin, mBandEdges[b - 1] + 1);
+        mBandEdges[b] = std::clamp(bin, 1, lastBin + 1);
+    }
+    mBandEdgesRate = sampleRate;
+}
+
+void SpectrumAnalyzer::setEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(mControlMutex);
+    if (enabled == mEnabled.load()) return;
+
+    if (enabled) {
+        std::fill(std::begin(mSmoothed), std::end(mSmoothed), 0.0f);
+        std::fill(mHistory.begin(), mHistory.end(), 0.0f);
+        mEnabled.store(true);
+        mThread = std::thread(&SpectrumAnalyzer::run, this);
+    } else {
+        mEnabled.store(false);
+        if (mThread.joinable()) mThread.join();
+        std::lock_guard<std::mutex> bandsLock(mBandsMutex);
+        mHasBands = false;
+    }
+}
+
+void SpectrumAnalyzer::push(const float* buffer, int32_t numFrames, int32_t channelCount) {
+    if (!mEnabled.load(std::memory_order_relaxed) || channelCount <= 0 || numFrames <= 0) return;
+    mChannelCount.store(channelCount, std::memory_order_relaxed);
+
+    // Whole frames only, so the worker never loses track of the interleaving
+    uint32_t frames = std::min(static_cast<uint32_t>(numFrames), mRing.writable() / channelCount);
+    mRing.write(buffer, frames * channelCount);
+}
+
+bool SpectrumAnalyzer::getBands(float* bands, int32_t numBands) const {
+    std::lock_guard<std::mutex> lock(mBandsMutex);
+    if (!mHasBands) return false;
+    std::copy(mBands, mBands + std::min(numBands, kNumBands), bands);
+    return true;
+}
+
+void SpectrumAnalyzer::run() {
+    // Whatever was queued before the last stop is stale
+    mRing.discard();
+    while (mEnabled.load()) {
+        analyze();
+        std::this_thread::sleep_for(kAnalysisInterval);
+    }
+}
+
+void SpectrumAnalyzer::analyze() {
+    const int32_t channels = mChannelCount.load(std::memory_order_relaxed);
+    uint32_t available = mRing.readable();
+    available -= available % channels;
+    if (available == 0) return;
+
+    // Bands of the old rate would sit at the wrong frequencies; the smoothed
+    // levels of the old bands are dropped with them
+    const int32_t sampleRate = mSampleRate.load(std::memory_order_relaxed);
+    if (sampleRate != mBandEdgesRate) {
+        computeBandEdges(sampleRate);
+        std::fill(std::begin(mSmoothed), std::end(mSmoothed), 0.0f);
+    }
+
+    uint32_t count = mRing.read(mScratch.data(), available);
+    int32_t frames = static_cast<int32_t>(count) / channels;
+
+    // Slide the newest frames (downmixed) into the history
+    int32_t newFrames = std::min(frames, kFftSize);
+    const float* source = mScratch.data() + (frames - newFrames) * channels;
+    std::move(mHistory.begin() + newFrames, mHistory.end(), mHistory.begin());
+    float* tail = mHistory.data() + kFftSize - newFrames;
+    const float channelGain = 1.0f / channels;
+    for (int32_t i = 0; i < newFrames; i++) {
+        float sum = 0.0f;
+        for (int32_t ch = 0; ch < channels; ch++) {
+            sum += source[i * channels + ch];
+        }
+        tail[i] = sum * channelGain;
+    }
+
+    for (int32_t i = 0; i < kFftSize; i++) {
+        mSpectrum[i] = mHistory[i] * mWindow[i];
+    }
+    mFft.forwardInPlace(mSpectrum.data());
+
+    // A full-scale sine reads 0 dB: Hann coherent gain is 1/2, one-sided spectrum doubles
+    const float amplitudeScale = 4.0f / kFftSize;
+    const float powerScale = amplitudeScale * amplitudeScale;
+    float levels[kNumBands];
+    for (int32_t b = 0; b < kNumBands; b++) {
+        int32_t start = mBandEdges[b];
+        int32_t end = mBandEdges[b + 1];
+        float power = 0.0f;
+        for (int32_t k = start; k < end; k++) {
+            float re = mSpectrum[2 * k];
+            float im = mSpectrum[2 * k + 1];
+            power = std::max(power, re * re + im * im);
+        }
+        float db = 10.0f * std::log10(power * powerScale + 1e-12f);
+        float level = std::clamp((db - kFloorDb) / -kFloorDb, 0.0f, 1.0f);
+
+        // Fast attack, slow release
+        float& smoothed = mSmoothed[b];
+        smoothed = (level > smoothed) ? level : smoothed * kRelease + level * (1.0f - kRelease);
+        levels[b] = smoothed;
+    }
+
+    std::lock_guard<std::mutex> lock(mBandsMutex);
+    std::copy(levels, levels + kNumBands, mBands);
+    mHasBands = true;
+}
+
+} // namespace euphoriae
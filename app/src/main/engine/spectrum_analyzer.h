@@ -0,0 +1,90 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EUPHORIAE_SPECTRUM_ANALYZER_H
+#define EUPHORIAE_SPECTRUM_ANALYZER_H
+
+#include "fft.h"
+#include "spsc_ring.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace euphoriae {
+
+/**
+ * SpectrumAnalyzer - Log-spaced band levels of the processed output for visualizers
+ *
+ * The audio thread only copies its block into a lock-free ring. A worker
+ * thread, running while the analyzer is enabled, drains the ring, downmixes,
+ * takes a Hann-windowed FFT of the latest kFftSize frames about 60 times a
+ * second and smooths the band levels with fast attack and slow release.
+ */
+class SpectrumAnalyzer {
+public:
+    static constexpr int32_t kNumBands = 32;
+    static constexpr int32_t kFftSize = 2048;
+
+    explicit SpectrumAnalyzer(int32_t sampleRate);
+    ~SpectrumAnalyzer();
+
+    // Control thread: the worker recomputes the band edges before its next analysis
+    void setSampleRate(int32_t sampleRate);
+
+    // Control thread: starts or stops the worker thread
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return mEnabled.load(std::memory_order_relaxed); }
+
+    // Audio thread: one copy into the ring, frames that do not fit are dropped
+    void push(const float* buffer, int32_t numFrames, int32_t channelCount);
+
+    // Any thread: latest levels 0-1, lowest band first; false until the first analysis
+    bool getBands(float* bands, int32_t numBands) const;
+
+private:
+    void run();
+    void analyze();
+    void computeBandEdges(int32_t sampleRate);
+
+    static constexpr uint32_t kRingCapacity = 16384;  // ~170 ms of stereo at 48 kHz
+
+    SpscRing<float> mRing{kRingCapacity};
+    std::atomic<int32_t> mChannelCount{2};
+    std::atomic<int32_t> mSampleRate;
+    std::atomic<bool> mEnabled{false};
+    std::thread mThread;
+    std::mutex mControlMutex;  // Serializes setEnabled
+
+    // Worker thread only
+    RealFft mFft{kFftSize};
+    std::vector<float> mWindow;
+    std::vector<float> mHistory;   // Latest kFftSize mono frames
+    std::vector<float> mScratch;   // Interleaved samples drained from the ring
+    std::vector<float> mSpectrum;  // Packed FFT of the windowed history
+    std::vector<int32_t> mBandEdges;
+    int32_t mBandEdgesRate = 0;  // Rate mBandEdges were computed for
+    float mSmoothed[kNumBands] = {};
+
+    mutable std::mutex mBandsMutex;
+    float mBands[kNumBands] = {};
+    bool mHasBands = false;
+};
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_SPECTRUM_ANALYZER_H
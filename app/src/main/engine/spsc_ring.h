@@ -0,0 +1,112 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EUPHORIAE_SPSC_RING_H
+#define EUPHORIAE_SPSC_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace euphoriae {
+
+/**
+ * SpscRing - Lock-free single-producer/single-consumer ring of trivially copyable items
+ *
+ * Indices run freely and wrap through unsigned overflow; the capacity is a
+ * power of two so positions are masked instead of taken modulo. The producer
+ * never blocks: items that do not fit are the caller's to drop.
+ */
+template <typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRing copies items with memcpy");
+
+public:
+    // Capacity is rounded up to a power of two
+    explicit SpscRing(uint32_t capacity) {
+        uint32_t size = 1;
+        while (size < capacity) size <<= 1;
+        mBuffer.resize(size);
+        mMask = size - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    uint32_t capacity() const { return mMask + 1; }
+
+    // Producer: free slots (only grows until the producer writes again)
+    uint32_t writable() const {
+        return capacity() - (mWriteIndex.load(std::memory_order_relaxed) -
+                             mReadIndex.load(std::memory_order_acquire));
+    }
+
+    // Consumer: filled slots (only grows until the consumer reads again)
+    uint32_t readable() const {
+        return mWriteIndex.load(std::memory_order_acquire) -
+               mReadIndex.load(std::memory_order_relaxed);
+    }
+
+    // Producer: copies up to count items, returns how many fit
+    uint32_t write(const T* data, uint32_t count) {
+        uint32_t writeIndex = mWriteIndex.load(std::memory_order_relaxed);
+        count = std::min(count, writable());
+        copyIn(writeIndex & mMask, data, count);
+        mWriteIndex.store(writeIndex + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer: copies up to count items out, returns how many were read
+    uint32_t read(T* data, uint32_t count) {
+        uint32_t readIndex = mReadIndex.load(std::memory_order_relaxed);
+        count = std::min(count, readable());
+        copyOut(readIndex & mMask, data, count);
+        mReadIndex.store(readIndex + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer: drops everything written so far
+    void discard() {
+        mReadIndex.store(mWriteIndex.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+private:
+    void copyIn(uint32_t start, const T* data, uint32_t count) {
+        uint32_t first = std::min(count, capacity() - start);
+        std::memcpy(mBuffer.data() + start, data, first * sizeof(T));
+        std::memcpy(mBuffer.data(), data + first, (count - first) * sizeof(T));
+    }
+
+    void copyOut(uint32_t start, T* data, uint32_t count) const {
+        uint32_t first = std::min(count, capacity() - start);
+        std::memcpy(data, mBuffer.data() + start, first * sizeof(T));
+        std::memcpy(data + first, mBuffer.data(), (count - first) * sizeof(T));
+    }
+
+    std::vector<T> mBuffer;
+    uint32_t mMask = 0;
+
+    // Separate cache lines so producer and consumer do not false-share
+    alignas(64) std::atomic<uint32_t> mWriteIndex{0};
+    alignas(64) std::atomic<uint32_t> mReadIndex{0};
+};
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_SPSC_RING_H
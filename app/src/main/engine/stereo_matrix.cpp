@@ -0,0 +1,155 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "stereo_matrix.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+
+namespace euphoriae {
+
+namespace {
+
+// out.L = ll * L + lr * R, out.R = rl * L + rr * R over interleaved stereo,
+// with per-frame coefficients
+void mixStereo(float* buffer, int32_t numFrames, const float* ll, const float* lr, const float* rl,
+               const float* rr) {
+    int32_t i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        simd::float4 left;
+        simd::float4 right;
+        simd::load2Deinterleaved(buffer + i * 2, left, right);
+        simd::store2Interleaved(buffer + i * 2,
+                                simd::mulAdd(simd::mul(simd::load(ll + i), left), simd::load(lr + i), right),
+                                simd::mulAdd(simd::mul(simd::load(rl + i), left), simd::load(rr + i), right));
+    }
+    for (; i < numFrames; i++) {
+        const float left = buffer[i * 2];
+        const float right = buffer[i * 2 + 1];
+        buffer[i * 2] = ll[i] * left + lr[i] * right;
+        buffer[i * 2 + 1] = rl[i] * left + rr[i] * right;
+    }
+}
+
+} // namespace
+
+void StereoMatrix::setParameters(float virtualizer, float separation, float balance, int32_t rampFrames) {
+    // Settings within 1% of neutral are treated as off
+    if (virtualizer <= 0.01f) virtualizer = 0.0f;
+    if (std::abs(separation - 0.5f) <= 0.01f) separation = 0.5f;
+    if (std::abs(balance) <= 0.01f) balance = 0.0f;
+    if (virtualizer == mVirtualizer && separation == mSeparation && balance == mBalance) return;
+    mVirtualizer = virtualizer;
+    mSeparation = separation;
+    mBalance = balance;
+
+    // Virtualizer: L' = d * L - c * R, widening with strength
+    const float virtualDirect = 1.0f + virtualizer * 0.2f;
+    const float virtualCross = virtualizer * 0.5f;
+
+    // Separation scales the side signal: 0 = mono, 0.5 = unchanged, 1 = twice as wide
+    const float separationSide = 2.0f * separation;
+
+    // A symmetric mix [[d, c], [c, d]] scales mid by d + c and side by d - c
+    const float midGain = virtualDirect - virtualCross;
+    const float sideGain = (virtualDirect + virtualCross) * separationSide;
+    const float direct = 0.5f * (midGain + sideGain);
+    const float cross = 0.5f * (midGain - sideGain);
+
+    // Balance attenuates the opposite side linearly
+    const float leftGain = balance > 0.0f ? 1.0f - balance : 1.0f;
+    const float rightGain = balance < 0.0f ? 1.0f + balance : 1.0f;
+
+    const float ll = leftGain * direct;
+    const float lr = leftGain * cross;
+    const float rl = rightGain * cross;
+    const float rr = rightGain * direct;
+    mLL.follow(ll, rampFrames);
+    mLR.follow(lr, rampFrames);
+    mRL.follow(rl, rampFrames);
+    mRR.follow(rr, rampFrames);
+    mIdentity = ll == 1.0f && lr == 0.0f && rl == 0.0f && rr == 1.0f;
+}
+
+void StereoMatrix::process(float* buffer, int32_t numFrames) {
+    if (buffer == nullptr || isIdentity()) return;
+
+    // Ramping: per-frame coefficients a chunk at a time
+    int32_t frame = 0;
+    while (frame < numFrames && !isSettled()) {
+        const int32_t count = std::min(numFrames - frame, GainRamp::kChunkFrames);
+        alignas(16) float ll[GainRamp::kChunkFrames], lr[GainRamp::kChunkFrames];
+        alignas(16) float rl[GainRamp::kChunkFrames], rr[GainRamp::kChunkFrames];
+        mLL.render(ll, count);
+        mLR.render(lr, count);
+        mRL.render(rl, count);
+        mRR.render(rr, count);
+        mixStereo(buffer + frame * 2, count, ll, lr, rl, rr);
+        frame += count;
+    }
+    if (frame == numFrames || mIdentity) return;
+
+    const float cll = mLL.value();
+    const float clr = mLR.value();
+    const float crl = mRL.value();
+    const float crr = mRR.value();
+    const simd::float4 ll = simd::set1(cll);
+    const simd::float4 lr = simd::set1(clr);
+    const simd::float4 rl = simd::set1(crl);
+    const simd::float4 rr = simd::set1(crr);
+
+    int32_t i = frame;
+    for (; i + 4 <= numFrames; i += 4) {
+        simd::float4 left;
+        simd::float4 right;
+        simd::load2Deinterleaved(buffer + i * 2, left, right);
+        simd::store2Interleaved(buffer + i * 2,
+                                simd::mulAdd(simd::mul(ll, left), lr, right),
+                                simd::mulAdd(simd::mul(rl, left), rr, right));
+    }
+    for (; i < numFrames; i++) {
+        const float left = buffer[i * 2];
+        const float right = buffer[i * 2 + 1];
+        buffer[i * 2] = cll * left + clr * right;
+        buffer[i * 2 + 1] = crl * left + crr * right;
+    }
+}
+
+void StereoMatrix::processPairs(float* buffer, int32_t numFrames, int32_t frameStride, const int32_t* pairs,
+                                int32_t numPairs) {
+    if (buffer == nullptr || isIdentity()) return;
+    for (int32_t frame = 0; frame < numFrames; frame += GainRamp::kChunkFrames) {
+        const int32_t count = std::min(numFrames - frame, GainRamp::kChunkFrames);
+        alignas(16) float ll[GainRamp::kChunkFrames], lr[GainRamp::kChunkFrames];
+        alignas(16) float rl[GainRamp::kChunkFrames], rr[GainRamp::kChunkFrames];
+        mLL.render(ll, count);
+        mLR.render(lr, count);
+        mRL.render(rl, count);
+        mRR.render(rr, count);
+        for (int32_t p = 0; p < numPairs; p++) {
+            float* samples = buffer + static_cast<int64_t>(frame) * frameStride + pairs[p];
+            for (int32_t i = 0; i < count; i++, samples += frameStride) {
+                const float left = samples[0];
+                const float right = samples[1];
+                samples[0] = ll[i] * left + lr[i] * right;
+                samples[1] = rl[i] * left + rr[i] * right;
+            }
+        }
+    }
+}
+
+} // namespace euphoriae
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef EUPHORIAE_STEREO_MATRIX_H
+#define EUPHORIAE_STEREO_MATRIX_H
+
+#include "gain_ramp.h"
+#include <cstdint>
+
+namespace euphoriae {
+
+/**
+ * StereoMatrix - Virtualizer, channel separation and balance as one 2x2 mix
+ *
+ * Virtualizer and separation are symmetric, so they are composed as mid and
+ * side gains; balance then scales the output rows. The product is applied in
+ * one vectorized pass over interleaved stereo, and is only recomputed when a
+ * control changes. The coefficients then ramp to their new values, so a
+ * slider never steps the signal; settled, the matrix is constant again.
+ */
+class StereoMatrix {
+public:
+    // Audio thread, before process(): virtualizer 0-1, separation 0-1 (0.5 =
+    // unchanged), balance -1 to 1; a change ramps in over rampFrames
+    void setParameters(float virtualizer, float separation, float balance, int32_t rampFrames);
+
+    bool isIdentity() const { return mIdentity && isSettled(); }
+
+    // Interleaved stereo, in place
+    void process(float* buffer, int32_t numFrames);
+
+    // The left/right pairs of a wider stream, in place and with the same ramp:
+    // pairs holds the channel of each pair's left side, frames are frameStride
+    // samples apart
+    void processPairs(float* buffer, int32_t numFrames, int32_t frameStride, const int32_t* pairs,
+                      int32_t numPairs);
+
+private:
+    bool isSettled() const {
+        return mLL.isSettled() && mLR.isSettled() && mRL.isSettled() && mRR.isSettled();
+    }
+
+    float mVirtualizer = 0.0f;
+    float mSeparation = 0.5f;
+    float mBalance = 0.0f;
+
+    // out.L = mLL * L + mLR * R, out.R = mRL * L + mRR * R
+    GainRamp mLL{1.0f};
+    GainRamp mLR{0.0f};
+    GainRamp mRL{0.0f};
+    GainRamp mRR{1.0f};
+    bool mIdentity = true;  // Once settled
+};
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_STEREO_MATRIX_H
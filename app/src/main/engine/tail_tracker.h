@@ -0,0 +1,89 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef EUPHORIAE_TAIL_TRACKER_H
+#define EUPHORIAE_TAIL_TRACKER_H
+
+#include <cstdint>
+
+namespace euphoriae {
+
+/**
+ * TailTracker - Whether a stage with memory still has to run on silent input
+ *
+ * A block is silent when its energy (sum of squares over every sample) is
+ * below that of a single -120 dBFS sample. Signal rearms the tracker with the
+ * stage's worst-case tail, the time it takes to ring out from full scale.
+ * While the stage runs on silence, the tail ends early once its output has
+ * stayed silent for the stage's memory, its longest internal delay (an echo
+ * can still be in flight until then).
+ */
+class TailTracker {
+public:
+    static constexpr float kSilenceEnergy = 1e-12f;  // (-120 dBFS)^2
+
+    // NaN and infinity are never silent
+    static bool isSilent(float energy) { return energy < kSilenceEnergy; }
+
+    // Frames, at the current sample rate and settings; memoryFrames >= tailFrames
+    // means the tail is always run to the end
+    void setTail(int64_t tailFrames, int64_t memoryFrames) {
+        mTailFrames = tailFrames;
+        mMemoryFrames = memoryFrames;
+    }
+
+    // Before the stage: false when its input is silent and its tail has rung out
+    bool shouldProcess(bool inputSilent, int32_t numFrames) {
+        if (!inputSilent) {
+            mRemaining = mTailFrames;
+            mQuietFrames = 0;
+            return true;
+        }
+        if (mRemaining <= 0) return false;
+        mRemaining -= numFrames;
+        return true;
+    }
+
+    // After the stage ran on silent input, with the energy of its output;
+    // returns whether that output is silent
+    bool reportTail(float outputEnergy, int32_t numFrames) {
+        if (!isSilent(outputEnergy)) {
+            mQuietFrames = 0;
+            return false;
+        }
+        mQuietFrames += numFrames;
+        if (mQuietFrames >= mMemoryFrames) mRemaining = 0;
+        return true;
+    }
+
+    int64_t remainingFrames() const { return mRemaining > 0 ? mRemaining : 0; }
+
+    void reset() {
+        mRemaining = 0;
+        mQuietFrames = 0;
+    }
+
+private:
+    int64_t mTailFrames = 0;
+    int64_t mMemoryFrames = 0;
+    int64_t mRemaining = 0;
+    int64_t mQuietFrames = 0;
+};
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_TAIL_TRACKER_H
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "thread_pool.h"
+#include <algorithm>
+#include <sys/resource.h>
+
+namespace euphoriae {
+
+namespace {
+
+// Index of the pool worker running on this thread, -1 elsewhere
+thread_local int32_t tWorkerIndex = -1;
+thread_local const ThreadPool* tWorkerPool = nullptr;
+
+} // namespace
+
+ThreadPool::ThreadPool(int32_t numThreads, int32_t niceness) : mNiceness(niceness) {
+    if (numThreads <= 0) {
+        numThreads = static_cast<int32_t>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    for (int32_t i = 0; i < numThreads; i++) {
+        mQueues.push_back(std::make_unique<Queue>());
+    }
+    for (int32_t i = 0; i < numThreads; i++) {
+        mWorkers.emplace_back(&ThreadPool::run, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWorkAvailable.notify_all();
+    for (std::thread& worker : mWorkers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(Task task) {
+    int32_t index = (tWorkerPool == this)
+            ? tWorkerIndex
+            : static_cast<int32_t>(mNextQueue.fetch_add(1) % mQueues.size());
+    {
+        std::lock_guard<std::mutex> lock(mQueues[index]->mutex);
+        mQueues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mQueued++;
+        mPending++;
+    }
+    mWorkAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mAllDone.wait(lock, [this] { return mPending == 0; });
+}
+
+bool ThreadPool::popLocal(int32_t index, Task& task) {
+    Queue& queue = *mQueues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::steal(int32_t thief, Task& task) {
+    const int32_t count = static_cast<int32_t>(mQueues.size());
+    for (int32_t offset = 1; offset < count; offset++) {
+        Queue& queue = *mQueues[(thief + offset) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::run(int32_t index) {
+    tWorkerIndex = index;
+    tWorkerPool = this;
+    if (mNiceness > 0) setpriority(PRIO_PROCESS, 0, mNiceness);  // 0: this thread
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWorkAvailable.wait(lock, [this] { return mStopping || mQueued > 0; });
+            if (mStopping && mQueued == 0) return;
+        }
+
+        Task task;
+        if (!popLocal(index, task) && !steal(index, task)) {
+            continue;  // Another worker got there first
+        }
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mQueued--;
+        }
+
+        task();
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (--mPending == 0) mAllDone.notify_all();
+    }
+}
+
+} // namespace euphoriae
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EUPHORIAE_THREAD_POOL_H
+#define EUPHORIAE_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace euphoriae {
+
+/**
+ * ThreadPool - Work-stealing pool for batch jobs (never the audio thread)
+ *
+ * Each worker owns a deque: it pops its own newest task and, when empty,
+ * steals the oldest task of another worker. Tasks submitted from outside are
+ * dealt round-robin, tasks submitted from a worker stay on that worker. This
+ * keeps all cores busy when task costs differ widely (long and short tracks).
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // numThreads <= 0 uses every hardware thread. A positive niceness runs the
+    // workers below normal priority (Linux and Android nice values are per thread).
+    explicit ThreadPool(int32_t numThreads = 0, int32_t niceness = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int32_t numThreads() const { return static_cast<int32_t>(mWorkers.size()); }
+
+    void submit(Task task);
+
+    // Blocks until every submitted task has finished
+    void wait();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void run(int32_t index);
+    bool popLocal(int32_t index, Task& task);
+    bool steal(int32_t thief, Task& task);
+
+    const int32_t mNiceness;
+    std::vector<std::unique_ptr<Queue>> mQueues;
+    std::vector<std::thread> mWorkers;
+    std::atomic<uint32_t> mNextQueue{0};
+
+    std::mutex mMutex;                 // Guards sleeping and completion
+    std::condition_variable mWorkAvailable;
+    std::condition_variable mAllDone;
+    int64_t mQueued = 0;               // Submitted but not yet taken
+    int64_t mPending = 0;              // Submitted but not yet finished
+    bool mStopping = false;
+};
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_THREAD_POOL_H
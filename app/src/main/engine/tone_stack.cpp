@@ -0,0 +1,258 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "tone_stack.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+
+namespace euphoriae {
+
+namespace {
+
+constexpr float kOffThreshold = 0.01f;
+constexpr float kMaxBassGainDb = 12.0f;
+constexpr float kTrebleFrequency = 5000.0f;
+constexpr float kMaxTrebleGainDb = 9.0f;
+constexpr float kClarityFrequency = 3000.0f;
+constexpr float kClarityQ = 0.8f;
+constexpr float kMaxClarityGainDb = 6.0f;
+constexpr float kAirFrequency = 12000.0f;
+constexpr float kMaxAirGainDb = 6.0f;
+
+struct Coefficients {
+    double b0, b1, b2, a0, a1, a2;
+};
+
+// RBJ cookbook designs; shelves use slope 1
+Coefficients lowShelf(double w0, double gainDb) {
+    const double a = std::pow(10.0, gainDb / 40.0);
+    const double cosW = std::cos(w0);
+    const double k = 2.0 * std::sqrt(a) * std::sin(w0) / 2.0 * std::sqrt(2.0);
+    return {a * ((a + 1.0) - (a - 1.0) * cosW + k), 2.0 * a * ((a - 1.0) - (a + 1.0) * cosW),
+            a * ((a + 1.0) - (a - 1.0) * cosW - k), (a + 1.0) + (a - 1.0) * cosW + k,
+            -2.0 * ((a - 1.0) + (a + 1.0) * cosW), (a + 1.0) + (a - 1.0) * cosW - k};
+}
+
+Coefficients highShelf(double w0, double gainDb) {
+    const double a = std::pow(10.0, gainDb / 40.0);
+    const double cosW = std::cos(w0);
+    const double k = 2.0 * std::sqrt(a) * std::sin(w0) / 2.0 * std::sqrt(2.0);
+    return {a * ((a + 1.0) + (a - 1.0) * cosW + k), -2.0 * a * ((a - 1.0) + (a + 1.0) * cosW),
+            a * ((a + 1.0) + (a - 1.0) * cosW - k), (a + 1.0) - (a - 1.0) * cosW + k,
+            2.0 * ((a - 1.0) - (a + 1.0) * cosW), (a + 1.0) - (a - 1.0) * cosW - k};
+}
+
+Coefficients peaking(double w0, double q, double gainDb) {
+    const double a = std::pow(10.0, gainDb / 40.0);
+    const double alpha = std::sin(w0) / (2.0 * q);
+    const double cosW = std::cos(w0);
+    return {1.0 + alpha * a, -2.0 * cosW, 1.0 - alpha * a, 1.0 + alpha / a, -2.0 * cosW, 1.0 - alpha / a};
+}
+
+Coefficients lowPass(double w0) {
+    const double alpha = std::sin(w0) / std::sqrt(2.0);
+    const double cosW = std::cos(w0);
+    return {(1.0 - cosW) / 2.0, 1.0 - cosW, (1.0 - cosW) / 2.0, 1.0 + alpha, -2.0 * cosW, 1.0 - alpha};
+}
+
+Coefficients highPass(double w0) {
+    const double alpha = std::sin(w0) / std::sqrt(2.0);
+    const double cosW = std::cos(w0);
+    return {(1.0 + cosW) / 2.0, -(1.0 + cosW), (1.0 + cosW) / 2.0, 1.0 + alpha, -2.0 * cosW, 1.0 - alpha};
+}
+
+template <typename Biquad>
+Biquad normalize(const Coefficients& c) {
+    return {static_cast<float>(c.b0 / c.a0), static_cast<float>(c.b1 / c.a0), static_cast<float>(c.b2 / c.a0),
+            static_cast<float>(c.a1 / c.a0), static_cast<float>(c.a2 / c.a0)};
+}
+
+// Biquad coefficients broadcast to every lane
+struct BiquadLanes {
+    simd::float4 b0, b1, b2, a1, a2;
+
+    template <typename Biquad>
+    explicit BiquadLanes(const Biquad& c)
+        : b0(simd::set1(c.b0)), b1(simd::set1(c.b1)), b2(simd::set1(c.b2)),
+          a1(simd::set1(c.a1)), a2(simd::set1(c.a2)) {}
+    BiquadLanes() = default;
+};
+
+// One TDF-II biquad step on four channels
+inline simd::float4 biquadStep(simd::float4 x, simd::float4& z1, simd::float4& z2, const BiquadLanes& c) {
+    simd::float4 y = simd::mulAdd(z1, c.b0, x);
+    z1 = simd::mulSub(simd::mulAdd(z2, c.b1, x), c.a1, y);
+    z2 = simd::mulSub(simd::mul(c.b2, x), c.a2, y);
+    return y;
+}
+
+// Interleaved frame -> lanes, unused lanes zero
+inline simd::float4 gather(const float* frame, int32_t lanes) {
+    float v[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (int32_t k = 0; k < lanes; k++) v[k] = frame[k];
+    return simd::load(v);
+}
+
+inline void scatter(float* frame, int32_t lanes, simd::float4 y) {
+    float v[4];
+    simd::store(v, y);
+    for (int32_t k = 0; k < lanes; k++) frame[k] = v[k];
+}
+
+} // namespace
+
+ToneStack::ToneStack(int32_t sampleRate) : mSampleRate(std::max(sampleRate, 8000)) {}
+
+void ToneStack::setSampleRate(int32_t sampleRate) {
+    mSampleRate = std::max(sampleRate, 8000);
+    mDirty = true;
+    reset();
+}
+
+void ToneStack::setSettings(const Settings& settings) {
+    if (settings == mSettings && !mDirty) return;
+    mSettings = settings;
+    compile();
+    mDirty = false;
+}
+
+void ToneStack::compile() {
+    const double fs = mSampleRate;
+    auto omega = [fs](double hz) { return 2.0 * M_PI * std::min(hz, fs * 0.45) / fs; };
+    auto amount = [](float value) { return value > kOffThreshold ? std::min(value, 1.0f) : 0.0f; };
+
+    const float bass = amount(mSettings.bass);
+    const bool virtualBass = mSettings.virtualBass && bass > 0.0f;
+    const double bassW0 = omega(std::clamp(mSettings.bassFrequency, kMinBassFrequency, kMaxBassFrequency));
+
+    float gains[kNumSections] = {};
+    gains[kBass] = virtualBass ? 0.0f : bass * kMaxBassGainDb;
+    gains[kTreble] = amount(mSettings.treble) * kMaxTrebleGainDb;
+    gains[kClarity] = amount(mSettings.clarity) * kMaxClarityGainDb;
+    gains[kAir] = amount(mSettings.spectrumExtension) * kMaxAirGainDb;
+
+    mSections[kBass] = normalize<Biquad>(lowShelf(bassW0, gains[kBass]));
+    mSections[kTreble] = normalize<Biquad>(highShelf(omega(kTrebleFrequency), gains[kTreble]));
+    mSections[kClarity] = normalize<Biquad>(peaking(omega(kClarityFrequency), kClarityQ, gains[kClarity]));
+    mSections[kAir] = normalize<Biquad>(highShelf(omega(kAirFrequency), gains[kAir]));
+
+    // Sections joining the cascade start from silence, not from when they were last on
+    bool wasActive[kNumSections] = {};
+    for (int32_t i = 0; i < mNumActive; i++) wasActive[mActive[i]] = true;
+    mNumActive = 0;
+    for (int32_t s = 0; s < kNumSections; s++) {
+        if (gains[s] <= 0.0f) continue;
+        if (!wasActive[s]) mSectionState[s] = FilterState{};
+        mActive[mNumActive++] = static_cast<Section>(s);
+    }
+
+    if (virtualBass && !mVirtualBass) {
+        mLowPassState = FilterState{};
+        mHighPassState = FilterState{};
+        mDryHighPassState = FilterState{};
+    }
+    mVirtualBass = virtualBass;
+    mVirtualStrength = bass;
+    mLowPass = normalize<Biquad>(lowPass(bassW0));
+    mHighPass = normalize<Biquad>(highPass(bassW0));
+
+    // A rectified sine's second harmonic is 4 / (3 pi) of its amplitude; at full
+    // strength the harmonics come out about 2 dB above the fundamental they replace
+    mHarmonicGain = bass * 3.0f;
+}
+
+void ToneStack::reset() {
+    for (FilterState& state : mSectionState) state = FilterState{};
+    mLowPassState = FilterState{};
+    mHighPassState = FilterState{};
+    mDryHighPassState = FilterState{};
+}
+
+void ToneStack::process(float* buffer, int32_t numFrames, int32_t channelCount) {
+    if (buffer == nullptr || channelCount <= 0 || !isActive()) return;
+    const int32_t channels = std::min(channelCount, kMaxChannels);
+    for (int32_t first = 0; first < channels; first += 4) {
+        const int32_t lanes = std::min(channels - first, 4);
+        if (mVirtualBass) {
+            processChannels<true>(buffer, numFrames, channelCount, first, lanes);
+        } else {
+            processChannels<false>(buffer, numFrames, channelCount, first, lanes);
+        }
+    }
+}
+
+template <bool kVirtualBass>
+void ToneStack::processChannels(float* buffer, int32_t numFrames, int32_t channelCount,
+                                int32_t firstChannel, int32_t lanes) {
+    BiquadLanes sections[kNumSections];
+    simd::float4 z1[kNumSections];
+    simd::float4 z2[kNumSections];
+    const int32_t numActive = mNumActive;
+    for (int32_t i = 0; i < numActive; i++) {
+        sections[i] = BiquadLanes(mSections[mActive[i]]);
+        z1[i] = simd::load(mSectionState[mActive[i]].z1 + firstChannel);
+        z2[i] = simd::load(mSectionState[mActive[i]].z2 + firstChannel);
+    }
+
+    const BiquadLanes lowPassLanes(mLowPass);
+    const BiquadLanes highPassLanes(mHighPass);
+    const simd::float4 removal = simd::set1(mVirtualStrength);
+    const simd::float4 harmonicGain = simd::set1(mHarmonicGain);
+    simd::float4 lz1 = simd::load(mLowPassState.z1 + firstChannel);
+    simd::float4 lz2 = simd::load(mLowPassState.z2 + firstChannel);
+    simd::float4 hz1 = simd::load(mHighPassState.z1 + firstChannel);
+    simd::float4 hz2 = simd::load(mHighPassState.z2 + firstChannel);
+    simd::float4 dz1 = simd::load(mDryHighPassState.z1 + firstChannel);
+    simd::float4 dz2 = simd::load(mDryHighPassState.z2 + firstChannel);
+
+    float* frame = buffer + firstChannel;
+    for (int32_t i = 0; i < numFrames; i++, frame += channelCount) {
+        simd::float4 x = gather(frame, lanes);
+
+        if (kVirtualBass) {
+            // |x| doubles the fundamental and scales with level, so no envelope is needed;
+            // the high pass removes its DC and anything still below the corner
+            simd::float4 low = biquadStep(x, lz1, lz2, lowPassLanes);
+            simd::float4 harmonics = biquadStep(simd::abs(low), hz1, hz2, highPassLanes);
+
+            // Crossfade toward the high-passed signal with strength
+            simd::float4 dry = biquadStep(x, dz1, dz2, highPassLanes);
+            x = simd::mulAdd(simd::mulAdd(x, removal, simd::sub(dry, x)), harmonicGain, harmonics);
+        }
+
+        for (int32_t s = 0; s < numActive; s++) {
+            x = biquadStep(x, z1[s], z2[s], sections[s]);
+        }
+        scatter(frame, lanes, x);
+    }
+
+    for (int32_t i = 0; i < numActive; i++) {
+        simd::store(mSectionState[mActive[i]].z1 + firstChannel, z1[i]);
+        simd::store(mSectionState[mActive[i]].z2 + firstChannel, z2[i]);
+    }
+    if (kVirtualBass) {
+        simd::store(mLowPassState.z1 + firstChannel, lz1);
+        simd::store(mLowPassState.z2 + firstChannel, lz2);
+        simd::store(mHighPassState.z1 + firstChannel, hz1);
+        simd::store(mHighPassState.z2 + firstChannel, hz2);
+        simd::store(mDryHighPassState.z1 + firstChannel, dz1);
+        simd::store(mDryHighPassState.z2 + firstChannel, dz2);
+    }
+}
+
+} // namespace euphoriae
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef EUPHORIAE_TONE_STACK_H
+#define EUPHORIAE_TONE_STACK_H
+
+#include <cstdint>
+
+namespace euphoriae {
+
+/**
+ * ToneStack - Bass, treble, clarity and spectrum extension as one biquad cascade
+ *
+ *   bass                 RBJ low shelf at a selectable corner (40-200 Hz), up to +12 dB
+ *   treble               high shelf at 5 kHz, up to +9 dB
+ *   clarity              presence peak at 3 kHz, up to +6 dB
+ *   spectrum extension   "air" high shelf at 12 kHz, up to +6 dB
+ *
+ * Controls that are off are left out of the cascade, and the coefficients are
+ * compiled on the audio thread only when a setting changed. All sections run
+ * in a single pass, four channels per SIMD vector.
+ *
+ * Virtual bass replaces the bass shelf for speakers that cannot reproduce the
+ * corner frequency: the content below it is high-passed away and replaced by
+ * its harmonics (full-wave rectified, then high-passed at the corner), which
+ * the ear hears as the missing fundamental without the excursion and headroom.
+ * It runs in the same pass, ahead of the cascade.
+ */
+class ToneStack {
+public:
+    static constexpr int32_t kMaxChannels = 8;
+    static constexpr float kMinBassFrequency = 40.0f;
+    static constexpr float kMaxBassFrequency = 200.0f;
+
+    struct Settings {
+        float bass = 0.0f;               // 0-1
+        float bassFrequency = 80.0f;     // Hz
+        bool virtualBass = false;
+        float treble = 0.0f;             // 0-1
+        float clarity = 0.0f;            // 0-1
+        float spectrumExtension = 0.0f;  // 0-1
+
+        bool operator==(const Settings& other) const {
+            return bass == other.bass && bassFrequency == other.bassFrequency &&
+                   virtualBass == other.virtualBass && treble == other.treble &&
+                   clarity == other.clarity && spectrumExtension == other.spectrumExtension;
+        }
+        bool operator!=(const Settings& other) const { return !(*this == other); }
+    };
+
+    explicit ToneStack(int32_t sampleRate);
+
+    void setSampleRate(int32_t sampleRate);
+
+    // Audio thread, before process()
+    void setSettings(const Settings& settings);
+
+    bool isActive() const { return mNumActive > 0 || mVirtualBass; }
+
+    // The first kMaxChannels channels, in place
+    void process(float* buffer, int32_t numFrames, int32_t channelCount);
+
+    void reset();
+
+private:
+    enum Section { kBass, kTreble, kClarity, kAir, kNumSections };
+
+    struct Biquad {
+        float b0, b1, b2, a1, a2;
+    };
+
+    // Transposed direct form II state, one lane per channel
+    struct FilterState {
+        alignas(16) float z1[kMaxChannels] = {};
+        alignas(16) float z2[kMaxChannels] = {};
+    };
+
+    void compile();
+    template <bool kVirtualBass>
+    void processChannels(float* buffer, int32_t numFrames, int32_t channelCount, int32_t firstChannel,
+                         int32_t lanes);
+
+    int32_t mSampleRate;
+    Settings mSettings;
+    bool mDirty = true;
+
+    // Active sections in processing order
+    Biquad mSections[kNumSections]{};
+    FilterState mSectionState[kNumSections];
+    Section mActive[kNumSections]{};
+    int32_t mNumActive = 0;
+
+    // Virtual bass
+    bool mVirtualBass = false;
+    float mVirtualStrength = 0.0f;
+    float mHarmonicGain = 0.0f;
+    Biquad mLowPass{};   // Extracts what the speaker cannot play
+    Biquad mHighPass{};  // Removes the sub-bass, keeps the harmonics above the corner
+    FilterState mLowPassState;
+    FilterState mHighPassState;
+    FilterState mDryHighPassState;
+};
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_TONE_STACK_H
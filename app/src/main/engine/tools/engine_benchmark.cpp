@@ -0,0 +1,610 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * engine_benchmark - Host throughput benchmark for the full effect chain
+ *
+ * Runs a typical set of effects over host buffers from 64 to 16384 frames,
+ * once with each stage over the whole buffer and once with the engine's
+ * fixed sub-blocks, and prints the speed in multiples of realtime. The last
+ * column repeats the sub-blocked run while another thread automates the
+ * volume. What that costs depends on the member layout, so a separate line
+ * runs the same writer against a stand-in for the engine's state, once packed
+ * the way the members used to be and once in cache-line groups as they are
+ * now (on a single core there is no traffic to see). A second table times the configurations the engine has fused stages for,
+ * with and without them, and a last line times silent input, which should
+ * skip nearly the whole chain.
+ *
+ *   engine_benchmark           timing
+ *   engine_benchmark --check   checks that sub-blocked output, with automation
+ *                              ramps starting mid-block, does not depend on the
+ *                              host buffer size, that ramps land on their frame,
+ *                              that gain settings change without a step, that
+ *                              the stage order is honoured, that the fused
+ *                              stages sound like the ones they replace, that
+ *                              the convolver's spread-out segments still add up
+ *                              to the direct convolution, and that an EHIR file
+ *                              reads back as written (rates out of range
+ *                              rejected) and renders as the impulses it holds,
+ *                              and that the spectrum analyzer follows a change
+ *                              of sample rate
+ */
+
+#include "audio_engine.h"
+#include "binaural_renderer.h"
+#include "convolver.h"
+#include "hrir_set.h"
+#include "spectrum_analyzer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using euphoriae::AudioEngine;
+using euphoriae::BinauralRenderer;
+using euphoriae::Convolver;
+using euphoriae::HrirSet;
+using euphoriae::RampCurve;
+using euphoriae::SpectrumAnalyzer;
+
+namespace {
+
+constexpr int32_t kSampleRate = 48000;
+constexpr int32_t kChannels = 2;
+constexpr int32_t kMinBufferFrames = 64;
+constexpr int32_t kMaxBufferFrames = 16384;
+constexpr float kMaxDifference = 1e-5f;
+
+// Every stage whose cost scales with the buffer, at moderate settings. The
+// volume leveler is left out: it follows the loudness meter once per block,
+// so its gain legitimately depends on where the blocks start.
+void configureEffects(AudioEngine& engine) {
+    engine.configure(kSampleRate, kChannels);
+    engine.setBassBoost(0.5f);
+    engine.setTrebleBoost(0.3f);
+    engine.setClarity(0.3f);
+    engine.setSpectrumExtension(0.2f);
+    engine.setTubeWarmth(0.3f);
+    engine.setCompressorStrength(0.5f);
+    engine.setLoudnessGain(0.2f);
+    engine.setReverb(2, 0.25f);
+    engine.setSurround3D(0.4f);
+    engine.setVirtualizer(0.5f);
+    engine.setChannelSeparation(0.6f);
+    for (int band = 0; band < 10; band++) {
+        engine.setEqualizerBand(band, (band % 3 - 1) * 3.0f);
+    }
+}
+
+// The configurations with fused stages: EQ (and bass boost) into the limiter
+void configureEqualizer(AudioEngine& engine) {
+    engine.configure(kSampleRate, kChannels);
+    for (int band = 0; band < 10; band++) {
+        engine.setEqualizerBand(band, (band % 3) * 2.0f);
+    }
+}
+
+void configureToneEqualizer(AudioEngine& engine) {
+    engine.configure(kSampleRate, kChannels);
+    engine.setBassBoost(0.5f);
+    for (int band = 0; band < 10; band++) {
+        engine.setEqualizerBand(band, (band % 3) * 2.0f);
+    }
+}
+
+struct FastPath {
+    const char* name;
+    void (*configure)(AudioEngine& engine);
+};
+constexpr FastPath kFastPaths[] = {
+    {"eq + limiter", configureEqualizer},
+    {"eq + bass + limiter", configureToneEqualizer},
+};
+
+std::vector<float> makeSignal(int32_t numFrames) {
+    std::mt19937 rng(2026);
+    std::uniform_real_distribution<float> noise(-0.1f, 0.1f);
+    std::vector<float> signal(static_cast<size_t>(numFrames) * kChannels);
+    for (int32_t i = 0; i < numFrames; i++) {
+        float tone = 0.3f * std::sin(2.0f * static_cast<float>(M_PI) * 220.0f * i / kSampleRate);
+        signal[i * kChannels] = tone + noise(rng);
+        signal[i * kChannels + 1] = 0.5f * tone + noise(rng);
+    }
+    return signal;
+}
+
+// Processes the signal in place in host buffers of the given size
+void render(AudioEngine& engine, std::vector<float>& signal, int32_t bufferFrames) {
+    const int32_t numFrames = static_cast<int32_t>(signal.size()) / kChannels;
+    for (int32_t frame = 0; frame < numFrames; frame += bufferFrames) {
+        int32_t count = std::min(bufferFrames, numFrames - frame);
+        engine.processAudio(signal.data() + frame * kChannels, count, kChannels);
+    }
+}
+
+// Multiples of realtime for one buffer size, best of a few runs
+double measureSpeed(const std::vector<float>& input, int32_t bufferFrames, int32_t blockFrames,
+                    bool automate, void (*configure)(AudioEngine&) = configureEffects, bool fastPaths = true) {
+    AudioEngine engine;
+    configure(engine);
+    engine.setBlockFrames(blockFrames);
+    engine.setFastPathsEnabled(fastPaths);
+
+    // Far faster than any slider, so the traffic it causes is measurable
+    std::atomic<bool> stop{false};
+    std::thread automation;
+    if (automate) {
+        automation = std::thread([&engine, &stop] {
+            for (int i = 0; !stop.load(std::memory_order_relaxed); i++) {
+                engine.setVolume(i % 2 == 0 ? 0.8f : 0.81f);
+            }
+        });
+    }
+
+    std::vector<float> signal = input;
+    render(engine, signal, bufferFrames);  // Warm up caches and filter state
+
+    double best = 1e30;
+    for (int run = 0; run < 3; run++) {
+        signal = input;
+        auto start = std::chrono::steady_clock::now();
+        render(engine, signal, bufferFrames);
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end - start).count());
+    }
+    stop.store(true);
+    if (automation.joinable()) automation.join();
+    double seconds = static_cast<double>(input.size() / kChannels) / kSampleRate;
+    return seconds / best;
+}
+
+// Stand-ins for the engine's members: a parameter the UI writes next to state
+// the audio thread writes every frame, as they used to be declared, and the
+// same members in separate cache-line groups, as AudioEngine declares them
+struct PackedState {
+    std::atomic<float> volume{0.8f};
+    float envelope = 0.0f;
+    float filter = 0.0f;
+};
+
+struct GroupedState {
+    alignas(64) std::atomic<float> volume{0.8f};
+    alignas(64) float envelope = 0.0f;
+    float filter = 0.0f;
+};
+
+// Multiples of realtime for an envelope follower and a one-pole over the
+// signal in engine-sized blocks, while another thread writes the volume as
+// fast as it can
+template <typename State>
+double measureLayout(const std::vector<float>& input) {
+    State state;
+    std::atomic<bool> stop{false};
+    std::thread automation([&state, &stop] {
+        for (int i = 0; !stop.load(std::memory_order_relaxed); i++) {
+            state.volume.store(i % 2 == 0 ? 0.8f : 0.81f, std::memory_order_relaxed);
+        }
+    });
+
+    std::vector<float> signal(input.size());
+    auto render = [&] {
+        // Stores through the float buffer may alias the state, so it is written
+        // back every sample like the engine's members
+        for (size_t block = 0; block < signal.size(); block += AudioEngine::kBlockFrames * kChannels) {
+            const size_t end = std::min(signal.size(), block + AudioEngine::kBlockFrames * kChannels);
+            const float volume = state.volume.load(std::memory_order_relaxed);
+            for (size_t i = block; i < end; i++) {
+                state.envelope += (std::abs(input[i]) - state.envelope) * 0.01f;
+                state.filter += (input[i] - state.filter) * 0.2f;
+                signal[i] = state.filter * volume / (1.0f + state.envelope);
+            }
+        }
+    };
+    render();
+
+    double best = 1e30;
+    for (int run = 0; run < 3; run++) {
+        auto start = std::chrono::steady_clock::now();
+        render();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end - start).count());
+    }
+    stop.store(true);
+    automation.join();
+    double seconds = static_cast<double>(input.size() / kChannels) / kSampleRate;
+    return seconds / best;
+}
+
+// Overlapping volume and fade ramps, none of them on a block boundary
+void scheduleRamps(AudioEngine& engine) {
+    engine.scheduleRamp(AudioEngine::kAutomateVolume, 0.5f, 3001, 7777, RampCurve::kLinear);
+    engine.scheduleRamp(AudioEngine::kAutomateFade, 0.0f, 20011, 30000, RampCurve::kExponential);
+    engine.scheduleRamp(AudioEngine::kAutomateFade, 1.0f, 60013, 0, RampCurve::kLinear);
+    engine.scheduleRamp(AudioEngine::kAutomateVolume, 1.0f, 61111, 5000, RampCurve::kExponential);
+}
+
+bool checkBufferSizeIndependence() {
+    const std::vector<float> input = makeSignal(kSampleRate * 2);
+    std::vector<float> reference = input;
+    {
+        AudioEngine engine;
+        configureEffects(engine);
+        scheduleRamps(engine);
+        render(engine, reference, AudioEngine::kBlockFrames);
+    }
+
+    bool passed = true;
+    for (int32_t bufferFrames : {1, 37, 480, 1000, kMaxBufferFrames}) {
+        AudioEngine engine;
+        configureEffects(engine);
+        scheduleRamps(engine);
+        std::vector<float> output = input;
+        render(engine, output, bufferFrames);
+
+        float maxDifference = 0.0f;
+        for (size_t i = 0; i < output.size(); i++) {
+            maxDifference = std::max(maxDifference, std::abs(output[i] - reference[i]));
+        }
+        bool ok = maxDifference <= kMaxDifference;
+        passed = passed && ok;
+        std::printf("%8d frames: max difference %.3g %s\n", bufferFrames, maxDifference, ok ? "" : "FAIL");
+    }
+    return passed;
+}
+
+// A linear fade on a constant signal, every frame against the ideal ramp
+bool checkRampAccuracy() {
+    constexpr int64_t kStart = 1000;
+    constexpr int64_t kDuration = 1000;
+    constexpr float kLevel = 0.5f;
+    AudioEngine engine;
+    engine.configure(kSampleRate, kChannels);
+    engine.scheduleRamp(AudioEngine::kAutomateFade, 0.0f, kStart, kDuration, RampCurve::kLinear);
+    std::vector<float> signal(3000 * kChannels, kLevel);
+    render(engine, signal, 441);
+
+    float maxError = 0.0f;
+    for (int64_t frame = 0; frame < 3000; frame++) {
+        const float progress = std::clamp(static_cast<float>(frame - kStart) / kDuration, 0.0f, 1.0f);
+        const float expected = kLevel * (1.0f - progress);
+        for (int32_t ch = 0; ch < kChannels; ch++) {
+            maxError = std::max(maxError, std::abs(signal[frame * kChannels + ch] - expected));
+        }
+    }
+    const bool ok = maxError <= kMaxDifference && engine.getFramePosition() == 3000;
+    std::printf("ramp timing: max error %.3g %s\n", maxError, ok ? "" : "FAIL");
+    return ok;
+}
+
+// Volume and balance moved between two buffers of a constant signal: the output
+// has to glide to the new level, never step
+bool checkGainSmoothing() {
+    constexpr float kLevel = 0.5f;
+    constexpr int32_t kFrames = 4096;
+    AudioEngine engine;
+    engine.configure(kSampleRate, kChannels);
+    std::vector<float> signal(kFrames * kChannels, kLevel);
+    render(engine, signal, kFrames / 2);
+    engine.setVolume(0.5f);
+    engine.setStereoBalance(0.5f);
+    signal.assign(kFrames * kChannels, kLevel);
+    render(engine, signal, kFrames / 2);
+
+    float maxStep = 0.0f;
+    for (int32_t frame = 1; frame < kFrames; frame++) {
+        for (int32_t ch = 0; ch < kChannels; ch++) {
+            maxStep = std::max(maxStep, std::abs(signal[frame * kChannels + ch] -
+                                                 signal[(frame - 1) * kChannels + ch]));
+        }
+    }
+    const float* last = signal.data() + (kFrames - 1) * kChannels;
+    const bool settled = std::abs(last[0] - kLevel * 0.25f) < 1e-6f && std::abs(last[1] - kLevel * 0.5f) < 1e-6f;
+    const bool ok = maxStep < 1e-3f && settled;
+    std::printf("gain smoothing: max step %.3g %s\n", maxStep, ok ? "" : "FAIL");
+    return ok;
+}
+
+// Reverb and compressor swapped have to change the sound; the default order
+// set explicitly must not, and broken orders are refused
+bool checkStageOrder() {
+    auto renderWith = [](const int32_t* order) {
+        AudioEngine engine;
+        configureEffects(engine);
+        engine.setCompressorStrength(0.8f);
+        engine.setReverb(4, 0.5f);
+        if (order != nullptr) engine.setStageOrder(order, AudioEngine::kNumChainStages);
+        std::vector<float> signal = makeSignal(kSampleRate / 2);
+        render(engine, signal, 480);
+        return signal;
+    };
+    int32_t order[AudioEngine::kNumChainStages];
+    for (int32_t i = 0; i < AudioEngine::kNumChainStages; i++) order[i] = i;
+    const std::vector<float> reference = renderWith(nullptr);
+    const std::vector<float> same = renderWith(order);
+    std::swap(order[AudioEngine::kStageCompressor], order[AudioEngine::kStageReverb]);
+    const std::vector<float> swapped = renderWith(order);
+
+    AudioEngine engine;
+    order[0] = order[1];
+    const bool refused = !engine.setStageOrder(order, AudioEngine::kNumChainStages) &&
+                         !engine.setStageOrder(order, 3);
+    const bool ok = same == reference && swapped != reference && refused;
+    std::printf("stage order: %s\n", ok ? "ok" : "FAIL");
+    return ok;
+}
+
+// Each fused configuration against the same stages compiled one by one,
+// across a volume change and a fade (which the fused stages hand back to the
+// generic ones while they ramp)
+bool checkFastPaths() {
+    bool ok = true;
+    for (const FastPath& path : kFastPaths) {
+        auto renderWith = [&path](bool fastPaths) {
+            AudioEngine engine;
+            path.configure(engine);
+            engine.setFastPathsEnabled(fastPaths);
+            std::vector<float> signal = makeSignal(kSampleRate * 4);  // Past the leveler's 3 s window
+            const int32_t half = static_cast<int32_t>(signal.size()) / 2;
+            std::vector<float> first(signal.begin(), signal.begin() + half);
+            std::vector<float> second(signal.begin() + half, signal.end());
+            render(engine, first, 480);
+            engine.setVolume(0.6f);
+            engine.scheduleRamp(AudioEngine::kAutomateFade, 0.5f, engine.getFramePosition() + 1000, 4000,
+                                RampCurve::kLinear);
+            render(engine, second, 480);
+            first.insert(first.end(), second.begin(), second.end());
+            return first;
+        };
+        const std::vector<float> generic = renderWith(false);
+        const std::vector<float> fused = renderWith(true);
+        float maxDifference = 0.0f;
+        for (size_t i = 0; i < generic.size(); i++) {
+            maxDifference = std::max(maxDifference, std::abs(generic[i] - fused[i]));
+        }
+        const bool pathOk = maxDifference <= kMaxDifference;
+        std::printf("fast path %s: %s (max difference %.2e)\n", path.name, pathOk ? "ok" : "FAIL",
+                    maxDifference);
+        ok &= pathOk;
+    }
+    return ok;
+}
+
+// Scattered impulses through an IR long enough for every segment size, so the
+// reference is a few shifted copies of the IR instead of a full convolution
+bool checkConvolution() {
+    constexpr int32_t kIrFrames = 40000;
+    constexpr int32_t kFrames = kSampleRate * 3;
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    std::vector<float> ir(kIrFrames * kChannels);
+    for (float& tap : ir) tap = uniform(random) * 0.1f;
+
+    std::vector<float> input(kFrames * kChannels, 0.0f);
+    std::vector<double> expected(input.size(), 0.0);
+    for (int32_t i = 0; i < 16; i++) {
+        const int32_t start = static_cast<int32_t>(random() % kFrames);
+        for (int32_t ch = 0; ch < kChannels; ch++) {
+            const float amplitude = uniform(random);
+            input[start * kChannels + ch] += amplitude;
+            for (int32_t t = 0; t < kIrFrames && start + t < kFrames; t++) {
+                expected[(start + t) * kChannels + ch] += static_cast<double>(amplitude) * ir[t * kChannels + ch];
+            }
+        }
+    }
+
+    bool ok = true;
+    for (int32_t bufferFrames : {37, 480}) {
+        Convolver convolver(ir.data(), kIrFrames, kChannels);
+        std::vector<float> output = input;
+        for (int32_t frame = 0; frame < kFrames; frame += bufferFrames) {
+            convolver.process(output.data() + frame * kChannels, std::min(bufferFrames, kFrames - frame),
+                              kChannels, 1.0f);
+        }
+        double maxError = 0.0;
+        for (size_t i = 0; i < output.size(); i++) {
+            maxError = std::max(maxError, std::abs(output[i] - expected[i]));
+        }
+        const bool bufferOk = maxError <= kMaxDifference;
+        std::printf("convolution, %d-frame buffers: max error %.3g %s\n", bufferFrames, maxError,
+                    bufferOk ? "" : "FAIL");
+        ok &= bufferOk;
+    }
+    return ok;
+}
+
+// Writes an EHIR file of (azimuth, elevation, left, right) records to a
+// temporary path; empty on failure
+std::string writeHrirFile(uint32_t sampleRate, uint32_t irLength, const std::vector<float>& records) {
+    char path[] = "/tmp/engine_benchmark_XXXXXX";
+    const int fd = mkstemp(path);
+    if (fd < 0) return {};
+    const uint32_t numDirections = static_cast<uint32_t>(records.size() / (2 + 2 * irLength));
+    const uint32_t header[] = {1, sampleRate, irLength, numDirections};
+    const size_t recordBytes = records.size() * sizeof(float);
+    const bool written = write(fd, "EHIR", 4) == 4 &&
+                         write(fd, header, sizeof(header)) == static_cast<ssize_t>(sizeof(header)) &&
+                         write(fd, records.data(), recordBytes) == static_cast<ssize_t>(recordBytes);
+    close(fd);
+    if (!written) {
+        unlink(path);
+        return {};
+    }
+    return path;
+}
+
+// Two mirror-image directions at +-30 degrees: the near ear hears an impulse at
+// kNearTap, the far ear half as much at kFarTap, past the first partition. The
+// Studio layout puts a speaker at each, so the renderer reduces to those
+// impulses one block late.
+bool checkBinaural() {
+    constexpr int32_t kIrLength = 200;
+    constexpr int32_t kNearTap = 3;
+    constexpr int32_t kFarTap = 150;
+    constexpr int32_t kStudio = 4;
+    constexpr int32_t kLatency = BinauralRenderer::kBlockSize;
+
+    std::vector<float> records;
+    for (float azimuth : {-30.0f, 30.0f}) {
+        std::vector<float> left(kIrLength, 0.0f);
+        std::vector<float> right(kIrLength, 0.0f);
+        (azimuth < 0.0f ? left : right)[kNearTap] = 1.0f;
+        (azimuth < 0.0f ? right : left)[kFarTap] = 0.5f;
+        records.push_back(azimuth);
+        records.push_back(0.0f);
+        records.insert(records.end(), left.begin(), left.end());
+        records.insert(records.end(), right.begin(), right.end());
+    }
+
+    bool ok = true;
+    for (uint32_t rate : {1u, 7999u, 384001u}) {
+        const std::string path = writeHrirFile(rate, kIrLength, records);
+        const bool rejected = !path.empty() && HrirSet::open(path.c_str()) == nullptr;
+        if (!path.empty()) unlink(path.c_str());
+        std::printf("hrir set at %u Hz: %s\n", rate, rejected ? "rejected" : "FAIL");
+        ok &= rejected;
+    }
+
+    const std::string path = writeHrirFile(kSampleRate, kIrLength, records);
+    std::unique_ptr<HrirSet> hrirs = path.empty() ? nullptr : HrirSet::open(path.c_str());
+    if (!path.empty()) unlink(path.c_str());  // The mapping outlives the name
+    const size_t recordSize = 2 + 2 * kIrLength;
+    const bool readBack = hrirs != nullptr && hrirs->sampleRate() == kSampleRate &&
+                          hrirs->irLength() == kIrLength && hrirs->numDirections() == 2 &&
+                          std::memcmp(hrirs->left(0), &records[2], kIrLength * sizeof(float)) == 0 &&
+                          std::memcmp(hrirs->right(1), &records[recordSize + 2 + kIrLength],
+                                      kIrLength * sizeof(float)) == 0;
+    std::printf("hrir set round trip: %s\n", readBack ? "ok" : "FAIL");
+    if (!readBack) return false;
+
+    // An impulse on each input channel, in odd-sized buffers
+    constexpr int32_t kFrames = 1024;
+    constexpr int32_t kLeftAt = 100;
+    constexpr int32_t kRightAt = 500;
+    std::vector<float> buffer(kFrames * kChannels, 0.0f);
+    buffer[kLeftAt * kChannels] = 1.0f;
+    buffer[kRightAt * kChannels + 1] = 0.8f;
+    std::vector<float> expected(buffer.size(), 0.0f);
+    expected[(kLeftAt + kLatency + kNearTap) * kChannels] += 1.0f;
+    expected[(kLeftAt + kLatency + kFarTap) * kChannels + 1] += 0.5f;
+    expected[(kRightAt + kLatency + kFarTap) * kChannels] += 0.4f;
+    expected[(kRightAt + kLatency + kNearTap) * kChannels + 1] += 0.8f;
+
+    BinauralRenderer renderer(*hrirs, kSampleRate);
+    for (int32_t frame = 0; frame < kFrames; frame += 37) {
+        renderer.process(buffer.data() + frame * kChannels, std::min(37, kFrames - frame), kStudio, 1.0f);
+    }
+    float maxError = 0.0f;
+    for (size_t i = 0; i < buffer.size(); i++) {
+        maxError = std::max(maxError, std::abs(buffer[i] - expected[i]));
+    }
+    const bool rendered = maxError <= kMaxDifference;
+    std::printf("binaural impulses: max error %.3g %s\n", maxError, rendered ? "" : "FAIL");
+    return ok && rendered;
+}
+
+// A 1 kHz tone at 96 kHz, fed to an analyzer built for 48 kHz and then told
+// the new rate, has to peak in band 17 of the 40 Hz to 16 kHz log scale. Band
+// edges left at 48 kHz would put it an octave low, in band 13.
+bool checkSpectrumRate() {
+    constexpr int32_t kRate = 96000;
+    constexpr int32_t kFrames = 1024;
+    constexpr float kTone = 1000.0f;
+    constexpr int32_t kExpectedBand = 17;
+
+    SpectrumAnalyzer analyzer(kSampleRate);
+    analyzer.setSampleRate(kRate);
+    analyzer.setEnabled(true);
+    std::vector<float> buffer(kFrames * kChannels);
+    float bands[SpectrumAnalyzer::kNumBands] = {};
+    bool analyzed = false;
+    // Keep the tone coming until the worker has seen a whole FFT of it
+    for (int32_t i = 0; i < 100 && !analyzed; i++) {
+        for (int32_t frame = 0; frame < kFrames; frame++) {
+            const float sample = 0.5f * std::sin(2.0f * static_cast<float>(M_PI) * kTone *
+                                                 static_cast<float>((i * kFrames + frame) % kRate) / kRate);
+            buffer[frame * kChannels] = sample;
+            buffer[frame * kChannels + 1] = sample;
+        }
+        analyzer.push(buffer.data(), kFrames, kChannels);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        analyzed = i >= 10 && analyzer.getBands(bands, SpectrumAnalyzer::kNumBands);
+    }
+    analyzer.setEnabled(false);
+
+    const int32_t peak = static_cast<int32_t>(std::max_element(bands, bands + SpectrumAnalyzer::kNumBands) - bands);
+    const bool ok = analyzed && peak == kExpectedBand;
+    std::printf("spectrum at %d Hz: 1 kHz in band %d %s\n", kRate, peak, ok ? "" : "FAIL");
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "--check") == 0) {
+        const bool independent = checkBufferSizeIndependence();
+        const bool accurate = checkRampAccuracy();
+        const bool smooth = checkGainSmoothing();
+        const bool ordered = checkStageOrder();
+        const bool fused = checkFastPaths();
+        const bool convolved = checkConvolution();
+        const bool binaural = checkBinaural();
+        const bool spectrum = checkSpectrumRate();
+        return independent && accurate && smooth && ordered && fused && convolved && binaural && spectrum
+                   ? 0
+                   : 1;
+    }
+
+    const std::vector<float> input = makeSignal(kSampleRate * 4);
+    std::printf("%8s %14s %14s %9s %14s\n", "buffer", "whole x rt", "blocked x rt", "speedup",
+                "automated x rt");
+    for (int32_t bufferFrames = kMinBufferFrames; bufferFrames <= kMaxBufferFrames; bufferFrames *= 2) {
+        double whole = measureSpeed(input, bufferFrames, 0, false);
+        double blocked = measureSpeed(input, bufferFrames, AudioEngine::kBlockFrames, false);
+        double automated = measureSpeed(input, bufferFrames, AudioEngine::kBlockFrames, true);
+        std::printf("%8d %14.1f %14.1f %8.2fx %14.1f\n", bufferFrames, whole, blocked, blocked / whole,
+                    automated);
+    }
+
+    const double packed = measureLayout<PackedState>(input);
+    const double grouped = measureLayout<GroupedState>(input);
+    std::printf("\nstate under automation: packed %.1f x rt, cache-line groups %.1f x rt, %.2fx%s\n", packed,
+                grouped, grouped / packed,
+                std::thread::hardware_concurrency() < 2 ? " (single core: no cache-line traffic)" : "");
+
+    std::printf("\n%22s %14s %14s %9s\n", "fused configuration", "generic x rt", "fused x rt", "speedup");
+    for (const FastPath& path : kFastPaths) {
+        double generic = measureSpeed(input, 1024, AudioEngine::kBlockFrames, false, path.configure, false);
+        double fused = measureSpeed(input, 1024, AudioEngine::kBlockFrames, false, path.configure, true);
+        std::printf("%22s %14.1f %14.1f %8.2fx\n", path.name, generic, fused, fused / generic);
+    }
+
+    // Paused-but-rendering: every stage's tail has long rung out
+    const std::vector<float> silence(input.size(), 0.0f);
+    std::printf("\nsilent input, %d-frame buffers: %.1f x rt\n", 1024,
+                measureSpeed(silence, 1024, AudioEngine::kBlockFrames, false));
+    return 0;
+}
@@ -0,0 +1,352 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * engine_fuzzer - libFuzzer target for AudioEngine
+ *
+ * The input is a little program: each opcode byte picks a setter (with raw
+ * float bits, so NaN, infinities and out-of-range values all come up), a
+ * reconfiguration, an impulse response or HRIR set load (EHIR files with
+ * malformed headers and truncated records) or a processAudio call with a
+ * fuzzed block size, channel count and contents. Every processed block must
+ * come back finite and within [-1, 1]; anything else aborts so the fuzzer
+ * reports it. The JNI setters forward straight to these methods, so this
+ * covers the parameter surface the app exposes. The array-taking JNI calls
+ * are replayed too: a Java array of fuzzed length with frame and channel
+ * counts that need not match it, passed through the entry point's checks
+ * (jni_checks.h) to the method behind it.
+ *
+ * Built with -DEUPHORIAE_FUZZ=ON (clang, libFuzzer + ASan + UBSan). Without
+ * libFuzzer the same target replays files or seeded random inputs:
+ *
+ *   engine_fuzzer FILE...        run each file as one input
+ *   engine_fuzzer --random N     run N pseudo-random inputs
+ */
+
+#include "audio_engine.h"
+#include "jni_checks.h"
+#include "loudness_meter.h"
+#include "true_peak_meter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <unistd.h>
+#include <vector>
+
+using euphoriae::AudioEngine;
+
+namespace {
+
+/** FuzzInput - Consumes the fuzzer's bytes, yielding zeros once exhausted */
+class FuzzInput {
+public:
+    FuzzInput(const uint8_t* data, size_t size) : mData(data), mSize(size) {}
+
+    bool empty() const { return mPos >= mSize; }
+
+    uint8_t byte() { return mPos < mSize ? mData[mPos++] : 0; }
+
+    uint16_t u16() { return static_cast<uint16_t>(byte() | (byte() << 8)); }
+
+    // Raw bits: any float, including NaN and infinities
+    float rawFloat() {
+        uint32_t bits = u16() | (static_cast<uint32_t>(u16()) << 16);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // Mostly plausible values, sometimes raw bits
+    float param() {
+        uint8_t kind = byte();
+        if (kind < 200) return (kind / 100.0f) - 0.5f + byte() / 256.0f;
+        return rawFloat();
+    }
+
+private:
+    const uint8_t* mData;
+    size_t mSize;
+    size_t mPos = 0;
+};
+
+constexpr int32_t kSampleRates[] = {8000, 11025, 22050, 44100, 48000, 96000, 192000, 1, 0, -48000, 1000000};
+constexpr int32_t kMaxBlockFrames = 8192;
+
+void fail(const char* what, int32_t index, float value) {
+    std::fprintf(stderr, "engine_fuzzer: %s at sample %d (%g)\n", what, index, value);
+    std::abort();
+}
+
+void processBlock(AudioEngine& engine, FuzzInput& in, int32_t channelCount) {
+    // Channel counts outside what the engine supports must be rejected, not crash
+    int32_t channels = channelCount;
+    uint8_t channelOverride = in.byte();
+    if (channelOverride >= 250) channels = static_cast<int32_t>(channelOverride) - 252;  // -2 .. 3
+    int32_t numFrames = in.u16() % (kMaxBlockFrames + 1);
+    if (channels <= 0 || channels > 16) {
+        float dummy[16] = {};
+        engine.processAudio(dummy, numFrames, channels);
+        return;
+    }
+
+    // Exactly sized so ASan catches any overrun
+    const int32_t numSamples = numFrames * channels;
+    std::unique_ptr<float[]> buffer(new float[numSamples > 0 ? numSamples : 1]);
+    uint8_t fill = in.byte();
+    for (int32_t i = 0; i < numSamples; i++) {
+        switch (fill % 5) {
+            case 0: buffer[i] = 0.0f; break;
+            case 1: buffer[i] = (i & 1) ? 1.0f : -1.0f; break;
+            case 2: buffer[i] = 0.5f * std::sin(0.05f * static_cast<float>(i / channels)); break;
+            case 3: buffer[i] = (static_cast<int8_t>(in.byte()) / 32.0f); break;  // Up to 4x over full scale
+            default: buffer[i] = (i % 97 == 0) ? in.rawFloat() : 0.1f; break;  // Sparse NaN/inf/huge
+        }
+    }
+
+    // Blocks with the top fill bit set go through the upmix / downmix path, with
+    // the output layout the surround mode asks for
+    const float* output = buffer.get();
+    int32_t outputSamples = numSamples;
+    std::unique_ptr<float[]> mixed;
+    if (fill & 0x80) {
+        const int32_t outputChannels = engine.outputChannelCount(channels);
+        outputSamples = numFrames * outputChannels;
+        mixed.reset(new float[outputSamples > 0 ? outputSamples : 1]);
+        engine.processAudio(buffer.get(), channels, mixed.get(), outputChannels, numFrames);
+        output = mixed.get();
+    } else {
+        engine.processAudio(buffer.get(), numFrames, channels);
+    }
+
+    for (int32_t i = 0; i < outputSamples; i++) {
+        if (!std::isfinite(output[i])) fail("non-finite output", i, output[i]);
+        if (std::abs(output[i]) > 1.0f) fail("output above full scale", i, output[i]);
+    }
+}
+
+void loadImpulseResponse(AudioEngine& engine, FuzzInput& in) {
+    int32_t channels = 1 + in.byte() % 3;  // 3 is invalid
+    int32_t numFrames = in.u16() % 600;
+    std::vector<float> ir(static_cast<size_t>(numFrames) * channels + 1);
+    for (float& tap : ir) tap = (in.byte() < 250) ? (static_cast<int8_t>(in.byte()) / 128.0f) : in.rawFloat();
+    engine.loadImpulseResponse(ir.data(), numFrames, channels);
+}
+
+// Header rates in and around HrirSet's accepted range
+constexpr uint32_t kHrirRates[] = {0, 1, 7999, 8000, 44100, 48000, 96000, 384000, 384001, 0xFFFFFFFFu};
+
+// An EHIR file that is usually well formed apart from one header field, with
+// fuzzed taps and now and then fewer records than the header promises. Each
+// load gets a new file, unlinked afterwards, so a rebuild on the engine's
+// worker never maps a file that is being rewritten.
+void loadHrirSet(AudioEngine& engine, FuzzInput& in) {
+    const char* magic = in.byte() < 240 ? "EHIR" : "EHIX";
+    const uint32_t irLength = in.byte() < 220 ? 1 + in.byte() % 96 : in.u16();
+    const uint32_t numDirections = in.byte() < 220 ? 1 + in.byte() % 6 : in.u16();
+    const uint32_t header[] = {in.byte() < 240 ? 1u : in.byte(), kHrirRates[in.byte() % std::size(kHrirRates)],
+                               irLength, numDirections};
+    size_t numFloats = std::min<size_t>(static_cast<size_t>(numDirections) * (2 + 2 * static_cast<size_t>(irLength)),
+                                        1 << 16);
+    if (in.byte() < 32) numFloats = numFloats * in.byte() / 256;
+    std::vector<float> records(numFloats);
+    for (float& value : records) value = (in.byte() < 250) ? (static_cast<int8_t>(in.byte()) / 256.0f) : in.rawFloat();
+
+    char path[] = "/tmp/engine_fuzzer_XXXXXX";
+    const int fd = mkstemp(path);
+    if (fd < 0) return;
+    const size_t recordBytes = records.size() * sizeof(float);
+    const bool written = write(fd, magic, 4) == 4 &&
+                         write(fd, header, sizeof(header)) == static_cast<ssize_t>(sizeof(header)) &&
+                         write(fd, records.data(), recordBytes) == static_cast<ssize_t>(recordBytes);
+    close(fd);
+    if (written) engine.loadHrirSet(path);
+    unlink(path);
+}
+
+// A frame or channel count as a JNI caller could pass it: usually up to limit,
+// sometimes any 32-bit value, so zero, negative and wrapping products come up
+int32_t jniCount(FuzzInput& in, int32_t limit) {
+    if (in.byte() < 200) return in.u16() % (limit + 1);
+    return static_cast<int32_t>(in.u16() | (static_cast<uint32_t>(in.u16()) << 16));
+}
+
+// Usually within a few samples of what the counts ask for, so short arrays come
+// up; exactly sized, so ASan catches any access a check lets through
+std::vector<float> javaArray(FuzzInput& in, int32_t numFrames, int32_t channelCount) {
+    const int64_t wanted = numFrames > 0 && channelCount > 0 ? static_cast<int64_t>(numFrames) * channelCount : 0;
+    int64_t length = in.u16() % (kMaxBlockFrames * 2 + 1);
+    if (in.byte() < 200 && wanted <= kMaxBlockFrames * (AudioEngine::kMaxChannels + 1)) {
+        length = std::max<int64_t>(0, wanted + in.byte() % 17 - 8);
+    }
+    std::vector<float> array(static_cast<size_t>(length));
+    for (size_t i = 0; i < array.size(); i++) array[i] = 0.25f * std::sin(0.01f * static_cast<float>(i));
+    return array;
+}
+
+// The bodies of the JNI calls that take arrays, minus the JNIEnv plumbing
+void jniCall(AudioEngine& engine, FuzzInput& in) {
+    const int32_t numFrames = jniCount(in, kMaxBlockFrames);
+    const int32_t channelCount = jniCount(in, AudioEngine::kMaxChannels + 1);
+    std::vector<float> array = javaArray(in, numFrames, channelCount);
+    const int64_t length = static_cast<int64_t>(array.size());
+    switch (in.byte() % 4) {
+        case 0:  // nativeProcessAudio
+            if (euphoriae::holdsFrames(length, numFrames, channelCount)) {
+                engine.processAudio(array.data(), numFrames, channelCount);
+            }
+            break;
+        case 1: {  // nativeProcessAudioMixed
+            const int32_t outputChannels = jniCount(in, AudioEngine::kMaxChannels + 1);
+            std::vector<float> output = javaArray(in, numFrames, outputChannels);
+            if (euphoriae::holdsFrames(length, numFrames, channelCount) &&
+                euphoriae::holdsFrames(static_cast<int64_t>(output.size()), numFrames, outputChannels)) {
+                engine.processAudio(array.data(), channelCount, output.data(), outputChannels, numFrames);
+            }
+            break;
+        }
+        case 2:  // nativeLoadImpulseResponse
+            if (euphoriae::holdsFrames(length, numFrames, channelCount)) {
+                engine.loadImpulseResponse(array.data(), numFrames, channelCount);
+            }
+            break;
+        default:  // nativeAnalyzeLoudness, through the meters analyzePcm feeds
+            if (channelCount <= euphoriae::LoudnessMeter::kMaxChannels &&
+                euphoriae::holdsFrames(length, numFrames, channelCount)) {
+                euphoriae::LoudnessMeter loudness(48000);
+                euphoriae::TruePeakMeter truePeak;
+                loudness.process(array.data(), numFrames, channelCount);
+                truePeak.process(array.data(), numFrames, channelCount);
+            }
+            break;
+    }
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    FuzzInput in(data, size);
+    AudioEngine engine;
+    int32_t channelCount = 1 + in.byte() % 8;
+    engine.configure(kSampleRates[in.byte() % std::size(kSampleRates)], channelCount);
+
+    // Bounded so one input cannot run for minutes
+    for (int32_t op = 0; op < 256 && !in.empty(); op++) {
+        switch (in.byte() % 38) {
+            case 0: engine.setVolume(in.param()); break;
+            case 1: engine.setBassBoost(in.param()); break;
+            case 2: engine.setVirtualizer(in.param()); break;
+            case 3: engine.setEqualizerBand(static_cast<int8_t>(in.byte()) % 12, in.param() * 30.0f); break;
+            case 4: engine.setCompressor(in.param() * 60.0f, in.param() * 20.0f, in.param(), in.param()); break;
+            case 5: engine.setCompressorStrength(in.param()); break;
+            case 6: engine.setLimiter(in.param()); break;
+            case 7: engine.setSurround3D(in.param()); break;
+            case 8: engine.setRoomSize(in.param()); break;
+            case 9: engine.setSurroundLevel(in.param()); break;
+            case 10: engine.setSurroundMode(static_cast<int8_t>(in.byte())); break;
+            case 11: engine.setHeadphoneSurround(in.byte() & 1); break;
+            case 12: engine.setHeadphoneType(static_cast<int8_t>(in.byte())); break;
+            case 13: engine.setClarity(in.param()); break;
+            case 14: engine.setTubeWarmth(in.param()); break;
+            case 15: engine.setSpectrumExtension(in.param()); break;
+            case 16: engine.setStereoBalance(in.param() * 2.0f); break;
+            case 17: engine.setChannelSeparation(in.param()); break;
+            case 18: engine.setTrebleBoost(in.param()); break;
+            case 19: engine.setVolumeLeveler(in.param()); break;
+            case 20: engine.setVolumeLevelerTarget(in.param() * 40.0f); break;
+            case 21: engine.setTrackGain(in.param() * 40.0f); break;
+            case 22: engine.setDynamicRange(in.param()); break;
+            case 23: engine.setLoudnessGain(in.param()); break;
+            case 24: engine.setReverb(static_cast<int8_t>(in.byte()), in.param()); break;
+            case 25: loadImpulseResponse(engine, in); break;
+            case 26: engine.clearImpulseResponse(); break;
+            case 27: engine.setConvolutionMix(in.param()); break;
+            case 28: engine.setTempo(in.param() * 3.0f); engine.setPitch(in.param() * 30.0f); break;
+            case 29:
+                channelCount = 1 + in.byte() % 8;
+                engine.configure(kSampleRates[in.byte() % std::size(kSampleRates)], channelCount);
+                break;
+            case 30: engine.setBassFrequency(in.param() * 400.0f); engine.setBassMode(static_cast<int8_t>(in.byte())); break;
+            case 31: engine.reset(); break;
+            case 32:
+                // Starts in the past or ahead, unknown parameters and curves
+                engine.scheduleRamp(in.byte() % 3, in.param(), engine.getFramePosition() + static_cast<int16_t>(in.u16()),
+                                    in.u16(), static_cast<euphoriae::RampCurve>(in.byte() % 3));
+                break;
+            case 33: {
+                // Mostly permutations, with an occasional duplicate or out-of-range stage
+                int32_t order[AudioEngine::kNumChainStages];
+                for (int32_t i = 0; i < AudioEngine::kNumChainStages; i++) order[i] = i;
+                for (int32_t i = AudioEngine::kNumChainStages - 1; i > 0; i--) {
+                    std::swap(order[i], order[in.byte() % (i + 1)]);
+                }
+                uint8_t corrupt = in.byte();
+                if (corrupt >= 240) order[corrupt % AudioEngine::kNumChainStages] = corrupt - 245;
+                engine.setStageOrder(order, AudioEngine::kNumChainStages);
+                break;
+            }
+            case 34: engine.setFastPathsEnabled(in.byte() % 2 == 0); break;
+            case 35: jniCall(engine, in); break;
+            case 36: loadHrirSet(engine, in); break;
+            default: processBlock(engine, in, channelCount); break;
+        }
+    }
+    return 0;
+}
+
+#ifndef EUPHORIAE_LIBFUZZER
+
+#include <random>
+
+int main(int argc, char** argv) {
+    if (argc == 3 && std::strcmp(argv[1], "--random") == 0) {
+        const int count = std::atoi(argv[2]);
+        std::mt19937 rng(20260101);
+        std::vector<uint8_t> data;
+        for (int i = 0; i < count; i++) {
+            data.resize(64 + rng() % 2048);
+            for (uint8_t& b : data) b = static_cast<uint8_t>(rng());
+            LLVMFuzzerTestOneInput(data.data(), data.size());
+        }
+        std::printf("%d random inputs ran clean\n", count);
+        return 0;
+    }
+
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: engine_fuzzer FILE... | --random N\n");
+        return 2;
+    }
+    for (int i = 1; i < argc; i++) {
+        FILE* file = std::fopen(argv[i], "rb");
+        if (file == nullptr) {
+            std::fprintf(stderr, "Cannot read %s\n", argv[i]);
+            return 1;
+        }
+        std::vector<uint8_t> data;
+        uint8_t chunk[4096];
+        for (size_t n; (n = std::fread(chunk, 1, sizeof(chunk), file)) > 0;) data.insert(data.end(), chunk, chunk + n);
+        std::fclose(file);
+        LLVMFuzzerTestOneInput(data.data(), data.size());
+    }
+    std::printf("%d inputs ran clean\n", argc - 1);
+    return 0;
+}
+
+#endif // EUPHORIAE_LIBFUZZER
@@ -0,0 +1,185 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * fft_benchmark - Host accuracy check and benchmark for FftPlan
+ *
+ * Compares every supported size against a double-precision naive DFT, checks
+ * round trips and the packed in-place layout, then times the FFT against a
+ * single-precision naive DFT. Exits non-zero if any accuracy check fails.
+ *
+ *   fft_benchmark           accuracy + timing
+ *   fft_benchmark --check   accuracy only
+ */
+
+#include "fft.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using euphoriae::FftPlan;
+
+namespace {
+
+constexpr double kMaxRelativeError = 2e-6;
+constexpr int32_t kFullReferenceSize = 4096;  // Above this, only a subset of bins is checked
+constexpr int32_t kNaiveTimingSize = 4096;    // Above this, the naive DFT is too slow to time
+
+struct Accuracy {
+    double spectrumError;  // RMS error relative to RMS magnitude
+    double roundTripError; // Max absolute error
+    double packedError;    // Max difference between packed and split layouts
+};
+
+Accuracy measureAccuracy(int32_t size, std::mt19937& rng) {
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    auto plan = FftPlan::get(size);
+    const int32_t numBins = plan->numBins();
+
+    std::vector<float> input(size), output(size), packed(size), work(plan->workSize());
+    std::vector<float> re(numBins), im(numBins);
+    for (float& x : input) x = dist(rng);
+
+    plan->forward(input.data(), re.data(), im.data(), work.data());
+
+    // Reference DFT in double precision with an exact twiddle table
+    std::vector<double> cosTable(size), sinTable(size);
+    for (int32_t i = 0; i < size; i++) {
+        cosTable[i] = std::cos(2.0 * M_PI * i / size);
+        sinTable[i] = -std::sin(2.0 * M_PI * i / size);
+    }
+    int32_t binStep = size <= kFullReferenceSize ? 1 : size / 256;
+    double errorSum = 0.0, magnitudeSum = 0.0;
+    for (int32_t k = 0; k < numBins; k += binStep) {
+        double sumRe = 0.0, sumIm = 0.0;
+        for (int32_t n = 0; n < size; n++) {
+            int32_t index = static_cast<int32_t>((static_cast<int64_t>(k) * n) % size);
+            sumRe += input[n] * cosTable[index];
+            sumIm += input[n] * sinTable[index];
+        }
+        double dRe = re[k] - sumRe, dIm = im[k] - sumIm;
+        errorSum += dRe * dRe + dIm * dIm;
+        magnitudeSum += sumRe * sumRe + sumIm * sumIm;
+    }
+
+    Accuracy result{};
+    result.spectrumError = std::sqrt(errorSum / magnitudeSum);
+
+    plan->inverse(re.data(), im.data(), output.data(), work.data());
+    for (int32_t i = 0; i < size; i++) {
+        result.roundTripError = std::max(result.roundTripError,
+                                         static_cast<double>(std::fabs(output[i] - input[i])));
+    }
+
+    std::memcpy(packed.data(), input.data(), size * sizeof(float));
+    plan->forwardInPlace(packed.data(), work.data());
+    result.packedError = std::max(std::fabs(packed[0] - re[0]), std::fabs(packed[1] - re[size / 2]));
+    for (int32_t k = 1; k < size / 2; k++) {
+        result.packedError = std::max(result.packedError, static_cast<double>(std::fabs(packed[2 * k] - re[k])));
+        result.packedError = std::max(result.packedError, static_cast<double>(std::fabs(packed[2 * k + 1] - im[k])));
+    }
+    plan->inverseInPlace(packed.data(), work.data());
+    for (int32_t i = 0; i < size; i++) {
+        result.roundTripError = std::max(result.roundTripError,
+                                         static_cast<double>(std::fabs(packed[i] - input[i])));
+    }
+    return result;
+}
+
+template <typename Function>
+double nanosecondsPerCall(Function&& function) {
+    using Clock = std::chrono::steady_clock;
+    int64_t iterations = 1;
+    for (;;) {
+        auto start = Clock::now();
+        for (int64_t i = 0; i < iterations; i++) function();
+        double elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        if (elapsed > 2.0e8 || iterations >= (int64_t{1} << 30)) return elapsed / iterations;
+        iterations *= 2;
+    }
+}
+
+void naiveDft(const float* input, float* re, float* im, const float* cosTable,
+              const float* sinTable, int32_t size) {
+    for (int32_t k = 0; k <= size / 2; k++) {
+        float sumRe = 0.0f, sumIm = 0.0f;
+        int32_t index = 0;
+        for (int32_t n = 0; n < size; n++) {
+            sumRe += input[n] * cosTable[index];
+            sumIm += input[n] * sinTable[index];
+            index += k;
+            if (index >= size) index -= size;
+        }
+        re[k] = sumRe;
+        im[k] = sumIm;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool checkOnly = argc > 1 && std::strcmp(argv[1], "--check") == 0;
+    std::mt19937 rng(1234);
+    bool passed = true;
+
+    std::printf("%8s %12s %12s %12s", "size", "rel.error", "roundtrip", "packed");
+    if (!checkOnly) std::printf(" %12s %12s %10s", "fft ns", "naive ns", "speedup");
+    std::printf("\n");
+
+    for (int32_t size = FftPlan::kMinSize; size <= FftPlan::kMaxSize; size *= 2) {
+        Accuracy accuracy = measureAccuracy(size, rng);
+        bool ok = accuracy.spectrumError < kMaxRelativeError &&
+                  accuracy.roundTripError < 1e-5 && accuracy.packedError < 1e-6;
+        passed = passed && ok;
+        std::printf("%8d %12.3g %12.3g %12.3g", size, accuracy.spectrumError,
+                    accuracy.roundTripError, accuracy.packedError);
+
+        if (!checkOnly) {
+            auto plan = FftPlan::get(size);
+            std::vector<float> input(size), re(plan->numBins()), im(plan->numBins());
+            std::vector<float> work(plan->workSize());
+            std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+            for (float& x : input) x = dist(rng);
+
+            double fftNs = nanosecondsPerCall([&] {
+                plan->forward(input.data(), re.data(), im.data(), work.data());
+            });
+            std::printf(" %12.0f", fftNs);
+
+            if (size <= kNaiveTimingSize) {
+                std::vector<float> cosTable(size), sinTable(size);
+                for (int32_t i = 0; i < size; i++) {
+                    cosTable[i] = static_cast<float>(std::cos(2.0 * M_PI * i / size));
+                    sinTable[i] = static_cast<float>(-std::sin(2.0 * M_PI * i / size));
+                }
+                double naiveNs = nanosecondsPerCall([&] {
+                    naiveDft(input.data(), re.data(), im.data(), cosTable.data(), sinTable.data(), size);
+                });
+                std::printf(" %12.0f %9.0fx", naiveNs, naiveNs / fftNs);
+            } else {
+                std::printf(" %12s %10s", "-", "-");
+            }
+        }
+        std::printf("%s\n", ok ? "" : "  FAILED");
+    }
+
+    std::printf("%s\n", passed ? "All accuracy checks passed" : "Accuracy checks FAILED");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * kernel_benchmark - Host check and benchmark for the DspKernels sets
+ *
+ * Prints the CPU features and the set dspKernels() picked, then runs every set
+ * this CPU supports against a double-precision reference: the convolver's
+ * 64-tap FIR head and the spectrum multiply-accumulate at the partition sizes
+ * the convolver uses. Timing compares each set with the baseline. Exits
+ * non-zero if any set is off by more than float rounding.
+ *
+ *   kernel_benchmark           accuracy + timing
+ *   kernel_benchmark --check   accuracy only
+ */
+
+#include "cpu_features.h"
+#include "dsp_kernels.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using euphoriae::DspKernels;
+
+namespace {
+
+constexpr int32_t kMaxKernels = 4;
+constexpr int32_t kFirTaps = 64;        // Convolver::kHeadLength
+constexpr int32_t kFirOutputs = 64;
+constexpr int32_t kSpectrumBins[] = {65, 257, 1025, 4097};  // Partitions of 64 to 4096 frames
+constexpr double kMaxRelativeError = 1e-5;
+
+std::vector<float> randomVector(size_t size, std::mt19937& rng) {
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> values(size);
+    for (float& x : values) x = dist(rng);
+    return values;
+}
+
+// Largest error relative to the largest reference value
+double relativeError(const std::vector<float>& values, const std::vector<double>& reference) {
+    double error = 0.0;
+    double scale = 0.0;
+    for (size_t i = 0; i < values.size(); i++) {
+        error = std::max(error, std::fabs(values[i] - reference[i]));
+        scale = std::max(scale, std::fabs(reference[i]));
+    }
+    return error / scale;
+}
+
+// Odd tap counts and numbers of outputs exercise the scalar tails
+double firError(const DspKernels& kernels, std::mt19937& rng) {
+    double worst = 0.0;
+    for (int32_t numTaps : {kFirTaps, 37}) {
+        const std::vector<float> taps = randomVector(numTaps, rng);
+        const std::vector<float> input = randomVector(numTaps + kFirOutputs, rng);
+        std::vector<float> output(kFirOutputs - 3);
+        kernels.fir(taps.data(), numTaps, input.data(), output.data(), static_cast<int32_t>(output.size()));
+        std::vector<double> reference(output.size(), 0.0);
+        for (size_t j = 0; j < output.size(); j++) {
+            for (int32_t k = 0; k < numTaps; k++) reference[j] += static_cast<double>(taps[k]) * input[j + k];
+        }
+        worst = std::max(worst, relativeError(output, reference));
+    }
+    return worst;
+}
+
+double spectrumError(const DspKernels& kernels, std::mt19937& rng) {
+    double worst = 0.0;
+    for (int32_t numBins : kSpectrumBins) {
+        const std::vector<float> aRe = randomVector(numBins, rng), aIm = randomVector(numBins, rng);
+        const std::vector<float> bRe = randomVector(numBins, rng), bIm = randomVector(numBins, rng);
+        std::vector<float> accRe = randomVector(numBins, rng), accIm = randomVector(numBins, rng);
+        std::vector<double> refRe(accRe.begin(), accRe.end()), refIm(accIm.begin(), accIm.end());
+        kernels.spectrumMultiplyAccumulate(aRe.data(), aIm.data(), bRe.data(), bIm.data(), accRe.data(),
+                                           accIm.data(), numBins);
+        for (int32_t k = 0; k < numBins; k++) {
+            refRe[k] += static_cast<double>(aRe[k]) * bRe[k] - static_cast<double>(aIm[k]) * bIm[k];
+            refIm[k] += static_cast<double>(aRe[k]) * bIm[k] + static_cast<double>(aIm[k]) * bRe[k];
+        }
+        worst = std::max({worst, relativeError(accRe, refRe), relativeError(accIm, refIm)});
+    }
+    return worst;
+}
+
+template <typename Function>
+double nanosecondsPerCall(Function&& function) {
+    using Clock = std::chrono::steady_clock;
+    int64_t iterations = 1;
+    for (;;) {
+        auto start = Clock::now();
+        for (int64_t i = 0; i < iterations; i++) function();
+        double elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        if (elapsed > 2.0e8 || iterations >= (int64_t{1} << 30)) return elapsed / iterations;
+        iterations *= 2;
+    }
+}
+
+// One convolver head block, and 16 partitions of a 1024-frame segment
+void printTimings(const DspKernels* const* kernels, int32_t numKernels, std::mt19937& rng) {
+    constexpr int32_t kBins = 1025;
+    constexpr int32_t kPartitions = 16;
+    const std::vector<float> taps = randomVector(kFirTaps, rng);
+    const std::vector<float> input = randomVector(kFirTaps + kFirOutputs, rng);
+    const std::vector<float> fdlRe = randomVector(kBins * kPartitions, rng);
+    const std::vector<float> fdlIm = randomVector(kBins * kPartitions, rng);
+    const std::vector<float> filterRe = randomVector(kBins * kPartitions, rng);
+    const std::vector<float> filterIm = randomVector(kBins * kPartitions, rng);
+    std::vector<float> output(kFirOutputs), accRe(kBins), accIm(kBins);
+
+    std::printf("\n%10s %14s %9s %18s %9s\n", "kernels", "fir ns/block", "speedup", "spectrum ns/seg", "speedup");
+    double baseFir = 0.0;
+    double baseSpectrum = 0.0;
+    for (int32_t i = 0; i < numKernels; i++) {
+        const DspKernels& k = *kernels[i];
+        double fir = nanosecondsPerCall([&] {
+            k.fir(taps.data(), kFirTaps, input.data(), output.data(), kFirOutputs);
+        });
+        double spectrum = nanosecondsPerCall([&] {
+            for (int32_t p = 0; p < kPartitions; p++) {
+                k.spectrumMultiplyAccumulate(fdlRe.data() + p * kBins, fdlIm.data() + p * kBins,
+                                             filterRe.data() + p * kBins, filterIm.data() + p * kBins,
+                                             accRe.data(), accIm.data(), kBins);
+            }
+        });
+        if (i == 0) {
+            baseFir = fir;
+            baseSpectrum = spectrum;
+        }
+        std::printf("%10s %14.1f %8.2fx %18.1f %8.2fx\n", k.name, fir, baseFir / fir, spectrum,
+                    baseSpectrum / spectrum);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool checkOnly = argc > 1 && std::strcmp(argv[1], "--check") == 0;
+    const euphoriae::CpuFeatures& cpu = euphoriae::cpuFeatures();
+    std::printf("cpu: avx2 %d, fma %d, neon %d, dot product %d, fp16 %d; using %s\n", cpu.avx2, cpu.fma,
+                cpu.neon, cpu.dotProduct, cpu.fp16, euphoriae::dspKernels().name);
+
+    const DspKernels* kernels[kMaxKernels];
+    const int32_t numKernels = euphoriae::supportedDspKernels(kernels, kMaxKernels);
+    std::mt19937 rng(2026);
+    bool ok = true;
+    for (int32_t i = 0; i < numKernels; i++) {
+        const double fir = firError(*kernels[i], rng);
+        const double spectrum = spectrumError(*kernels[i], rng);
+        const bool pass = fir <= kMaxRelativeError && spectrum <= kMaxRelativeError;
+        std::printf("%10s: fir error %.2e, spectrum error %.2e%s\n", kernels[i]->name, fir, spectrum,
+                    pass ? "" : " FAIL");
+        ok &= pass;
+    }
+
+    if (!checkOnly) printTimings(kernels, numKernels, rng);
+    return ok ? 0 : 1;
+}
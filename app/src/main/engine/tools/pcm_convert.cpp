@@ -0,0 +1,174 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * pcm_convert - Converts WAV / RF64 files between sample formats
+ *
+ *   pcm_convert [--format F] input.wav output.wav
+ *     --format F   int16, int24, int32 or float (default)
+ *
+ *   pcm_convert --check
+ *     Round-trips every format through PcmWriter and PcmReader, across
+ *     mapping windows, and exits non-zero on any mismatch.
+ */
+
+#include "pcm_file.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using euphoriae::PcmReader;
+using euphoriae::PcmWriter;
+using euphoriae::SampleFormat;
+
+namespace {
+
+struct FormatName {
+    const char* name;
+    SampleFormat format;
+    float tolerance;  // One step: rounding, plus +1.0 clipping to the largest code
+};
+
+constexpr FormatName kFormats[] = {
+    {"int16", SampleFormat::kInt16, 1.0f / 32768.0f},
+    {"int24", SampleFormat::kInt24, 1.0f / 8388608.0f},
+    {"int32", SampleFormat::kInt32, 1e-7f},
+    {"float", SampleFormat::kFloat32, 0.0f},
+};
+
+int usage() {
+    std::fprintf(stderr, "usage: pcm_convert [--format int16|int24|int32|float] input.wav output.wav\n"
+                         "       pcm_convert --check\n");
+    return 2;
+}
+
+bool checkFormat(const FormatName& format, const std::string& path) {
+    // 70 s of stereo crosses at least one 16 MB mapping window for every format,
+    // and an odd frame count exercises the pad byte for 24-bit
+    constexpr int32_t kSampleRate = 48000;
+    constexpr int32_t kChannels = 2;
+    constexpr int64_t kFrames = 70LL * kSampleRate + 1;
+    constexpr int32_t kChunk = 4093;
+    auto sample = [](int64_t i) {
+        if (i < 4) return (i & 1) ? -1.0f : 1.0f;  // Full scale both ways
+        return 0.9f * std::sin(static_cast<float>(i % 100003) * 0.001f);
+    };
+
+    std::unique_ptr<PcmWriter> writer = PcmWriter::create(path.c_str(), kSampleRate, kChannels, format.format);
+    if (!writer) return false;
+    std::vector<float> pcm(static_cast<size_t>(kChunk) * kChannels);
+    for (int64_t frame = 0; frame < kFrames; frame += kChunk) {
+        int32_t count = static_cast<int32_t>(std::min<int64_t>(kChunk, kFrames - frame));
+        for (int32_t i = 0; i < count * kChannels; i++) pcm[i] = sample(frame * kChannels + i);
+        if (!writer->write(pcm.data(), count)) return false;
+    }
+    if (!writer->close()) return false;
+
+    std::unique_ptr<PcmReader> reader = PcmReader::open(path.c_str());
+    if (!reader || reader->numFrames() != kFrames || reader->channelCount() != kChannels ||
+        reader->sampleRate() != kSampleRate || reader->format() != format.format) {
+        return false;
+    }
+
+    float maxError = 0.0f;
+    int64_t frame = 0;
+    for (int32_t count; (count = reader->read(pcm.data(), kChunk)) > 0; frame += count) {
+        for (int32_t i = 0; i < count * kChannels; i++) {
+            maxError = std::max(maxError, std::abs(pcm[i] - sample(frame * kChannels + i)));
+        }
+    }
+    bool ok = frame == kFrames && maxError <= format.tolerance;
+
+    // Float files also read in place
+    if (format.format == SampleFormat::kFloat32) {
+        reader->seek(0);
+        int64_t mappedFrames = 0;
+        int32_t count = 0;
+        for (const float* mapped; (mapped = reader->mapFloatFrames(kChunk, &count)) != nullptr;) {
+            ok = ok && reinterpret_cast<uintptr_t>(mapped) % alignof(float) == 0;
+            for (int32_t i = 0; ok && i < count * kChannels; i++) {
+                ok = mapped[i] == sample(mappedFrames * kChannels + i);
+            }
+            mappedFrames += count;
+        }
+        ok = ok && mappedFrames == kFrames;
+    }
+
+    std::printf("%-6s max error %.3g%s\n", format.name, maxError, ok ? "" : "  FAILED");
+    return ok;
+}
+
+int runCheck() {
+    const std::string path = "pcm_convert_check.wav";
+    bool passed = true;
+    for (const FormatName& format : kFormats) {
+        passed = checkFormat(format, path) && passed;
+    }
+    std::remove(path.c_str());
+    std::printf("%s\n", passed ? "All round trips passed" : "Round trip checks FAILED");
+    return passed ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "--check") == 0) return runCheck();
+
+    SampleFormat format = SampleFormat::kFloat32;
+    int first = 1;
+    if (argc > 2 && std::strcmp(argv[1], "--format") == 0) {
+        const FormatName* match = nullptr;
+        for (const FormatName& f : kFormats) {
+            if (std::strcmp(argv[2], f.name) == 0) match = &f;
+        }
+        if (match == nullptr) return usage();
+        format = match->format;
+        first = 3;
+    }
+    if (argc - first != 2) return usage();
+
+    std::unique_ptr<PcmReader> reader = PcmReader::open(argv[first]);
+    if (!reader) {
+        std::fprintf(stderr, "Cannot read %s\n", argv[first]);
+        return 1;
+    }
+    std::unique_ptr<PcmWriter> writer = PcmWriter::create(argv[first + 1], reader->sampleRate(),
+                                                          reader->channelCount(), format);
+    if (!writer) {
+        std::fprintf(stderr, "Cannot write %s\n", argv[first + 1]);
+        return 1;
+    }
+
+    constexpr int32_t kChunk = 65536;
+    std::vector<float> pcm(static_cast<size_t>(kChunk) * reader->channelCount());
+    bool ok = true;
+    for (int32_t count; ok && (count = reader->read(pcm.data(), kChunk)) > 0;) {
+        ok = writer->write(pcm.data(), count);
+    }
+    ok = writer->close() && ok;
+    if (!ok) {
+        std::fprintf(stderr, "Converting %s failed\n", argv[first]);
+        return 1;
+    }
+    std::printf("%s: %lld frames\n", argv[first + 1], static_cast<long long>(writer->numFrames()));
+    return 0;
+}
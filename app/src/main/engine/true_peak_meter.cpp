@@ -0,0 +1,75 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "true_peak_meter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace euphoriae {
+
+TruePeakMeter::TruePeakMeter() {
+    // Windowed sinc with cutoff at the original Nyquist, split into phases.
+    // The even tap count puts every phase between input samples, so all four are evaluated.
+    constexpr int32_t kTaps = kOversampling * kTapsPerPhase;
+    const double center = (kTaps - 1) / 2.0;
+    for (int32_t n = 0; n < kTaps; n++) {
+        double t = (n - center) / kOversampling;
+        double sinc = (std::abs(t) < 1e-9) ? 1.0 : std::sin(M_PI * t) / (M_PI * t);
+        double window = 0.5 - 0.5 * std::cos(2.0 * M_PI * (n + 0.5) / kTaps);
+        mPhases[n % kOversampling][n / kOversampling] = static_cast<float>(sinc * window);
+    }
+    reset();
+}
+
+void TruePeakMeter::reset() {
+    for (auto& history : mHistory) history.fill(0.0f);
+    mHistoryPos = 0;
+    mPeak = 0.0f;
+}
+
+void TruePeakMeter::process(const float* buffer, int32_t numFrames, int32_t channelCount) {
+    if (buffer == nullptr || channelCount <= 0) return;
+    const int32_t channels = std::min(channelCount, kMaxChannels);
+
+    float peak = mPeak;
+    int32_t pos = mHistoryPos;
+    for (int32_t i = 0; i < numFrames; i++) {
+        for (int32_t ch = 0; ch < channels; ch++) {
+            float x = buffer[i * channelCount + ch];
+            peak = std::max(peak, std::abs(x));
+
+            // Newest sample lands in both halves, so window [pos, pos + taps) is always contiguous
+            auto& history = mHistory[ch];
+            history[pos] = x;
+            history[pos + kTapsPerPhase] = x;
+            const float* window = history.data() + pos + 1;
+
+            for (int32_t p = 0; p < kOversampling; p++) {
+                const auto& phase = mPhases[p];
+                float y = 0.0f;
+                for (int32_t k = 0; k < kTapsPerPhase; k++) {
+                    y += phase[kTapsPerPhase - 1 - k] * window[k];
+                }
+                peak = std::max(peak, std::abs(y));
+            }
+        }
+        pos = (pos + 1) % kTapsPerPhase;
+    }
+    mHistoryPos = pos;
+    mPeak = peak;
+}
+
+} // namespace euphoriae
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EUPHORIAE_TRUE_PEAK_METER_H
+#define EUPHORIAE_TRUE_PEAK_METER_H
+
+#include <array>
+#include <cstdint>
+
+namespace euphoriae {
+
+/**
+ * TruePeakMeter - Inter-sample peak estimate per ITU-R BS.1770 Annex 2
+ *
+ * Each channel is upsampled 4x with a 48-tap windowed-sinc polyphase filter
+ * (12 taps per phase) and the largest absolute value is kept.
+ */
+class TruePeakMeter {
+public:
+    static constexpr int32_t kMaxChannels = 8;
+    static constexpr int32_t kOversampling = 4;
+    static constexpr int32_t kTapsPerPhase = 12;
+
+    TruePeakMeter();
+
+    void reset();
+    void process(const float* buffer, int32_t numFrames, int32_t channelCount);
+
+    // Linear peak over everything processed since reset
+    float peak() const { return mPeak; }
+
+private:
+    std::array<std::array<float, kTapsPerPhase>, kOversampling> mPhases{};
+    std::array<std::array<float, kTapsPerPhase * 2>, kMaxChannels> mHistory{};  // Mirrored for contiguous reads
+    int32_t mHistoryPos = 0;
+    float mPeak = 0.0f;
+};
+
+} // namespace euphoriae
+
+#endif // EUPHORIAE_TRUE_PEAK_METER_H
@@ -6,6 +6,7 @@ import com.oss.euphoriae.data.model.CachedLyrics
 import com.oss.euphoriae.data.model.Playlist
 import com.oss.euphoriae.data.model.PlaylistSong
 import com.oss.euphoriae.data.model.Song
+import com.oss.euphoriae.data.model.TrackLoudness
 import kotlinx.coroutines.flow.Flow
 
 @Dao
@@ -71,6 +72,19 @@ interface MusicDao {
     
     @Query("DELETE FROM cached_lyrics WHERE songId = :songId")
     suspend fun deleteCachedLyrics(songId: Long)
+    
+    // Track Loudness
+    @Query("SELECT * FROM track_loudness WHERE songId = :songId")
+    suspend fun getTrackLoudness(songId: Long): TrackLoudness?
+    
+    @Insert(onConflict = OnConflictStrategy.REPLACE)
+    suspend fun insertTrackLoudness(loudness: List<TrackLoudness>)
+    
+    @Query("SELECT s.* FROM songs s LEFT JOIN track_loudness tl ON s.id = tl.songId WHERE tl.songId IS NULL")
+    suspend fun getSongsWithoutLoudness(): List<Song>
+    
+    @Query("SELECT s.id, s.data, tl.analyzedAt FROM songs s INNER JOIN track_loudness tl ON s.id = tl.songId")
+    suspend fun getAnalyzedSongs(): List<AnalyzedSong>
 }
 
 data class PlaylistItem(
@@ -78,3 +92,9 @@ data class PlaylistItem(
     val albumArtUri: String?
 )
 
+data class AnalyzedSong(
+    val id: Long,
+    val data: String,
+    val analyzedAt: Long
+)
+
@@ -10,10 +10,11 @@ import com.oss.euphoriae.data.model.CachedLyrics
 import com.oss.euphoriae.data.model.Playlist
 import com.oss.euphoriae.data.model.PlaylistSong
 import com.oss.euphoriae.data.model.Song
+import com.oss.euphoriae.data.model.TrackLoudness
 
 @Database(
-    entities = [Song::class, Playlist::class, PlaylistSong::class, CachedLyrics::class],
-    version = 3,
+    entities = [Song::class, Playlist::class, PlaylistSong::class, CachedLyrics::class, TrackLoudness::class],
+    version = 4,
     exportSchema = false
 )
 abstract class MusicDatabase : RoomDatabase() {
@@ -45,6 +46,20 @@ abstract class MusicDatabase : RoomDatabase() {
             }
         }
         
+        private val MIGRATION_3_4 = object : Migration(3, 4) {
+            override fun migrate(database: SupportSQLiteDatabase) {
+                database.execSQL("""
+                    CREATE TABLE IF NOT EXISTS track_loudness (
+                        songId INTEGER PRIMARY KEY NOT NULL,
+                        integratedLufs REAL NOT NULL,
+                        truePeakDb REAL NOT NULL,
+                        loudnessRange REAL NOT NULL,
+                        analyzedAt INTEGER NOT NULL
+                    )
+                """)
+            }
+        }
+        
         fun getDatabase(context: Context): MusicDatabase {
             return INSTANCE ?: synchronized(this) {
                 val instance = Room.databaseBuilder(
@@ -52,7 +67,7 @@ abstract class MusicDatabase : RoomDatabase() {
                     MusicDatabase::class.java,
                     "euphoriae_database"
                 )
-                .addMigrations(MIGRATION_1_2, MIGRATION_2_3)
+                .addMigrations(MIGRATION_1_2, MIGRATION_2_3, MIGRATION_3_4)
                 .build()
                 INSTANCE = instance
                 instance
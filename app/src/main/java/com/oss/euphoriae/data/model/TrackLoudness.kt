@@ -0,0 +1,34 @@
+package com.oss.euphoriae.data.model
+
+import androidx.room.Entity
+import androidx.room.PrimaryKey
+
+/**
+ * Room entity caching the loudness analysis of a song (EBU R128 / ReplayGain 2.0)
+ * so the library only has to be scanned once. NaN values mark a song that was
+ * scanned but has no measurable loudness.
+ */
+@Entity(tableName = "track_loudness")
+data class TrackLoudness(
+    @PrimaryKey
+    val songId: Long,
+    val integratedLufs: Float,
+    val truePeakDb: Float, // dBTP
+    val loudnessRange: Float, // LU
+    val analyzedAt: Long = System.currentTimeMillis()
+) {
+    /**
+     * Gain that brings the track to [referenceLufs], reduced so the true peak
+     * stays below [peakCeilingDb]; unity if the track has no measured loudness
+     */
+    fun gainDb(referenceLufs: Float = REFERENCE_LUFS, peakCeilingDb: Float = PEAK_CEILING_DB): Float {
+        if (integratedLufs.isNaN()) return 0f
+        val gain = referenceLufs - integratedLufs
+        return minOf(gain, peakCeilingDb - truePeakDb)
+    }
+
+    companion object {
+        const val REFERENCE_LUFS = -18f // ReplayGain 2.0 reference
+        const val PEAK_CEILING_DB = -1f
+    }
+}
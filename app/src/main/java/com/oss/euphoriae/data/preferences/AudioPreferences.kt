@@ -2,6 +2,7 @@ package com.oss.euphoriae.data.preferences
 
 import android.content.Context
 import android.content.SharedPreferences
+import com.oss.euphoriae.engine.AudioEngine
 import kotlinx.coroutines.channels.awaitClose
 import kotlinx.coroutines.flow.Flow
 import kotlinx.coroutines.flow.callbackFlow
@@ -53,6 +54,8 @@ class AudioPreferences(context: Context) {
         private const val KEY_SELECTED_PRESET = "selected_preset"
         private const val KEY_BAND_PREFIX = "band_"
         private const val KEY_BASS_BOOST = "bass_boost"
+        private const val KEY_BASS_FREQUENCY = "bass_frequency"
+        private const val KEY_VIRTUAL_BASS = "virtual_bass"
         private const val KEY_VIRTUALIZER = "virtualizer"
         
         // DAC keys
@@ -76,6 +79,7 @@ class AudioPreferences(context: Context) {
         private const val KEY_VOLUME_LEVELER = "volume_leveler"
         private const val KEY_LIMITER = "limiter"
         private const val KEY_DYNAMIC_RANGE = "dynamic_range"
+        private const val KEY_TRACK_GAIN = "track_gain"
         
         // Enhancement keys
         private const val KEY_CLARITY = "clarity"
@@ -103,6 +107,12 @@ class AudioPreferences(context: Context) {
     fun getBassBoost(): Float = prefs.getFloat(KEY_BASS_BOOST, 0f)
     fun setBassBoost(level: Float) = prefs.edit().putFloat(KEY_BASS_BOOST, level).apply()
     
+    fun getBassFrequency(): Float = prefs.getFloat(KEY_BASS_FREQUENCY, AudioEngine.BASS_FREQUENCY_DEFAULT)
+    fun setBassFrequency(hz: Float) = prefs.edit().putFloat(KEY_BASS_FREQUENCY, hz).apply()
+    
+    fun getVirtualBass(): Boolean = prefs.getBoolean(KEY_VIRTUAL_BASS, false)
+    fun setVirtualBass(enabled: Boolean) = prefs.edit().putBoolean(KEY_VIRTUAL_BASS, enabled).apply()
+    
     fun getVirtualizer(): Float = prefs.getFloat(KEY_VIRTUALIZER, 0f)
     fun setVirtualizer(level: Float) = prefs.edit().putFloat(KEY_VIRTUALIZER, level).apply()
     
@@ -180,6 +190,23 @@ class AudioPreferences(context: Context) {
     fun getDynamicRange(): Float = prefs.getFloat(KEY_DYNAMIC_RANGE, 1f)
     fun setDynamicRange(range: Float) = prefs.edit().putFloat(KEY_DYNAMIC_RANGE, range).apply()
     
+    // Per-track loudness normalization; also what the library loudness scan runs for
+    fun isTrackGainEnabled(): Boolean = prefs.getBoolean(KEY_TRACK_GAIN, false)
+    fun setTrackGainEnabled(enabled: Boolean) = prefs.edit().putBoolean(KEY_TRACK_GAIN, enabled).apply()
+    
+    val trackGainEnabledFlow: Flow<Boolean> = callbackFlow {
+        val listener = SharedPreferences.OnSharedPreferenceChangeListener { _, key ->
+            if (key == KEY_TRACK_GAIN) {
+                trySend(isTrackGainEnabled())
+            }
+        }
+        trySend(isTrackGainEnabled())
+        prefs.registerOnSharedPreferenceChangeListener(listener)
+        awaitClose {
+            prefs.unregisterOnSharedPreferenceChangeListener(listener)
+        }
+    }
+    
     // ================== Audio Enhancement ==================
     
     fun getClarity(): Float = prefs.getFloat(KEY_CLARITY, 0f)
@@ -228,6 +255,7 @@ class AudioPreferences(context: Context) {
             .putFloat(KEY_VOLUME_LEVELER, 0f)
             .putFloat(KEY_LIMITER, 0f)
             .putFloat(KEY_DYNAMIC_RANGE, 1f)
+            .putBoolean(KEY_TRACK_GAIN, false)
             .apply()
     }
     
@@ -245,6 +273,8 @@ class AudioPreferences(context: Context) {
             .putBoolean(KEY_EQ_ENABLED, true)
             .putString(KEY_SELECTED_PRESET, "Flat")
             .putFloat(KEY_BASS_BOOST, 0f)
+            .putFloat(KEY_BASS_FREQUENCY, AudioEngine.BASS_FREQUENCY_DEFAULT)
+            .putBoolean(KEY_VIRTUAL_BASS, false)
             .putFloat(KEY_VIRTUALIZER, 0f)
             .putInt(KEY_EFFECT_PROFILE, EffectProfile.CUSTOM.ordinal)
             .putInt(KEY_HEADPHONE_TYPE, HeadphoneType.GENERIC.ordinal)
@@ -4,16 +4,26 @@ import android.content.ContentUris
 import android.content.Context
 import android.net.Uri
 import android.provider.MediaStore
+import com.oss.euphoriae.data.local.AnalyzedSong
 import com.oss.euphoriae.data.local.MusicDao
 import com.oss.euphoriae.data.model.CachedLyrics
 import com.oss.euphoriae.data.model.Playlist
 import com.oss.euphoriae.data.model.PlaylistSong
 import com.oss.euphoriae.data.model.Song
+import com.oss.euphoriae.data.model.TrackLoudness
 import com.oss.euphoriae.data.remote.LrclibService
+import com.oss.euphoriae.engine.AudioEngine
 import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.awaitCancellation
+import kotlinx.coroutines.coroutineScope
+import kotlinx.coroutines.ensureActive
 import kotlinx.coroutines.flow.Flow
 import kotlinx.coroutines.flow.map
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.sync.Mutex
+import kotlinx.coroutines.sync.withLock
 import kotlinx.coroutines.withContext
+import kotlin.coroutines.coroutineContext
 
 class MusicRepository(
     private val context: Context,
@@ -22,6 +32,8 @@ class MusicRepository(
     
     private val lrclibService = LrclibService()
     
+    private val loudnessScanMutex = Mutex()
+    
     fun getAllSongs(): Flow<List<Song>> = musicDao.getAllSongs()
     
     fun searchSongs(query: String): Flow<List<Song>> = musicDao.searchSongs(query)
@@ -185,6 +197,54 @@ class MusicRepository(
     
     suspend fun refreshLibrary(): Int = scanAndImportMusic()
     
+    suspend fun getTrackLoudness(songId: Long): TrackLoudness? = musicDao.getTrackLoudness(songId)
+    
+    /**
+     * Analyze loudness of every song not yet in the cache, and of songs whose
+     * file changed since they were analyzed. Runs in batches so results are
+     * saved as they come in and cancelling the coroutine stops the native scan
+     * at the next track.
+     * @return Number of songs analyzed
+     */
+    suspend fun scanLoudness(): Int = loudnessScanMutex.withLock {
+        withContext(Dispatchers.IO) {
+            val engine = AudioEngine.getInstance()
+            val newSongs = musicDao.getSongsWithoutLoudness().map { AnalyzedSong(it.id, it.data, 0L) }
+            val changedSongs = musicDao.getAnalyzedSongs().filter { java.io.File(it.data).lastModified() > it.analyzedAt }
+            val songs = (newSongs + changedSongs).filter { it.data.isNotEmpty() }
+            var analyzed = 0
+            
+            for (batch in songs.chunked(LOUDNESS_SCAN_BATCH_SIZE)) {
+                coroutineContext.ensureActive()
+                val results = coroutineScope {
+                    // The native scan blocks this thread; cancellation has to reach it from another
+                    val scanId = engine.newLoudnessScan()
+                    val watcher = launch {
+                        try {
+                            awaitCancellation()
+                        } finally {
+                            engine.cancelLoudnessScan(scanId)
+                        }
+                    }
+                    engine.scanLoudness(scanId, batch.map { it.data }.toTypedArray()).also { watcher.cancel() }
+                }
+                coroutineContext.ensureActive()
+                
+                // Tracks without a measurable loudness (silent, too short, undecodable)
+                // are cached as NaN too, so they are not decoded again until they change
+                val loudness = batch.mapIndexed { i, song ->
+                    val base = i * AudioEngine.LOUDNESS_RESULT_SIZE
+                    TrackLoudness(song.id, results[base], results[base + 1], results[base + 2])
+                }
+                musicDao.insertTrackLoudness(loudness)
+                analyzed += loudness.count { !it.integratedLufs.isNaN() }
+            }
+            
+            android.util.Log.d("MusicRepository", "Loudness scan: $analyzed of ${songs.size} songs analyzed")
+            analyzed
+        }
+    }
+    
     /**
      * Get lyrics for a song with fallback chain:
      * 1. Local LRC file (same directory as song)
@@ -296,5 +356,9 @@ class MusicRepository(
         }
         emit(lyrics)
     }
+    
+    companion object {
+        private const val LOUDNESS_SCAN_BATCH_SIZE = 256
+    }
 }
 
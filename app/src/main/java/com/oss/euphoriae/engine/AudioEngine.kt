@@ -17,6 +17,8 @@
 package com.oss.euphoriae.engine
 
 import android.util.Log
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
 
 /**
  * AudioEngine - Kotlin wrapper for native DSP audio processor
@@ -29,6 +31,33 @@ class AudioEngine private constructor() {
     companion object {
         private const val TAG = "AudioEngine"
         
+        /** Number of bands returned by [pollSpectrum], lowest frequency first */
+        const val SPECTRUM_BAND_COUNT = 32
+        
+        /** Values per track returned by [analyzeLoudness] and [scanLoudness] */
+        const val LOUDNESS_RESULT_SIZE = 3
+        
+        /** Range of [setBassFrequency], Hz */
+        const val BASS_FREQUENCY_MIN = 40f
+        const val BASS_FREQUENCY_MAX = 200f
+        const val BASS_FREQUENCY_DEFAULT = 80f
+        
+        // Stages [setStageOrder] arranges (native AudioEngine::ChainStage)
+        const val STAGE_TONE_STACK = 0
+        const val STAGE_EQUALIZER = 1
+        const val STAGE_TUBE_WARMTH = 2
+        const val STAGE_COMPRESSOR = 3
+        const val STAGE_LOUDNESS_GAIN = 4
+        const val STAGE_REVERB = 5
+        const val STAGE_CONVOLUTION = 6
+        const val STAGE_SURROUND_3D = 7
+        const val STAGE_STEREO_MATRIX = 8
+        const val STAGE_COUNT = 9
+        
+        // Native AudioEngine::AutomatedParameter
+        private const val AUTOMATE_VOLUME = 0
+        private const val AUTOMATE_FADE = 1
+        
         @Volatile
         private var INSTANCE: AudioEngine? = null
         
@@ -53,12 +82,17 @@ class AudioEngine private constructor() {
 
     private var isCreated = false
 
+    // Stream rate, for converting ramp times to frames
+    @Volatile
+    private var sampleRate = 48000
+
     // ================== Lifecycle ==================
 
     fun create() {
         if (!isCreated) {
             nativeCreate()
             isCreated = true
+            if (spectrumClients > 0) nativeSetSpectrumAnalyzerEnabled(true)
             Log.i(TAG, "Audio engine created")
         }
     }
@@ -71,12 +105,84 @@ class AudioEngine private constructor() {
         }
     }
 
+    /**
+     * Set the stream format. Call from the thread that processes audio,
+     * before the first buffer of a new format.
+     */
+    fun configure(sampleRate: Int, channelCount: Int) {
+        if (sampleRate > 0) this.sampleRate = sampleRate
+        if (isCreated) nativeConfigure(sampleRate, channelCount)
+    }
+
+    /**
+     * Drop reverb tails, delay lines and envelopes after a seek, with a short
+     * fade-in. Call from the thread that processes audio.
+     */
+    fun reset() {
+        if (isCreated) nativeReset()
+    }
+
     fun processAudio(buffer: FloatArray, numFrames: Int, channelCount: Int) {
         if (isCreated) {
             nativeProcessAudio(buffer, numFrames, channelCount)
         }
     }
 
+    /**
+     * Channels [processAudio] with separate buffers produces from a stream with
+     * [inputChannels]: Movie surround upmixes stereo to 5.1, the other surround
+     * modes downmix multichannel to stereo. Query when configuring the stream.
+     */
+    fun getOutputChannelCount(inputChannels: Int): Int =
+        if (isCreated) nativeGetOutputChannelCount(inputChannels) else inputChannels
+
+    /** Upmix or downmix [input] into [output], then apply the effects to [output] */
+    fun processAudio(input: FloatArray, inputChannels: Int, output: FloatArray, outputChannels: Int, numFrames: Int) {
+        if (isCreated) {
+            nativeProcessAudioMixed(input, inputChannels, output, outputChannels, numFrames)
+        }
+    }
+
+    // ================== Automation ==================
+
+    /** Frames processed since the engine was created, the clock ramps are scheduled on */
+    fun getFramePosition(): Long = if (isCreated) nativeGetFramePosition() else 0L
+
+    /**
+     * Ramp the volume to [target] over [durationMs], starting [delayMs] after the
+     * current processing position. The engine moves the gain per sample, so a fade
+     * needs no polling loop; [exponential] ramps fade evenly in dB. Processing runs
+     * ahead of playback by the sink's buffer (NativeRenderersFactory.getBufferedDurationUs),
+     * so a ramp is heard that much later.
+     */
+    fun rampVolume(target: Float, durationMs: Long, delayMs: Long = 0, exponential: Boolean = false): Boolean =
+        scheduleRamp(AUTOMATE_VOLUME, target.coerceIn(0f, 2f), durationMs, delayMs, exponential)
+
+    /**
+     * Ramp the fade gain (0 to 1, applied after the volume) to [target]. Fade-outs
+     * and sleep timers use it so the volume setting survives them.
+     */
+    fun rampFade(target: Float, durationMs: Long, delayMs: Long = 0, exponential: Boolean = false): Boolean =
+        scheduleRamp(AUTOMATE_FADE, target.coerceIn(0f, 1f), durationMs, delayMs, exponential)
+
+    private fun scheduleRamp(parameter: Int, target: Float, durationMs: Long, delayMs: Long, exponential: Boolean): Boolean {
+        if (!isCreated) return false
+        val rate = sampleRate.toLong()
+        val startFrame = nativeGetFramePosition() + delayMs.coerceAtLeast(0) * rate / 1000
+        val durationFrames = durationMs.coerceAtLeast(0) * rate / 1000
+        return nativeScheduleRamp(parameter, target, startFrame, durationFrames, exponential)
+    }
+
+    // ================== Chain Order ==================
+
+    /**
+     * Order of the effect stages, every STAGE_ constant once (reverb ahead of
+     * the compressor, say). Track gain and leveling always come first, limiter
+     * and volume last. The engine swaps the new chain in between two blocks.
+     */
+    fun setStageOrder(order: IntArray): Boolean =
+        isCreated && order.size == STAGE_COUNT && nativeSetStageOrder(order)
+
     // ================== Basic Effects ==================
 
     fun setVolume(volume: Float) {
@@ -91,6 +197,16 @@ class AudioEngine private constructor() {
 
     fun getBassBoost(): Float = if (isCreated) nativeGetBassBoost() else 0f
 
+    /** Bass boost corner frequency, 40 to 200 Hz */
+    fun setBassFrequency(hz: Float) {
+        if (isCreated) nativeSetBassFrequency(hz.coerceIn(BASS_FREQUENCY_MIN, BASS_FREQUENCY_MAX))
+    }
+
+    /** Synthesize harmonics of the sub-bass instead of boosting it (small speakers) */
+    fun setVirtualBass(enabled: Boolean) {
+        if (isCreated) nativeSetBassMode(if (enabled) 1 else 0)
+    }
+
     fun setVirtualizer(strength: Float) {
         if (isCreated) nativeSetVirtualizer(strength.coerceIn(0f, 1f))
     }
@@ -119,6 +235,22 @@ class AudioEngine private constructor() {
         if (isCreated) nativeSetVolumeLeveler(level.coerceIn(0f, 1f))
     }
 
+    /**
+     * Set the loudness the volume leveler steers towards
+     * @param lufs -30 to -8 LUFS (default -16)
+     */
+    fun setVolumeLevelerTarget(lufs: Float) {
+        if (isCreated) nativeSetVolumeLevelerTarget(lufs.coerceIn(-30f, -8f))
+    }
+
+    /**
+     * Set the precomputed gain for the current track (ReplayGain style)
+     * @param gainDb -24 to +24 dB (0 = off)
+     */
+    fun setTrackGain(gainDb: Float) {
+        if (isCreated) nativeSetTrackGain(gainDb.coerceIn(-24f, 24f))
+    }
+
     fun setDynamicRange(range: Float) {
         if (isCreated) nativeSetDynamicRange(range.coerceIn(0f, 1f))
     }
@@ -161,6 +293,17 @@ class AudioEngine private constructor() {
         if (isCreated) nativeSetHeadphoneType(type.coerceIn(0, 4))
     }
 
+    /**
+     * Load an HRIR set (EHIR file) for binaural headphone surround.
+     * Once loaded, headphone surround renders virtual speakers chosen by the headphone type.
+     * The filters are built on the calling thread, so call it off the main thread.
+     * @param path Absolute path to the .ehir file
+     * @return false if the file is missing or malformed
+     */
+    fun loadHrirSet(path: String): Boolean {
+        return isCreated && nativeLoadHrirSet(path)
+    }
+
     // ================== Audio Enhancement ==================
 
     fun setClarity(level: Float) {
@@ -198,11 +341,20 @@ class AudioEngine private constructor() {
     // Core
     private external fun nativeCreate()
     private external fun nativeDestroy()
+    private external fun nativeConfigure(sampleRate: Int, channelCount: Int)
+    private external fun nativeReset()
     private external fun nativeProcessAudio(buffer: FloatArray, numFrames: Int, channelCount: Int)
+    private external fun nativeProcessAudioMixed(input: FloatArray, inputChannels: Int, output: FloatArray, outputChannels: Int, numFrames: Int)
+    private external fun nativeGetOutputChannelCount(inputChannels: Int): Int
+    private external fun nativeScheduleRamp(parameter: Int, target: Float, startFrame: Long, durationFrames: Long, exponential: Boolean): Boolean
+    private external fun nativeGetFramePosition(): Long
+    private external fun nativeSetStageOrder(stageOrder: IntArray): Boolean
 
     // Basic effects
     private external fun nativeSetVolume(volume: Float)
     private external fun nativeSetBassBoost(strength: Float)
+    private external fun nativeSetBassFrequency(hz: Float)
+    private external fun nativeSetBassMode(mode: Int)
     private external fun nativeSetVirtualizer(strength: Float)
     private external fun nativeSetEqualizerBand(band: Int, gain: Float)
     private external fun nativeGetVolume(): Float
@@ -219,6 +371,8 @@ class AudioEngine private constructor() {
     private external fun nativeSetSpectrumExtension(level: Float)
     private external fun nativeSetTrebleBoost(level: Float)
     private external fun nativeSetVolumeLeveler(level: Float)
+    private external fun nativeSetVolumeLevelerTarget(lufs: Float)
+    private external fun nativeSetTrackGain(gainDb: Float)
     private external fun nativeSetStereoBalance(balance: Float)
     private external fun nativeSetChannelSeparation(separation: Float)
     private external fun nativeSetDynamicRange(range: Float)
@@ -230,6 +384,7 @@ class AudioEngine private constructor() {
     private external fun nativeSetSurroundMode(mode: Int)
     private external fun nativeSetHeadphoneSurround(enabled: Boolean)
     private external fun nativeSetHeadphoneType(type: Int)
+    private external fun nativeLoadHrirSet(path: String): Boolean
     private external fun nativeSetReverb(preset: Int, wetMix: Float)
     private external fun nativeGetReverbPreset(): Int
 
@@ -246,6 +401,170 @@ class AudioEngine private constructor() {
 
     fun getReverbPreset(): Int = if (isCreated) nativeGetReverbPreset() else 0
 
+    // ================== Convolution ==================
+
+    /**
+     * Load an impulse response for headphone correction or room simulation.
+     * The IR is transformed on the calling thread, so call it off the main thread.
+     * On 5.1/7.1 streams it applies to the front left/right pair only; the other
+     * channels pass through unconvolved.
+     * @param impulseResponse Interleaved samples at the playback sample rate
+     * @param channelCount 1 (applied to both channels) or 2 (one IR per channel)
+     * @return false if the IR is empty, too long (over 10 s at 48 kHz) or has more than 2 channels
+     */
+    fun loadImpulseResponse(impulseResponse: FloatArray, channelCount: Int): Boolean {
+        if (!isCreated || channelCount !in 1..2) return false
+        val numFrames = impulseResponse.size / channelCount
+        return nativeLoadImpulseResponse(impulseResponse, numFrames, channelCount)
+    }
+
+    fun clearImpulseResponse() {
+        if (isCreated) nativeClearImpulseResponse()
+    }
+
+    /**
+     * Set convolution wet/dry mix
+     * @param wetMix 0.0 (dry) to 1.0 (fully convolved)
+     */
+    fun setConvolutionMix(wetMix: Float) {
+        if (isCreated) nativeSetConvolutionMix(wetMix.coerceIn(0f, 1f))
+    }
+
+    private external fun nativeLoadImpulseResponse(impulseResponse: FloatArray, numFrames: Int, channelCount: Int): Boolean
+    private external fun nativeClearImpulseResponse()
+    private external fun nativeSetConvolutionMix(wetMix: Float)
+
+    // ================== Loudness ==================
+
+    /** Input loudness over the last 400 ms, LUFS (-70 when silent) */
+    fun getMomentaryLoudness(): Float = if (isCreated) nativeGetMomentaryLoudness() else -70f
+
+    /** Input loudness over the last 3 s, LUFS (-70 when silent) */
+    fun getShortTermLoudness(): Float = if (isCreated) nativeGetShortTermLoudness() else -70f
+
+    /** Gated input loudness since the last configure, LUFS (-70 when silent) */
+    fun getIntegratedLoudness(): Float = if (isCreated) nativeGetIntegratedLoudness() else -70f
+
+    private external fun nativeGetMomentaryLoudness(): Float
+    private external fun nativeGetShortTermLoudness(): Float
+    private external fun nativeGetIntegratedLoudness(): Float
+
+    // ================== Diagnostics ==================
+
+    /**
+     * DSP kernel set the native library picked for this CPU: "sse2" or "avx2+fma"
+     * on x86, "neon" on ARM (empty before create). Only the convolver's FIR head
+     * and the convolver's and binaural renderer's spectrum products switch sets;
+     * the FFT and the other effects always run the ABI baseline build.
+     */
+    fun getSimdVariant(): String = if (isCreated) nativeGetSimdVariant() else ""
+
+    private external fun nativeGetSimdVariant(): String
+
+    // ================== Loudness Scanning ==================
+
+    /**
+     * Analyze decoded PCM
+     * @param pcm Interleaved float samples
+     * @return [integrated LUFS, true peak dBTP, loudness range LU], or null if too short or silent
+     */
+    fun analyzeLoudness(pcm: FloatArray, channelCount: Int, sampleRate: Int): FloatArray? {
+        if (channelCount <= 0) return null
+        val result = FloatArray(LOUDNESS_RESULT_SIZE)
+        val valid = nativeAnalyzeLoudness(pcm, pcm.size / channelCount, channelCount, sampleRate, result)
+        return if (valid) result else null
+    }
+
+    /**
+     * Id for one [scanLoudness] call. Take it before handing it to whatever may
+     * cancel the scan: a cancel that arrives before the scan starts still counts.
+     */
+    fun newLoudnessScan(): Long = nativeNewLoudnessScan()
+
+    /**
+     * Decode and analyze audio files on a native thread pool, a few threads at
+     * background priority so playback and the UI keep their cores. Blocks until
+     * done or [cancelLoudnessScan] is called; does not need the engine to be created.
+     * @param scanId from [newLoudnessScan], used once
+     * @return [LOUDNESS_RESULT_SIZE] values per path as in [analyzeLoudness], NaN where analysis failed
+     */
+    fun scanLoudness(scanId: Long, paths: Array<String>): FloatArray {
+        val results = FloatArray(paths.size * LOUDNESS_RESULT_SIZE) { Float.NaN }
+        nativeScanLoudness(scanId, paths, results)
+        return results
+    }
+
+    /** Stop the [scanLoudness] with this id, running or not yet started; tracks not yet analyzed are reported as NaN */
+    fun cancelLoudnessScan(scanId: Long) {
+        nativeCancelLoudnessScan(scanId)
+    }
+
+    private external fun nativeAnalyzeLoudness(pcm: FloatArray, numFrames: Int, channelCount: Int, sampleRate: Int, result: FloatArray): Boolean
+    private external fun nativeNewLoudnessScan(): Long
+    private external fun nativeScanLoudness(scanId: Long, paths: Array<String>, results: FloatArray): Int
+    private external fun nativeCancelLoudnessScan(scanId: Long)
+
+    // ================== Offline Rendering ==================
+
+    /**
+     * Render a whole file through the current effect settings into a 16-bit WAV,
+     * faster than realtime. Blocks until done; call from a background thread.
+     * @return false if the input cannot be decoded, the output cannot be written or [cancelRender] was called
+     */
+    fun renderFile(inputPath: String, outputPath: String): Boolean =
+        isCreated && nativeRenderFile(inputPath, outputPath)
+
+    /** Progress of the running [renderFile], 0.0 to 1.0 */
+    fun getRenderProgress(): Float = nativeGetRenderProgress()
+
+    /** Stop a running [renderFile]; the partial output is deleted */
+    fun cancelRender() {
+        nativeCancelRender()
+    }
+
+    private external fun nativeRenderFile(inputPath: String, outputPath: String): Boolean
+    private external fun nativeGetRenderProgress(): Float
+    private external fun nativeCancelRender()
+
+    // ================== Spectrum Analyzer ==================
+
+    private var spectrumClients = 0
+
+    // Native writes the band levels straight into this buffer
+    private val spectrumBuffer = ByteBuffer.allocateDirect(SPECTRUM_BAND_COUNT * 4).order(ByteOrder.nativeOrder())
+    private val spectrumFloats = spectrumBuffer.asFloatBuffer()
+
+    /**
+     * Start analyzing the processed output. Calls are counted; the analyzer
+     * runs until every caller has called [stopSpectrumAnalyzer].
+     */
+    @Synchronized
+    fun startSpectrumAnalyzer() {
+        if (isCreated && spectrumClients++ == 0) nativeSetSpectrumAnalyzerEnabled(true)
+    }
+
+    @Synchronized
+    fun stopSpectrumAnalyzer() {
+        if (spectrumClients == 0) return
+        if (--spectrumClients == 0 && isCreated) nativeSetSpectrumAnalyzerEnabled(false)
+    }
+
+    /**
+     * Copy the latest band levels into [bands]
+     * @param bands Receives up to [SPECTRUM_BAND_COUNT] levels 0.0 to 1.0
+     * @return false if the analyzer is not running or has no data yet
+     */
+    @Synchronized
+    fun pollSpectrum(bands: FloatArray): Boolean {
+        if (!isCreated || !nativeGetSpectrum(spectrumBuffer)) return false
+        spectrumFloats.rewind()
+        spectrumFloats.get(bands, 0, minOf(bands.size, SPECTRUM_BAND_COUNT))
+        return true
+    }
+
+    private external fun nativeSetSpectrumAnalyzerEnabled(enabled: Boolean)
+    private external fun nativeGetSpectrum(bands: ByteBuffer): Boolean
+
     // ================== Tempo/Pitch ==================
 
     /**
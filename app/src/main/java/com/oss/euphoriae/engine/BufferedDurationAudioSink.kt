@@ -0,0 +1,104 @@
+/*
+ * Copyright 2026 Euphoriae
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.oss.euphoriae.engine
+
+import androidx.annotation.OptIn
+import androidx.media3.common.C
+import androidx.media3.common.Format
+import androidx.media3.common.util.UnstableApi
+import androidx.media3.common.util.Util
+import androidx.media3.exoplayer.audio.AudioSink
+import androidx.media3.exoplayer.audio.ForwardingAudioSink
+import java.nio.ByteBuffer
+
+/**
+ * BufferedDurationAudioSink - Tracks how far the effects run ahead of the listener
+ *
+ * Everything handed to the sink has been through NativeAudioProcessor, so the
+ * gap between the end of the last buffer taken and the played position is
+ * audio the engine has processed but nobody has heard yet. Engine ramps start
+ * at the processing position and are heard that much later.
+ */
+@OptIn(UnstableApi::class)
+class BufferedDurationAudioSink(sink: AudioSink) : ForwardingAudioSink(sink) {
+
+    // Playback thread only
+    private var bytesPerSecond = 0L
+    private var bufferTimeUs = C.TIME_UNSET
+    private var bufferBytes = 0
+
+    // Written on the playback thread, read from any thread
+    @Volatile private var queuedEndUs = C.TIME_UNSET
+    @Volatile private var playedUs = C.TIME_UNSET
+
+    companion object {
+        // Above any AudioTrack buffer ExoPlayer sizes for PCM
+        private const val MAX_BUFFERED_US = 2_000_000L
+    }
+
+    override fun configure(inputFormat: Format, specifiedBufferSize: Int, outputChannels: IntArray?) {
+        super.configure(inputFormat, specifiedBufferSize, outputChannels)
+        bytesPerSecond = if (Util.isEncodingLinearPcm(inputFormat.pcmEncoding)) {
+            Util.getPcmFrameSize(inputFormat.pcmEncoding, inputFormat.channelCount).toLong() * inputFormat.sampleRate
+        } else {
+            0L
+        }
+    }
+
+    override fun handleBuffer(buffer: ByteBuffer, presentationTimeUs: Long, encodedAccessUnitCount: Int): Boolean {
+        // A buffer the sink could not take whole comes back with the same timestamp
+        if (presentationTimeUs != bufferTimeUs) {
+            bufferTimeUs = presentationTimeUs
+            bufferBytes = buffer.remaining()
+        }
+        val handled = super.handleBuffer(buffer, presentationTimeUs, encodedAccessUnitCount)
+        if (handled && bytesPerSecond > 0) {
+            queuedEndUs = presentationTimeUs + bufferBytes * C.MICROS_PER_SECOND / bytesPerSecond
+        }
+        return handled
+    }
+
+    override fun getCurrentPositionUs(sourceEnded: Boolean): Long {
+        val position = super.getCurrentPositionUs(sourceEnded)
+        playedUs = if (position == AudioSink.CURRENT_POSITION_NOT_SET) C.TIME_UNSET else position
+        return position
+    }
+
+    override fun flush() {
+        super.flush()
+        clearPositions()
+    }
+
+    override fun reset() {
+        super.reset()
+        clearPositions()
+    }
+
+    /** Processed audio not yet played, in media time; 0 when unknown */
+    fun getBufferedDurationUs(): Long {
+        val queued = queuedEndUs
+        val played = playedUs
+        if (queued == C.TIME_UNSET || played == C.TIME_UNSET) return 0L
+        return (queued - played).coerceIn(0L, MAX_BUFFERED_US)
+    }
+
+    private fun clearPositions() {
+        bufferTimeUs = C.TIME_UNSET
+        queuedEndUs = C.TIME_UNSET
+        playedUs = C.TIME_UNSET
+    }
+}
@@ -39,6 +39,7 @@ class NativeAudioProcessor(private val audioEngine: AudioEngine) : AudioProcesso
     private var inputEnded = false
     
     private var floatBuffer: FloatArray = FloatArray(0)
+    private var mixBuffer: FloatArray = FloatArray(0)
     private var bufferCounter = 0
 
     companion object {
@@ -67,8 +68,15 @@ class NativeAudioProcessor(private val audioEngine: AudioEngine) : AudioProcesso
         
         this.inputAudioFormat = inputAudioFormat
         
-        // Output same format as input
-        this.outputAudioFormat = inputAudioFormat
+        // Same format as the input, unless the surround mode upmixes or downmixes
+        val outputChannels = audioEngine.getOutputChannelCount(inputAudioFormat.channelCount)
+        this.outputAudioFormat = AudioProcessor.AudioFormat(
+            inputAudioFormat.sampleRate, outputChannels, inputAudioFormat.encoding
+        )
+        
+        // Sample-rate dependent stages (loudness meter, leveler) and the speaker
+        // layout follow the stream the effects run on
+        audioEngine.configure(inputAudioFormat.sampleRate, outputChannels)
         
         Log.i(TAG, "Processor configured successfully, isActive=${isActive()}")
         return outputAudioFormat
@@ -119,24 +127,25 @@ class NativeAudioProcessor(private val audioEngine: AudioEngine) : AudioProcesso
         }
         
         // Process with native engine
-        audioEngine.processAudio(floatBuffer, numFrames, channelCount)
+        val processed = process(numFrames, channelCount)
+        val outputSampleCount = numFrames * outputAudioFormat.channelCount
         
         // Prepare output buffer (allocate fresh when needed)
-        if (outputBuffer === AudioProcessor.EMPTY_BUFFER || outputBuffer.capacity() < sampleCount * 2) {
-            outputBuffer = ByteBuffer.allocateDirect(sampleCount * 2)
+        if (outputBuffer === AudioProcessor.EMPTY_BUFFER || outputBuffer.capacity() < outputSampleCount * 2) {
+            outputBuffer = ByteBuffer.allocateDirect(outputSampleCount * 2)
                 .order(input.order())
         }
         outputBuffer.clear()
         
         // Convert Float back to Int16
         val outShortBuffer = outputBuffer.asShortBuffer()
-        for (i in 0 until sampleCount) {
-            val sample = (floatBuffer[i] * 32767f).toInt().coerceIn(-32768, 32767)
+        for (i in 0 until outputSampleCount) {
+            val sample = (processed[i] * 32767f).toInt().coerceIn(-32768, 32767)
             outShortBuffer.put(i, sample.toShort())
         }
         
         outputBuffer.position(0)
-        outputBuffer.limit(sampleCount * 2)
+        outputBuffer.limit(outputSampleCount * 2)
         
         // Mark input as fully consumed
         input.position(input.limit())
@@ -156,26 +165,45 @@ class NativeAudioProcessor(private val audioEngine: AudioEngine) : AudioProcesso
         floatInput.get(floatBuffer, 0, sampleCount)
         
         // Process with native engine
-        audioEngine.processAudio(floatBuffer, numFrames, channelCount)
+        val processed = process(numFrames, channelCount)
+        val outputSampleCount = numFrames * outputAudioFormat.channelCount
         
         // Prepare output buffer (allocate fresh when needed)
-        if (outputBuffer === AudioProcessor.EMPTY_BUFFER || outputBuffer.capacity() < sampleCount * 4) {
-            outputBuffer = ByteBuffer.allocateDirect(sampleCount * 4)
+        if (outputBuffer === AudioProcessor.EMPTY_BUFFER || outputBuffer.capacity() < outputSampleCount * 4) {
+            outputBuffer = ByteBuffer.allocateDirect(outputSampleCount * 4)
                 .order(input.order())
         }
         outputBuffer.clear()
         
         // Copy back to output
         val floatOutput = outputBuffer.asFloatBuffer()
-        floatOutput.put(floatBuffer, 0, sampleCount)
+        floatOutput.put(processed, 0, outputSampleCount)
         
         outputBuffer.position(0)
-        outputBuffer.limit(sampleCount * 4)
+        outputBuffer.limit(outputSampleCount * 4)
         
         // Mark input as fully consumed
         input.position(input.limit())
     }
 
+    /**
+     * Runs the engine over [floatBuffer] and returns the buffer holding the
+     * result: in place when the channel count is unchanged, otherwise upmixed
+     * or downmixed into [mixBuffer]
+     */
+    private fun process(numFrames: Int, channelCount: Int): FloatArray {
+        val outputChannels = outputAudioFormat.channelCount
+        if (outputChannels == channelCount) {
+            audioEngine.processAudio(floatBuffer, numFrames, channelCount)
+            return floatBuffer
+        }
+        if (mixBuffer.size < numFrames * outputChannels) {
+            mixBuffer = FloatArray(numFrames * outputChannels)
+        }
+        audioEngine.processAudio(floatBuffer, channelCount, mixBuffer, outputChannels, numFrames)
+        return mixBuffer
+    }
+
     override fun queueEndOfStream() {
         inputEnded = true
     }
@@ -193,6 +221,9 @@ class NativeAudioProcessor(private val audioEngine: AudioEngine) : AudioProcesso
     override fun flush() {
         outputBuffer = AudioProcessor.EMPTY_BUFFER
         inputEnded = false
+        
+        // Seeks flush: the old position's tails must not bleed into the new one
+        audioEngine.reset()
     }
 
     override fun reset() {
@@ -200,5 +231,6 @@ class NativeAudioProcessor(private val audioEngine: AudioEngine) : AudioProcesso
         inputAudioFormat = AudioProcessor.AudioFormat.NOT_SET
         outputAudioFormat = AudioProcessor.AudioFormat.NOT_SET
         floatBuffer = FloatArray(0)
+        mixBuffer = FloatArray(0)
     }
 }
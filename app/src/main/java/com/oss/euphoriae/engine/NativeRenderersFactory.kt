@@ -36,6 +36,7 @@ class NativeRenderersFactory(
 ) : DefaultRenderersFactory(context) {
 
     private var nativeAudioProcessor: NativeAudioProcessor? = null
+    private var audioSink: BufferedDurationAudioSink? = null
 
     companion object {
         private const val TAG = "NativeRenderersFactory"
@@ -59,16 +60,21 @@ class NativeRenderersFactory(
         // Create our native audio processor
         nativeAudioProcessor = NativeAudioProcessor(audioEngine)
         
-        val audioSink = DefaultAudioSink.Builder(context)
+        val defaultSink = DefaultAudioSink.Builder(context)
             .setEnableFloatOutput(enableFloatOutput) // Revert forced Float to prevent crash with Sonic/TimeStretch
             .setEnableAudioTrackPlaybackParams(enableAudioTrackPlaybackParams)
             .setAudioProcessors(arrayOf(nativeAudioProcessor!!))
             .build()
+        val sink = BufferedDurationAudioSink(defaultSink)
+        audioSink = sink
         
         Log.i(TAG, "AudioSink created with NativeAudioProcessor")
-        return audioSink
+        return sink
     }
 
     fun getNativeAudioProcessor(): NativeAudioProcessor? = nativeAudioProcessor
+
+    /** Audio the engine has processed that the sink has not played yet, in media time */
+    fun getBufferedDurationUs(): Long = audioSink?.getBufferedDurationUs() ?: 0L
 }
 
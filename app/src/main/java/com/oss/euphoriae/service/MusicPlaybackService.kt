@@ -3,6 +3,7 @@ package com.oss.euphoriae.service
 import android.app.NotificationChannel
 import android.app.NotificationManager
 import android.app.PendingIntent
+import android.content.ContentUris
 import android.content.Intent
 import android.os.Build
 import android.util.Log
@@ -16,6 +17,7 @@ import androidx.media3.common.util.UnstableApi
 import androidx.media3.exoplayer.ExoPlayer
 import androidx.media3.session.MediaSession
 import androidx.media3.session.MediaSessionService
+import com.oss.euphoriae.EuphoriaeApp
 import com.oss.euphoriae.MainActivity
 import com.oss.euphoriae.engine.AudioEngine
 import com.oss.euphoriae.engine.NativeAudioProcessor
@@ -24,8 +26,11 @@ import com.oss.euphoriae.widget.WidgetQueueManager
 import com.oss.euphoriae.widget.WidgetUpdater
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.Job
 import kotlinx.coroutines.SupervisorJob
 import kotlinx.coroutines.cancel
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.isActive
 import kotlinx.coroutines.launch
 
 @OptIn(UnstableApi::class)
@@ -41,17 +46,47 @@ class MusicPlaybackService : MediaSessionService() {
     private val widgetPlayerListener = object : Player.Listener {
         override fun onIsPlayingChanged(isPlaying: Boolean) {
             updateWidget()
+            if (isPlaying) {
+                // Whatever resumed playback, undo a pause fade-out
+                pauseFader.onPlaybackStarted()
+                watchTrackEnd()
+            } else {
+                trackEndJob?.cancel()
+            }
         }
         
         override fun onMediaItemTransition(mediaItem: MediaItem?, reason: Int) {
             updateWidget()
+            applyTrackGain(mediaItem)
         }
     }
     
+    private var trackGainJob: Job? = null
+    private var trackEndJob: Job? = null
+    
+    private val pauseFader = PauseFader(
+        fadeMs = PAUSE_FADE_MS,
+        fade = { target, durationMs -> audioEngine?.rampFade(target, durationMs, exponential = true) ?: false },
+        heardAfterMs = { mediaMs ->
+            val speed = player?.playbackParameters?.speed ?: 1f
+            ((mediaMs + sinkLatencyMs()) / speed).toLong()
+        },
+        schedule = { delayMs, action ->
+            val job = serviceScope.launch {
+                delay(delayMs)
+                action()
+            }
+            val cancel: () -> Unit = { job.cancel() }
+            cancel
+        }
+    )
+    
     companion object {
         private const val NOTIFICATION_CHANNEL_ID = "euphoriae_playback_channel"
         private const val TAG = "MusicPlaybackService"
         var crossfadeDurationMs: Long = 0  // 0 = disabled, up to 12000ms
+        private const val PAUSE_FADE_MS = 250L
+        private const val TRACK_END_POLL_MS = 200L
         
         // Widget action constants
         const val ACTION_PLAY_PAUSE = "com.oss.euphoriae.action.PLAY_PAUSE"
@@ -146,6 +181,25 @@ class MusicPlaybackService : MediaSessionService() {
             
             override fun hasNextMediaItem(): Boolean = true
             override fun hasPreviousMediaItem(): Boolean = true
+            
+            override fun play() {
+                // Inside the pause fade the player is still playing: fade back in
+                pauseFader.resume()
+                super.play()
+            }
+            
+            override fun pause() {
+                pauseFader.fadeOutThen {
+                    super.pause()
+                    // Drop the faded audio still queued in the sink, which would
+                    // otherwise play as a gap on resume
+                    super.seekTo(super.getCurrentPosition())
+                }
+            }
+            
+            override fun stop() {
+                pauseFader.fadeOutThen { super.stop() }
+            }
         }
     }
     
@@ -154,7 +208,7 @@ class MusicPlaybackService : MediaSessionService() {
         
         when (intent?.action) {
             ACTION_PLAY_PAUSE -> {
-                player?.let {
+                mediaSession?.player?.let {
                     if (it.isPlaying) it.pause() else it.play()
                 }
             }
@@ -248,6 +302,8 @@ class MusicPlaybackService : MediaSessionService() {
         
         // Apply basic effects
         engine.setBassBoost(prefs.getBassBoost())
+        engine.setBassFrequency(prefs.getBassFrequency())
+        engine.setVirtualBass(prefs.getVirtualBass())
         engine.setVirtualizer(prefs.getVirtualizer())
         
         // Apply surround settings
@@ -344,6 +400,17 @@ class MusicPlaybackService : MediaSessionService() {
         audioEngine?.setVolume(volume)
     }
     
+    // Sample-accurate fades on top of the volume (pause, stop, track ends), run by the engine
+    fun fadeNativeOut(durationMs: Long): Boolean =
+        audioEngine?.rampFade(0f, durationMs, exponential = true) ?: false
+    
+    fun fadeNativeIn(durationMs: Long): Boolean =
+        audioEngine?.rampFade(1f, durationMs, exponential = true) ?: false
+    
+    // Engine ramps start at the processing position, this much (media time)
+    // before the listener hears it
+    private fun sinkLatencyMs(): Long = (renderersFactory?.getBufferedDurationUs() ?: 0L) / 1000
+    
     fun setNativeBassBoost(strength: Float) {
         audioEngine?.setBassBoost(strength)
     }
@@ -356,6 +423,62 @@ class MusicPlaybackService : MediaSessionService() {
         audioEngine?.setEqualizerBand(band, gain)
     }
     
+    /**
+     * While playing, fade the last [crossfadeDurationMs] of each track out and
+     * the next one in. The engine runs the ramps; this only decides when
+     */
+    private fun watchTrackEnd() {
+        trackEndJob?.cancel()
+        trackEndJob = serviceScope.launch {
+            var fadingOut = false
+            while (isActive) {
+                val currentPlayer = player ?: break
+                val fadeMs = crossfadeDurationMs
+                val duration = currentPlayer.duration
+                // Of the track still to be processed: the player reports what has been heard
+                val remaining = duration - currentPlayer.currentPosition - sinkLatencyMs()
+                val ending = fadeMs > 0 && duration != C.TIME_UNSET && remaining <= fadeMs
+                if (ending != fadingOut) {
+                    if (ending) fadeNativeOut(remaining.coerceAtLeast(0)) else fadeNativeIn(maxOf(fadeMs, PAUSE_FADE_MS))
+                    fadingOut = ending
+                }
+                delay(TRACK_END_POLL_MS)
+            }
+        }
+    }
+    
+    /**
+     * Apply the cached loudness gain of the new track when track gain is on;
+     * tracks that have not been analyzed yet play at unity gain
+     */
+    private fun applyTrackGain(mediaItem: MediaItem?) {
+        trackGainJob?.cancel()
+        if (!com.oss.euphoriae.data.preferences.AudioPreferences(this).isTrackGainEnabled()) {
+            audioEngine?.setTrackGain(0f)
+            return
+        }
+        val uri = mediaItem?.localConfiguration?.uri
+        val songId = try {
+            uri?.let { ContentUris.parseId(it) } ?: -1L
+        } catch (e: Exception) {
+            -1L
+        }
+        if (songId < 0) {
+            audioEngine?.setTrackGain(0f)
+            return
+        }
+        
+        trackGainJob = serviceScope.launch {
+            val loudness = try {
+                (application as EuphoriaeApp).musicRepository.getTrackLoudness(songId)
+            } catch (e: Exception) {
+                Log.e(TAG, "Failed to load track loudness", e)
+                null
+            }
+            audioEngine?.setTrackGain(loudness?.gainDb() ?: 0f)
+        }
+    }
+    
     private fun updateWidget() {
         serviceScope.launch {
             val currentPlayer = player ?: return@launch
@@ -0,0 +1,51 @@
+package com.oss.euphoriae.service
+
+/**
+ * PauseFader - Fades playback out before a pause or stop takes effect
+ *
+ * The action runs once the fade-out has been heard. A resume that arrives
+ * first cancels it and fades back in: the player never paused, so nothing
+ * else would undo the fade.
+ *
+ * @param fade ramps the engine's fade gain to a target over a duration; false without an engine
+ * @param heardAfterMs wall-clock time until the next given milliseconds of processed audio have been heard
+ * @param schedule runs an action after a delay and returns a function that cancels it
+ */
+class PauseFader(
+    private val fadeMs: Long,
+    private val fade: (target: Float, durationMs: Long) -> Boolean,
+    private val heardAfterMs: (mediaMs: Long) -> Long,
+    private val schedule: (delayMs: Long, action: () -> Unit) -> () -> Unit
+) {
+    private var cancelPending: (() -> Unit)? = null
+
+    /** True between a fade-out and the action it leads to */
+    val isFadingOut: Boolean get() = cancelPending != null
+
+    /** Fade out, then run [action]; without the engine it runs right away */
+    fun fadeOutThen(action: () -> Unit) {
+        cancelPending?.invoke()
+        cancelPending = null
+        if (!fade(0f, fadeMs)) {
+            action()
+            return
+        }
+        cancelPending = schedule(heardAfterMs(fadeMs)) {
+            cancelPending = null
+            action()
+        }
+    }
+
+    /** Before play(): a fade-out whose action has not run yet is undone */
+    fun resume() {
+        val cancel = cancelPending ?: return
+        cancelPending = null
+        cancel()
+        fade(1f, fadeMs)
+    }
+
+    /** Playback started or resumed after a real pause */
+    fun onPlaybackStarted() {
+        if (!isFadingOut) fade(1f, fadeMs)
+    }
+}
@@ -12,6 +12,8 @@ import androidx.compose.ui.Modifier
 import androidx.compose.ui.draw.clip
 import androidx.compose.ui.graphics.Color
 import androidx.compose.ui.unit.dp
+import com.oss.euphoriae.engine.AudioEngine
+import kotlinx.coroutines.isActive
 
 @Composable
 fun MusicVisualizer(
@@ -21,9 +23,38 @@ fun MusicVisualizer(
     barColor: Color = MaterialTheme.colorScheme.primary,
     containerColor: Color = MaterialTheme.colorScheme.primaryContainer
 ) {
+    val audioEngine = remember { AudioEngine.getInstance() }
+    val spectrumLevels = remember(barCount) { mutableStateListOf<Float>().apply { repeat(barCount) { add(0f) } } }
+    var hasSpectrum by remember { mutableStateOf(false) }
+
+    // Poll the engine's analyzer once per frame while playing
+    LaunchedEffect(isPlaying, barCount) {
+        hasSpectrum = false
+        if (!isPlaying) return@LaunchedEffect
+        audioEngine.startSpectrumAnalyzer()
+        try {
+            val bands = FloatArray(AudioEngine.SPECTRUM_BAND_COUNT)
+            while (isActive) {
+                withFrameNanos { }
+                if (!audioEngine.pollSpectrum(bands)) continue
+                // Each bar shows the loudest of its share of bands
+                for (bar in 0 until barCount) {
+                    val start = bar * bands.size / barCount
+                    val end = maxOf(start + 1, (bar + 1) * bands.size / barCount)
+                    var level = 0f
+                    for (band in start until end) level = maxOf(level, bands[band])
+                    spectrumLevels[bar] = level
+                }
+                hasSpectrum = true
+            }
+        } finally {
+            audioEngine.stopSpectrumAnalyzer()
+        }
+    }
+
     val infiniteTransition = rememberInfiniteTransition(label = "visualizer")
     
-    // Different animation specs for each bar to create organic movement
+    // Different animation specs for each bar to create organic movement (fallback without analyzer data)
     val barAnimations = List(barCount) { index ->
         infiniteTransition.animateFloat(
             initialValue = if (isPlaying) 0.25f else 0.15f,
@@ -55,7 +86,11 @@ fun MusicVisualizer(
                 modifier = Modifier.padding(24.dp)
             ) {
                 barAnimations.forEachIndexed { index, animatedValue ->
-                    val height = animatedValue.value
+                    val height = if (hasSpectrum) {
+                        0.15f + spectrumLevels[index] * 0.85f
+                    } else {
+                        animatedValue.value
+                    }
                     
                     Box(
                         modifier = Modifier
@@ -94,6 +94,10 @@ fun EqualizerScreen(
     
     // Basic Effects - load from preferences
     var bassBoost by remember { mutableFloatStateOf(audioPreferences?.getBassBoost() ?: 0f) }
+    var bassFrequency by remember {
+        mutableFloatStateOf(audioPreferences?.getBassFrequency() ?: AudioEngine.BASS_FREQUENCY_DEFAULT)
+    }
+    var virtualBass by remember { mutableStateOf(audioPreferences?.getVirtualBass() ?: false) }
     var virtualizer by remember { mutableFloatStateOf(audioPreferences?.getVirtualizer() ?: 0f) }
     
     // DSP Settings - load from preferences
@@ -117,6 +121,7 @@ fun EqualizerScreen(
     var volumeLeveler by remember { mutableFloatStateOf(audioPreferences?.getVolumeLeveler() ?: 0f) }
     var limiter by remember { mutableFloatStateOf(audioPreferences?.getLimiter() ?: 0f) }
     var dynamicRange by remember { mutableFloatStateOf(audioPreferences?.getDynamicRange() ?: 1f) }
+    var trackGain by remember { mutableStateOf(audioPreferences?.isTrackGainEnabled() ?: false) }
     
     // Tempo/Pitch Control
     var tempo by remember { mutableFloatStateOf(1f) }  // 0.5 to 2.0
@@ -142,6 +147,8 @@ fun EqualizerScreen(
         }
         // Apply other effects
         audioEngine?.setBassBoost(bassBoost)
+        audioEngine?.setBassFrequency(bassFrequency)
+        audioEngine?.setVirtualBass(virtualBass)
         audioEngine?.setVirtualizer(virtualizer)
         audioEngine?.setStereoBalance(stereoBalance)
         audioEngine?.setChannelSeparation(channelSeparation)
@@ -223,6 +230,8 @@ fun EqualizerScreen(
     fun resetAll() {
         applyPreset("Flat")
         bassBoost = 0f; audioPreferences?.setBassBoost(0f); audioEngine?.setBassBoost(0f)
+        bassFrequency = AudioEngine.BASS_FREQUENCY_DEFAULT; audioPreferences?.setBassFrequency(bassFrequency); audioEngine?.setBassFrequency(bassFrequency)
+        virtualBass = false; audioPreferences?.setVirtualBass(false); audioEngine?.setVirtualBass(false)
         virtualizer = 0f; audioPreferences?.setVirtualizer(0f); audioEngine?.setVirtualizer(0f)
         reverbPreset = ReverbPreset.NONE; audioPreferences?.setReverbPreset(ReverbPreset.NONE)
         loudnessGain = 0f; audioPreferences?.setLoudnessGain(0f)
@@ -238,6 +247,7 @@ fun EqualizerScreen(
         volumeLeveler = 0f; audioPreferences?.setVolumeLeveler(0f); audioEngine?.setVolumeLeveler(0f)
         limiter = 0f; audioPreferences?.setLimiter(0f); audioEngine?.setLimiter(0.99f)
         dynamicRange = 1f; audioPreferences?.setDynamicRange(1f); audioEngine?.setDynamicRange(1f)
+        trackGain = false; audioPreferences?.setTrackGainEnabled(false); audioEngine?.setTrackGain(0f)
         loudnessGain = 0f; audioPreferences?.setLoudnessGain(0f); audioEngine?.setLoudnessGain(0f)
         clarity = 0f; audioPreferences?.setClarity(0f); audioEngine?.setClarity(0f)
         spectrumExtension = 0f; audioPreferences?.setSpectrumExtension(0f); audioEngine?.setSpectrumExtension(0f)
@@ -506,6 +516,67 @@ fun EqualizerScreen(
                     icon = Icons.Default.Speaker
                 )
                 
+                val bassRange = AudioEngine.BASS_FREQUENCY_MAX - AudioEngine.BASS_FREQUENCY_MIN
+                EffectSlider(
+                    label = "Bass Frequency",
+                    value = (bassFrequency - AudioEngine.BASS_FREQUENCY_MIN) / bassRange,
+                    onValueChange = { 
+                        bassFrequency = AudioEngine.BASS_FREQUENCY_MIN + it * bassRange
+                        audioPreferences?.setBassFrequency(bassFrequency)
+                        audioEngine?.setBassFrequency(bassFrequency)
+                    },
+                    enabled = isEnabled,
+                    icon = Icons.Default.GraphicEq,
+                    valueLabel = "${bassFrequency.toInt()} Hz"
+                )
+                
+                Row(
+                    modifier = Modifier.fillMaxWidth().padding(vertical = 4.dp),
+                    horizontalArrangement = Arrangement.SpaceBetween,
+                    verticalAlignment = Alignment.CenterVertically
+                ) {
+                    Row(verticalAlignment = Alignment.CenterVertically) {
+                        Icon(
+                            Icons.Default.Speaker,
+                            contentDescription = null,
+                            modifier = Modifier.size(18.dp),
+                            tint = MaterialTheme.colorScheme.onSurfaceVariant
+                        )
+                        Spacer(modifier = Modifier.width(10.dp))
+                        Column {
+                            Text("Virtual Bass", style = MaterialTheme.typography.bodyMedium, fontWeight = FontWeight.Medium)
+                            Text(
+                                text = "Bass harmonics for small speakers",
+                                style = MaterialTheme.typography.labelSmall,
+                                color = MaterialTheme.colorScheme.onSurfaceVariant.copy(alpha = 0.7f)
+                            )
+                        }
+                    }
+                    Switch(
+                        checked = virtualBass,
+                        onCheckedChange = { 
+                            virtualBass = it
+                            audioPreferences?.setVirtualBass(it)
+                            audioEngine?.setVirtualBass(it)
+                        },
+                        enabled = isEnabled,
+                        thumbContent = {
+                            Crossfade(
+                                targetState = virtualBass,
+                                animationSpec = tween(durationMillis = 500),
+                            ) { isChecked ->
+                                if (isChecked) {
+                                    Icon(
+                                        imageVector = Icons.Rounded.Check,
+                                        contentDescription = null,
+                                        modifier = Modifier.size(SwitchDefaults.IconSize),
+                                    )
+                                }
+                            }
+                        },
+                    )
+                }
+                
                 EffectSlider(
                     label = "Virtualizer",
                     value = virtualizer,
@@ -799,6 +870,49 @@ fun EqualizerScreen(
                     icon = Icons.Default.SwapVert,
                     valueLabel = "${(dynamicRange * 100).toInt()}%"
                 )
+                
+                Spacer(modifier = Modifier.height(8.dp))
+                
+                // Track gain needs a loudness scan of the library, which starts when it is turned on
+                Row(
+                    modifier = Modifier.fillMaxWidth(),
+                    horizontalArrangement = Arrangement.SpaceBetween,
+                    verticalAlignment = Alignment.CenterVertically
+                ) {
+                    Row(verticalAlignment = Alignment.CenterVertically) {
+                        Icon(
+                            Icons.Default.Tune,
+                            contentDescription = null,
+                            modifier = Modifier.size(20.dp),
+                            tint = MaterialTheme.colorScheme.onSurfaceVariant
+                        )
+                        Spacer(modifier = Modifier.width(12.dp))
+                        Text("Track Gain", style = MaterialTheme.typography.bodyMedium)
+                    }
+                    Switch(
+                        checked = trackGain,
+                        onCheckedChange = { 
+                            trackGain = it
+                            audioPreferences?.setTrackGainEnabled(it)
+                            if (!it) audioEngine?.setTrackGain(0f)
+                        },
+                        enabled = isEnabled,
+                        thumbContent = {
+                            Crossfade(
+                                targetState = trackGain,
+                                animationSpec = tween(durationMillis = 500),
+                            ) { isChecked ->
+                                if (isChecked) {
+                                    Icon(
+                                        imageVector = Icons.Rounded.Check,
+                                        contentDescription = null,
+                                        modifier = Modifier.size(SwitchDefaults.IconSize),
+                                    )
+                                }
+                            }
+                        },
+                    )
+                }
             }
             
             Spacer(modifier = Modifier.height(12.dp))
@@ -23,11 +23,14 @@ import com.oss.euphoriae.data.`class`.AudioEffectsManager
 import com.oss.euphoriae.data.model.Lyrics
 import com.oss.euphoriae.data.model.Playlist
 import com.oss.euphoriae.data.model.Song
+import com.oss.euphoriae.data.preferences.AudioPreferences
 import com.oss.euphoriae.engine.AudioEngine
 import com.oss.euphoriae.service.MusicPlaybackService
 import com.oss.euphoriae.widget.QueueSongInfo
 import com.oss.euphoriae.widget.WidgetQueueManager
 import kotlinx.coroutines.Job
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.cancelChildren
 import kotlinx.coroutines.delay
 import kotlinx.coroutines.flow.*
 import kotlinx.coroutines.isActive
@@ -61,6 +64,10 @@ data class MusicUiState(
 class MusicViewModel(application: Application) : AndroidViewModel(application) {
     
     private val repository = (application as EuphoriaeApp).musicRepository
+    private val audioPreferences = AudioPreferences(application)
+    
+    // Parent of the library loudness scans, so turning track gain off stops them
+    private val loudnessScans = SupervisorJob(viewModelScope.coroutineContext[Job])
     
     val audioEffectsManager = AudioEffectsManager()
     private var audioEffectsInitialized = false
@@ -123,6 +130,18 @@ class MusicViewModel(application: Application) : AndroidViewModel(application) {
         loadAlbums()
         connectToService()
         observeCurrentSong()
+        observeTrackGain()
+    }
+    
+    // The library loudness scan only serves track gain: run it while that is on
+    private fun observeTrackGain() {
+        viewModelScope.launch {
+            audioPreferences.trackGainEnabledFlow
+                .distinctUntilChanged()
+                .collect { enabled ->
+                    if (enabled) scanLoudness() else loudnessScans.cancelChildren()
+                }
+        }
     }
     
     private fun observeCurrentSong() {
@@ -279,6 +298,7 @@ class MusicViewModel(application: Application) : AndroidViewModel(application) {
                         error = if (count == 0) "No music found on device" else null
                     )
                 }
+                scanLoudness()
             } catch (e: Exception) {
                 _uiState.update { 
                     it.copy(
@@ -301,6 +321,7 @@ class MusicViewModel(application: Application) : AndroidViewModel(application) {
                         error = if (count == 0) "No music found on device" else null
                     )
                 }
+                scanLoudness()
             } catch (e: Exception) {
                 _uiState.update { 
                     it.copy(
@@ -312,6 +333,20 @@ class MusicViewModel(application: Application) : AndroidViewModel(application) {
         }
     }
     
+    // Analyze new and changed songs in the background for track gain
+    private fun scanLoudness() {
+        if (!audioPreferences.isTrackGainEnabled()) return
+        viewModelScope.launch(loudnessScans) {
+            try {
+                repository.scanLoudness()
+            } catch (e: kotlinx.coroutines.CancellationException) {
+                throw e
+            } catch (e: Exception) {
+                android.util.Log.e("MusicViewModel", "Loudness scan failed", e)
+            }
+        }
+    }
+    
     fun searchSongs(query: String) {
         _searchQuery.value = query
         _uiState.update { it.copy(searchQuery = query) }
@@ -0,0 +1,88 @@
+package com.oss.euphoriae.service
+
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertTrue
+import org.junit.Test
+
+class PauseFaderTest {
+    private val fades = mutableListOf<Pair<Float, Long>>()
+    private val scheduled = mutableListOf<Pair<Long, () -> Unit>>()
+    private var cancelled = 0
+    private var actions = 0
+    private var hasEngine = true
+
+    private val fader = PauseFader(
+        fadeMs = 250,
+        fade = { target, durationMs -> if (hasEngine) fades.add(target to durationMs); hasEngine },
+        heardAfterMs = { mediaMs -> mediaMs + 400 },
+        schedule = { delayMs, action ->
+            scheduled.add(delayMs to action)
+            val cancel: () -> Unit = { cancelled++ }
+            cancel
+        }
+    )
+
+    @Test
+    fun pause_runsAfterTheFadeHasBeenHeard() {
+        fader.fadeOutThen { actions++ }
+        assertEquals(listOf(0f to 250L), fades)
+        assertEquals(650L, scheduled.single().first)
+        assertEquals(0, actions)
+
+        scheduled.single().second()
+        assertEquals(1, actions)
+        assertFalse(fader.isFadingOut)
+    }
+
+    @Test
+    fun playWithinFadeWindow_cancelsThePauseAndFadesBackIn() {
+        fader.fadeOutThen { actions++ }
+        assertTrue(fader.isFadingOut)
+
+        fader.resume()
+        assertEquals(1, cancelled)
+        assertEquals(0, actions)
+        assertEquals(listOf(0f to 250L, 1f to 250L), fades)
+        assertFalse(fader.isFadingOut)
+    }
+
+    @Test
+    fun playAfterThePause_leavesTheFadeInToPlaybackStart() {
+        fader.fadeOutThen { actions++ }
+        scheduled.single().second()
+
+        fader.resume()
+        assertEquals(0, cancelled)
+        assertEquals(listOf(0f to 250L), fades)
+
+        fader.onPlaybackStarted()
+        assertEquals(listOf(0f to 250L, 1f to 250L), fades)
+    }
+
+    @Test
+    fun playbackStartDuringFadeOut_doesNotFadeIn() {
+        fader.fadeOutThen { actions++ }
+        fader.onPlaybackStarted()
+        assertEquals(listOf(0f to 250L), fades)
+    }
+
+    @Test
+    fun secondPause_replacesThePendingOne() {
+        fader.fadeOutThen { actions++ }
+        fader.fadeOutThen { actions += 10 }
+        assertEquals(1, cancelled)
+
+        scheduled.last().second()
+        assertEquals(10, actions)
+    }
+
+    @Test
+    fun withoutEngine_actionRunsRightAway() {
+        hasEngine = false
+        fader.fadeOutThen { actions++ }
+        assertEquals(1, actions)
+        assertTrue(scheduled.isEmpty())
+        assertFalse(fader.isFadingOut)
+    }
+}